@@ -60,10 +60,8 @@ namespace {
 
 	Histories histories;
 
-	using MsgsData = QHash<MsgId, HistoryItem*>;
-	MsgsData msgsData;
-	using ChannelMsgsData = QMap<ChannelId, MsgsData>;
-	ChannelMsgsData channelMsgsData;
+	// All the messages in one table, so lookup is a single hash probe.
+	std::unordered_map<FullMsgId, not_null<HistoryItem*>> msgsData;
 
 	using RandomData = QMap<uint64, FullMsgId>;
 	RandomData randomData;
@@ -89,6 +87,34 @@ namespace {
 
 	int32 serviceImageCacheSize = 0;
 
+	void SetReaderShrinkBox(QImageReader &reader, QSize shrinkBox) {
+		auto size = reader.size();
+#ifndef OS_MAC_OLD
+		const auto rotated = (reader.transformation()
+			& QImageIOHandler::TransformationRotate90);
+		if (rotated) {
+			size.transpose();
+		}
+#endif // OS_MAC_OLD
+		if (size.width() <= shrinkBox.width()
+			&& size.height() <= shrinkBox.height()) {
+			return;
+		}
+		auto scaled = size.scaled(shrinkBox, Qt::KeepAspectRatio);
+		if (scaled.isEmpty()) {
+			return;
+		}
+#ifndef OS_MAC_OLD
+		if (rotated) {
+			scaled.transpose();
+		}
+#endif // OS_MAC_OLD
+
+		// JPEG decoder skips the details we don't need with a scaled DCT,
+		// other formats are scaled by the reader after decoding.
+		reader.setScaledSize(scaled);
+	}
+
 } // namespace
 
 namespace App {
@@ -1012,35 +1038,24 @@ namespace App {
 		}
 	}
 
-	inline MsgsData *fetchMsgsData(ChannelId channelId, bool insert = true) {
-		if (channelId == NoChannel) return &msgsData;
-		ChannelMsgsData::iterator i = channelMsgsData.find(channelId);
-		if (i == channelMsgsData.cend()) {
-			if (insert) {
-				i = channelMsgsData.insert(channelId, MsgsData());
-			} else {
-				return 0;
-			}
-		}
-		return &(*i);
-	}
-
 	void feedWereDeleted(
 			ChannelId channelId,
 			const QVector<MTPint> &msgsIds) {
-		const auto data = fetchMsgsData(channelId, false);
-		if (!data) return;
-
 		const auto affectedHistory = (channelId != NoChannel)
-			? App::history(peerFromChannel(channelId)).get()
+			? App::historyLoaded(peerFromChannel(channelId))
 			: nullptr;
+		if (channelId != NoChannel && !affectedHistory) {
+			// No messages of this channel could be loaded.
+			return;
+		}
 
 		auto historiesToCheck = base::flat_set<not_null<History*>>();
 		for (const auto msgId : msgsIds) {
-			auto j = data->constFind(msgId.v);
-			if (j != data->cend()) {
-				const auto history = (*j)->history();
-				(*j)->destroy();
+			const auto j = msgsData.find(FullMsgId(channelId, msgId.v));
+			if (j != msgsData.end()) {
+				const auto item = j->second;
+				const auto history = item->history();
+				item->destroy();
 				if (!history->lastMessageKnown()) {
 					historiesToCheck.emplace(history);
 				}
@@ -1191,37 +1206,23 @@ namespace App {
 	HistoryItem *histItemById(ChannelId channelId, MsgId itemId) {
 		if (!itemId) return nullptr;
 
-		auto data = fetchMsgsData(channelId, false);
-		if (!data) return nullptr;
-
-		auto i = data->constFind(itemId);
-		if (i != data->cend()) {
-			return i.value();
-		}
-		return nullptr;
+		const auto i = msgsData.find(FullMsgId(channelId, itemId));
+		return (i != msgsData.end()) ? i->second.get() : nullptr;
 	}
 
 	void historyRegItem(not_null<HistoryItem*> item) {
-		const auto data = fetchMsgsData(item->channelId());
-		const auto i = data->constFind(item->id);
-		if (i == data->cend()) {
-			data->insert(item->id, item);
-		} else if (i.value() != item) {
+		const auto [i, ok] = msgsData.emplace(item->fullId(), item);
+		if (!ok && i->second != item) {
 			LOG(("App Error: trying to historyRegItem() an already registered item"));
-			i.value()->destroy();
-			data->insert(item->id, item);
+			i->second->destroy();
+			msgsData.insert_or_assign(item->fullId(), item);
 		}
 	}
 
 	void historyUnregItem(not_null<HistoryItem*> item) {
-		const auto data = fetchMsgsData(item->channelId(), false);
-		if (!data) return;
-
-		const auto i = data->find(item->id);
-		if (i != data->cend()) {
-			if (i.value() == item) {
-				data->erase(i);
-			}
+		const auto i = msgsData.find(item->fullId());
+		if (i != msgsData.end() && i->second == item) {
+			msgsData.erase(i);
 		}
 		const auto j = ::dependentItems.find(item);
 		if (j != ::dependentItems.cend()) {
@@ -1251,14 +1252,8 @@ namespace App {
 	void historyClearMsgs() {
 		::dependentItems.clear();
 		const auto oldData = base::take(msgsData);
-		const auto oldChannelData = base::take(channelMsgsData);
-		for (const auto item : oldData) {
-			delete item;
-		}
-		for (const auto &data : oldChannelData) {
-			for (const auto item : data) {
-				delete item;
-			}
+		for (const auto &[fullId, item] : oldData) {
+			delete item.get();
 		}
 		for (const auto data : base::take(::locationsData)) {
 			delete data;
@@ -1591,7 +1586,7 @@ namespace App {
 		App::quit();
 	}
 
-	QImage readImage(QByteArray data, QByteArray *format, bool opaque, bool *animated) {
+	QImage readImage(QByteArray data, QByteArray *format, bool opaque, bool *animated, const QSize &shrinkBox) {
         QByteArray tmpFormat;
 		QImage result;
 		QBuffer buffer(&data);
@@ -1603,6 +1598,9 @@ namespace App {
 #ifndef OS_MAC_OLD
 			reader.setAutoTransform(true);
 #endif // OS_MAC_OLD
+			if (!shrinkBox.isEmpty()) {
+				SetReaderShrinkBox(reader, shrinkBox);
+			}
 			if (animated) *animated = reader.supportsAnimation() && reader.imageCount() > 1;
 			QByteArray fmt = reader.format();
 			if (!fmt.isEmpty()) *format = fmt;
@@ -0,0 +1,136 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include "base/tests_benchmark.h"
+#include <unordered_map>
+#include <random>
+
+using ChannelId = qint32;
+using MsgId = qint32;
+
+// The same layout and hash as FullMsgId and std::hash<FullMsgId> from
+// data/data_types.h, which can't be included without the whole ui.
+struct Key {
+	ChannelId channel = 0;
+	MsgId msg = 0;
+};
+
+inline bool operator==(const Key &a, const Key &b) {
+	return (a.channel == b.channel) && (a.msg == b.msg);
+}
+
+struct KeyHash {
+	size_t operator()(const Key &value) const {
+		return std::hash<quint64>()(
+			(quint64(quint32(value.channel)) << 32) | quint32(value.msg));
+	}
+};
+
+struct Item {
+	Key key;
+};
+
+// The previous App::msgsData / App::channelMsgsData pair.
+class ChannelsData {
+public:
+	void add(Item *item) {
+		data(item->key.channel).insert(item->key.msg, item);
+	}
+	void remove(const Item *item) {
+		data(item->key.channel).remove(item->key.msg);
+	}
+	Item *find(Key key) const {
+		if (!key.channel) {
+			return _msgs.value(key.msg);
+		}
+		const auto i = _channels.constFind(key.channel);
+		return (i != _channels.cend()) ? i->value(key.msg) : nullptr;
+	}
+
+private:
+	QHash<MsgId, Item*> &data(ChannelId channel) {
+		return channel ? _channels[channel] : _msgs;
+	}
+
+	QHash<MsgId, Item*> _msgs;
+	QMap<ChannelId, QHash<MsgId, Item*>> _channels;
+
+};
+
+// The current App::msgsData.
+class FullIdsData {
+public:
+	void add(Item *item) {
+		_data.emplace(item->key, item);
+	}
+	void remove(const Item *item) {
+		_data.erase(item->key);
+	}
+	Item *find(Key key) const {
+		const auto i = _data.find(key);
+		return (i != _data.end()) ? i->second : nullptr;
+	}
+
+private:
+	std::unordered_map<Key, Item*, KeyHash> _data;
+
+};
+
+TEST_CASE("messages data benchmark", "[.][benchmark][msgs_data]") {
+	constexpr auto kChannels = 500;
+	constexpr auto kItems = 300000;
+	constexpr auto kLookups = 3000000;
+
+	auto generator = std::mt19937(42);
+	auto channel = std::uniform_int_distribution<ChannelId>(0, kChannels);
+	auto msg = std::uniform_int_distribution<MsgId>(1, kItems);
+	auto items = std::vector<Item>(kItems);
+	for (auto &item : items) {
+		item.key = { channel(generator), msg(generator) };
+	}
+
+	// Half of the lookups are for the loaded items, half are misses,
+	// like App::histItemById() calls from the updates handlers.
+	auto keys = std::vector<Key>();
+	keys.reserve(kLookups);
+	auto index = std::uniform_int_distribution<int>(0, kItems - 1);
+	for (auto i = 0; i != kLookups; ++i) {
+		keys.push_back((i % 2)
+			? items[index(generator)].key
+			: Key{ channel(generator), msg(generator) + kItems });
+	}
+
+	const auto measure = [&](const std::string &name, auto &&data) {
+		base::test::benchmark(name + " add", [&] {
+			for (auto &item : items) {
+				data.add(&item);
+			}
+		});
+		const auto found = base::test::benchmark(name + " find", [&] {
+			auto result = 0;
+			for (const auto key : keys) {
+				if (data.find(key)) {
+					++result;
+				}
+			}
+			return result;
+		});
+		base::test::benchmark(name + " remove", [&] {
+			for (const auto &item : items) {
+				data.remove(&item);
+			}
+		});
+		return found;
+	};
+	const auto channels = measure("channels map", ChannelsData());
+	const auto full = measure("full ids hash", FullIdsData());
+	REQUIRE(channels == full);
+}
@@ -20,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/qthelp_regex.h"
 #include "core/update_checker.h"
 #include "core/crash_report_window.h"
+#include "core/startup_trace.h"
 
 namespace {
 
@@ -355,7 +356,10 @@ void Application::startApplication() {
 void Application::createMessenger() {
 	Expects(!App::quitting());
 
-	_messengerInstance = std::make_unique<Messenger>(_launcher);
+	Core::TraceStartupPhase("Messenger", [&] {
+		_messengerInstance = std::make_unique<Messenger>(_launcher);
+	});
+	Core::FinishStartupTrace();
 }
 
 void Application::refreshGlobalProxy() {
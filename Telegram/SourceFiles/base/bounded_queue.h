@@ -0,0 +1,125 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace base {
+
+// Fixed capacity lock-free queue for any number of producer and consumer
+// threads. It never waits: try_push() fails if the queue is full and
+// try_pop() fails if it is empty.
+//
+// Each cell has a sequence number telling whose turn it is to use it,
+// so producers and consumers only compete on the position counters.
+template <typename Type>
+class bounded_queue {
+public:
+	// Capacity is rounded up to a power of two.
+	explicit bounded_queue(std::size_t capacity);
+
+	bounded_queue(const bounded_queue &other) = delete;
+	bounded_queue &operator=(const bounded_queue &other) = delete;
+
+	std::size_t capacity() const {
+		return _mask + 1;
+	}
+
+	bool try_push(Type &&value);
+	bool try_pop(Type &value);
+
+private:
+	struct cell {
+		std::atomic<std::size_t> sequence;
+		Type value;
+	};
+
+	static std::size_t compute_capacity(std::size_t capacity);
+
+	const std::size_t _mask = 0;
+	const std::unique_ptr<cell[]> _cells;
+	std::atomic<std::size_t> _pushPosition = 0;
+	std::atomic<std::size_t> _popPosition = 0;
+
+};
+
+template <typename Type>
+bounded_queue<Type>::bounded_queue(std::size_t capacity)
+: _mask(compute_capacity(capacity) - 1)
+, _cells(std::make_unique<cell[]>(_mask + 1)) {
+	for (auto i = std::size_t(0); i != _mask + 1; ++i) {
+		_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <typename Type>
+std::size_t bounded_queue<Type>::compute_capacity(std::size_t capacity) {
+	auto result = std::size_t(2);
+	while (result < capacity) {
+		result <<= 1;
+	}
+	return result;
+}
+
+template <typename Type>
+bool bounded_queue<Type>::try_push(Type &&value) {
+	auto position = _pushPosition.load(std::memory_order_relaxed);
+	while (true) {
+		auto &cell = _cells[position & _mask];
+		const auto sequence = cell.sequence.load(std::memory_order_acquire);
+		const auto difference = std::ptrdiff_t(sequence)
+			- std::ptrdiff_t(position);
+		if (!difference) {
+			if (_pushPosition.compare_exchange_weak(
+					position,
+					position + 1,
+					std::memory_order_relaxed)) {
+				cell.value = std::move(value);
+				cell.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (difference < 0) {
+			// The consumers didn't free this cell yet, the queue is full.
+			return false;
+		} else {
+			position = _pushPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename Type>
+bool bounded_queue<Type>::try_pop(Type &value) {
+	auto position = _popPosition.load(std::memory_order_relaxed);
+	while (true) {
+		auto &cell = _cells[position & _mask];
+		const auto sequence = cell.sequence.load(std::memory_order_acquire);
+		const auto difference = std::ptrdiff_t(sequence)
+			- std::ptrdiff_t(position + 1);
+		if (!difference) {
+			if (_popPosition.compare_exchange_weak(
+					position,
+					position + 1,
+					std::memory_order_relaxed)) {
+				value = std::move(cell.value);
+				cell.value = Type();
+				cell.sequence.store(
+					position + _mask + 1,
+					std::memory_order_release);
+				return true;
+			}
+		} else if (difference < 0) {
+			// The producers didn't fill this cell yet, the queue is empty.
+			return false;
+		} else {
+			position = _popPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+} // namespace base
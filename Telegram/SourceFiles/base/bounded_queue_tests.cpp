@@ -0,0 +1,90 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "base/bounded_queue.h"
+#include <thread>
+#include <vector>
+
+TEST_CASE("bounded_queue should keep fifo order", "[bounded_queue]") {
+	base::bounded_queue<int> queue(5);
+	REQUIRE(queue.capacity() == 8);
+
+	auto value = 0;
+	REQUIRE(!queue.try_pop(value));
+
+	for (auto i = 0; i != 8; ++i) {
+		REQUIRE(queue.try_push(int(i)));
+	}
+	REQUIRE(!queue.try_push(8));
+
+	SECTION("all the values are popped") {
+		for (auto i = 0; i != 8; ++i) {
+			REQUIRE(queue.try_pop(value));
+			REQUIRE(value == i);
+		}
+		REQUIRE(!queue.try_pop(value));
+	}
+	SECTION("freed cells are reused") {
+		for (auto i = 0; i != 100; ++i) {
+			REQUIRE(queue.try_pop(value));
+			REQUIRE(value == i);
+			REQUIRE(queue.try_push(int(i + 8)));
+		}
+	}
+}
+
+TEST_CASE("bounded_queue should move values", "[bounded_queue]") {
+	base::bounded_queue<std::unique_ptr<int>> queue(2);
+	REQUIRE(queue.try_push(std::make_unique<int>(1)));
+
+	auto value = std::unique_ptr<int>();
+	REQUIRE(queue.try_pop(value));
+	REQUIRE(value != nullptr);
+	REQUIRE(*value == 1);
+}
+
+TEST_CASE("bounded_queue should work with many producers", "[bounded_queue]") {
+	constexpr auto kProducers = 4;
+	constexpr auto kCount = 100000;
+	base::bounded_queue<int> queue(1024);
+
+	auto producers = std::vector<std::thread>();
+	for (auto i = 0; i != kProducers; ++i) {
+		producers.emplace_back([&queue, i] {
+			for (auto j = 0; j != kCount; ++j) {
+				while (!queue.try_push(i * kCount + j)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// Values of each producer must come in the order they were pushed.
+	auto last = std::vector<int>(kProducers, -1);
+	auto ordered = true;
+	auto received = 0;
+	auto value = 0;
+	while (received != kProducers * kCount) {
+		if (!queue.try_pop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+		const auto producer = value / kCount;
+		if (value % kCount != last[producer] + 1) {
+			ordered = false;
+		}
+		last[producer] = value % kCount;
+		++received;
+	}
+	for (auto &producer : producers) {
+		producer.join();
+	}
+	REQUIRE(ordered);
+	REQUIRE(!queue.try_pop(value));
+}
@@ -7,9 +7,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
-#include <deque>
 #include <algorithm>
 #include "base/optional.h"
+#include "base/flat_storage.h"
 
 namespace base {
 
@@ -19,13 +19,15 @@ using std::end;
 template <
 	typename Key,
 	typename Type,
-	typename Compare = std::less<>>
+	typename Compare = std::less<>,
+	typename Storage = flat_deque_storage>
 class flat_map;
 
 template <
 	typename Key,
 	typename Type,
-	typename Compare = std::less<>>
+	typename Compare = std::less<>,
+	typename Storage = flat_deque_storage>
 class flat_multi_map;
 
 template <
@@ -204,7 +206,8 @@ private:
 	template <
 		typename OtherKey,
 		typename OtherType,
-		typename OtherCompare>
+		typename OtherCompare,
+		typename OtherStorage>
 	friend class flat_multi_map;
 
 	template <
@@ -218,7 +221,7 @@ private:
 
 };
 
-template <typename Key, typename Type, typename Compare>
+template <typename Key, typename Type, typename Compare, typename Storage>
 class flat_multi_map {
 public:
 	class iterator;
@@ -228,7 +231,7 @@ public:
 
 private:
 	using pair_type = flat_multi_map_pair_type<Key, Type>;
-	using impl_t = std::deque<pair_type>;
+	using impl_t = typename Storage::template container<pair_type>;
 
 	using iterator_base = flat_multi_map_iterator_base_impl<
 		iterator,
@@ -378,7 +381,7 @@ public:
 
 	iterator insert(const value_type &value) {
 		if (empty() || compare()(value.first, front().first)) {
-			impl().push_front(value);
+			impl().insert(impl().begin(), value);
 			return begin();
 		} else if (!compare()(value.first, back().first)) {
 			impl().push_back(value);
@@ -389,7 +392,7 @@ public:
 	}
 	iterator insert(value_type &&value) {
 		if (empty() || compare()(value.first, front().first)) {
-			impl().push_front(std::move(value));
+			impl().insert(impl().begin(), std::move(value));
 			return begin();
 		} else if (!compare()(value.first, back().first)) {
 			impl().push_back(std::move(value));
@@ -475,7 +478,7 @@ public:
 	}
 
 private:
-	friend class flat_map<Key, Type, Compare>;
+	friend class flat_map<Key, Type, Compare, Storage>;
 
 	struct transparent_compare : Compare {
 		inline constexpr const Compare &initial() const noexcept {
@@ -546,18 +549,34 @@ private:
 	}
 
 	typename impl_t::iterator getLowerBound(const Key &key) {
-		return std::lower_bound(
-			std::begin(impl()),
-			std::end(impl()),
-			key,
-			compare());
+		if constexpr (details::flat_use_branchless_search<Storage, Key>) {
+			return details::flat_branchless_lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				key,
+				compare());
+		} else {
+			return std::lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				key,
+				compare());
+		}
 	}
 	typename impl_t::const_iterator getLowerBound(const Key &key) const {
-		return std::lower_bound(
-			std::begin(impl()),
-			std::end(impl()),
-			key,
-			compare());
+		if constexpr (details::flat_use_branchless_search<Storage, Key>) {
+			return details::flat_branchless_lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				key,
+				compare());
+		} else {
+			return std::lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				key,
+				compare());
+		}
 	}
 	typename impl_t::iterator getUpperBound(const Key &key) {
 		return std::upper_bound(
@@ -596,9 +615,9 @@ private:
 
 };
 
-template <typename Key, typename Type, typename Compare>
-class flat_map : private flat_multi_map<Key, Type, Compare> {
-	using parent = flat_multi_map<Key, Type, Compare>;
+template <typename Key, typename Type, typename Compare, typename Storage>
+class flat_map : private flat_multi_map<Key, Type, Compare, Storage> {
+	using parent = flat_multi_map<Key, Type, Compare, Storage>;
 	using pair_type = typename parent::pair_type;
 
 public:
@@ -633,7 +652,7 @@ public:
 
 	std::pair<iterator, bool> insert(const value_type &value) {
 		if (this->empty() || this->compare()(value.first, this->front().first)) {
-			this->impl().push_front(value);
+			this->impl().insert(this->impl().begin(), value);
 			return { this->begin(), true };
 		} else if (this->compare()(this->back().first, value.first)) {
 			this->impl().push_back(value);
@@ -647,7 +666,7 @@ public:
 	}
 	std::pair<iterator, bool> insert(value_type &&value) {
 		if (this->empty() || this->compare()(value.first, this->front().first)) {
-			this->impl().push_front(std::move(value));
+			this->impl().insert(this->impl().begin(), std::move(value));
 			return { this->begin(), true };
 		} else if (this->compare()(this->back().first, value.first)) {
 			this->impl().push_back(std::move(value));
@@ -672,7 +691,7 @@ public:
 			const Key &key,
 			Args&&... args) {
 		if (this->empty() || this->compare()(key, this->front().first)) {
-			this->impl().push_front(value_type(
+			this->impl().insert(this->impl().begin(), value_type(
 				key,
 				Type(std::forward<Args>(args)...)));
 			return { this->begin(), true };
@@ -709,8 +728,9 @@ public:
 
 	Type &operator[](const Key &key) {
 		if (this->empty() || this->compare()(key, this->front().first)) {
-			this->impl().push_front({ key, Type() });
-			return this->front().second;
+			return this->impl().insert(
+				this->impl().begin(),
+				{ key, Type() })->second;
 		} else if (this->compare()(this->back().first, key)) {
 			this->impl().push_back({ key, Type() });
 			return this->back().second;
@@ -734,4 +754,14 @@ public:
 
 };
 
+template <typename Key, typename Type, typename Compare = std::less<>>
+using vector_flat_map = flat_map<Key, Type, Compare, flat_vector_storage>;
+
+template <typename Key, typename Type, typename Compare = std::less<>>
+using vector_flat_multi_map = flat_multi_map<
+	Key,
+	Type,
+	Compare,
+	flat_vector_storage>;
+
 } // namespace base
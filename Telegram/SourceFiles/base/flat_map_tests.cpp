@@ -8,7 +8,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "catch.hpp"
 
 #include "base/flat_map.h"
+#include "base/tests_benchmark.h"
+#include <random>
 #include <string>
+#include <vector>
 
 struct int_wrap {
 	int value;
@@ -91,3 +94,73 @@ TEST_CASE("flat_maps custom comparator", "[flat_map]") {
 		checkSorted();
 	}
 }
+
+TEST_CASE("vector_flat_maps should keep items sorted by key", "[flat_map]") {
+	base::vector_flat_map<int, string> v;
+	v.emplace(0, "a");
+	v.emplace(5, "b");
+	v.emplace(4, "d");
+	v.emplace(2, "e");
+	v[-1] = "f";
+
+	REQUIRE(v.size() == 5);
+	REQUIRE(v.front().first == -1);
+	REQUIRE(v.front().second == "f");
+	REQUIRE(v.back().first == 5);
+	for (auto i = v.begin() + 1; i != v.end(); ++i) {
+		REQUIRE((i - 1)->first < i->first);
+	}
+
+	SECTION("lookup finds existing keys only") {
+		REQUIRE(v.find(4) != v.end());
+		REQUIRE(v.find(4)->second == "d");
+		REQUIRE(v.find(3) == v.end());
+		REQUIRE(v.find(6) == v.end());
+	}
+	SECTION("operator[] inserts missing keys in the right position") {
+		v[3] = "c";
+		v[-2];
+		REQUIRE(v.size() == 7);
+		REQUIRE(v.front().first == -2);
+		REQUIRE(v.front().second.empty());
+		REQUIRE(v.find(3)->second == "c");
+		REQUIRE(v.find(3) + 1 == v.find(4));
+	}
+	SECTION("erasing keeps other items") {
+		v.erase(4);
+		REQUIRE(v.size() == 4);
+		REQUIRE(v.find(4) == v.end());
+		REQUIRE(v.find(5) != v.end());
+	}
+}
+
+TEST_CASE("flat_map lookup benchmark", "[.][benchmark][flat_map]") {
+	auto generator = std::mt19937(42);
+	auto values = std::uniform_int_distribution<int>(0, 1 << 30);
+	auto deque = base::flat_map<int, int>();
+	auto vector = base::vector_flat_map<int, int>();
+	for (auto i = 0; i != 100000; ++i) {
+		const auto value = values(generator);
+		deque.emplace(value, i);
+		vector.emplace(value, i);
+	}
+	auto queries = std::vector<int>(1000000);
+	for (auto &query : queries) {
+		query = values(generator);
+	}
+
+	const auto lookup = [&](const auto &map) {
+		auto found = 0;
+		for (const auto query : queries) {
+			found += (map.find(query) != map.end()) ? 1 : 0;
+		}
+		return found;
+	};
+	const auto inDeque = base::test::benchmark("deque storage", [&] {
+		return lookup(deque);
+	});
+	const auto inVector = base::test::benchmark("vector storage", [&] {
+		return lookup(vector);
+	});
+	REQUIRE(inDeque == inVector);
+}
@@ -7,7 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
-#include <deque>
+#include "base/flat_storage.h"
 #include <algorithm>
 
 namespace base {
@@ -15,10 +15,16 @@ namespace base {
 using std::begin;
 using std::end;
 
-template <typename Type, typename Compare = std::less<>>
+template <
+	typename Type,
+	typename Compare = std::less<>,
+	typename Storage = flat_deque_storage>
 class flat_set;
 
-template <typename Type, typename Compare = std::less<>>
+template <
+	typename Type,
+	typename Compare = std::less<>,
+	typename Storage = flat_deque_storage>
 class flat_multi_set;
 
 template <typename Type, typename iterator_impl>
@@ -116,10 +122,16 @@ public:
 private:
 	iterator_impl _impl;
 
-	template <typename OtherType, typename OtherCompare>
+	template <
+		typename OtherType,
+		typename OtherCompare,
+		typename OtherStorage>
 	friend class flat_multi_set;
 
-	template <typename OtherType, typename OtherCompare>
+	template <
+		typename OtherType,
+		typename OtherCompare,
+		typename OtherStorage>
 	friend class flat_set;
 
 	template <
@@ -154,10 +166,10 @@ private:
 
 };
 
-template <typename Type, typename Compare>
+template <typename Type, typename Compare, typename Storage>
 class flat_multi_set {
 	using const_wrap = flat_multi_set_const_wrap<Type>;
-	using impl_t = std::deque<const_wrap>;
+	using impl_t = typename Storage::template container<const_wrap>;
 
 public:
 	using value_type = Type;
@@ -249,7 +261,7 @@ public:
 
 	iterator insert(const Type &value) {
 		if (empty() || compare()(value, front())) {
-			impl().push_front(value);
+			impl().insert(impl().begin(), value);
 			return begin();
 		} else if (!compare()(value, back())) {
 			impl().push_back(value);
@@ -260,7 +272,7 @@ public:
 	}
 	iterator insert(Type &&value) {
 		if (empty() || compare()(value, front())) {
-			impl().push_front(std::move(value));
+			impl().insert(impl().begin(), std::move(value));
 			return begin();
 		} else if (!compare()(value, back())) {
 			impl().push_back(std::move(value));
@@ -400,7 +412,7 @@ public:
 		std::sort(std::begin(impl()), std::end(impl()), compare());
 	}
 
-	void merge(const flat_multi_set<Type, Compare> &other) {
+	void merge(const flat_multi_set<Type, Compare, Storage> &other) {
 		merge(other.begin(), other.end());
 	}
 
@@ -409,7 +421,7 @@ public:
 	}
 
 private:
-	friend class flat_set<Type, Compare>;
+	friend class flat_set<Type, Compare, Storage>;
 
 	struct transparent_compare : Compare {
 		inline constexpr const Compare &initial() const noexcept {
@@ -486,18 +498,34 @@ private:
 	}
 
 	typename impl_t::iterator getLowerBound(const Type &value) {
-		return std::lower_bound(
-			std::begin(impl()),
-			std::end(impl()),
-			value,
-			compare());
+		if constexpr (details::flat_use_branchless_search<Storage, Type>) {
+			return details::flat_branchless_lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				value,
+				compare());
+		} else {
+			return std::lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				value,
+				compare());
+		}
 	}
 	typename impl_t::const_iterator getLowerBound(const Type &value) const {
-		return std::lower_bound(
-			std::begin(impl()),
-			std::end(impl()),
-			value,
-			compare());
+		if constexpr (details::flat_use_branchless_search<Storage, Type>) {
+			return details::flat_branchless_lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				value,
+				compare());
+		} else {
+			return std::lower_bound(
+				std::begin(impl()),
+				std::end(impl()),
+				value,
+				compare());
+		}
 	}
 	template <
 		typename OtherType,
@@ -556,9 +584,9 @@ private:
 
 };
 
-template <typename Type, typename Compare>
-class flat_set : private flat_multi_set<Type, Compare> {
-	using parent = flat_multi_set<Type, Compare>;
+template <typename Type, typename Compare, typename Storage>
+class flat_set : private flat_multi_set<Type, Compare, Storage> {
+	using parent = flat_multi_set<Type, Compare, Storage>;
 
 public:
 	using iterator = typename parent::iterator;
@@ -604,7 +632,7 @@ public:
 
 	iterator insert(const Type &value) {
 		if (this->empty() || this->compare()(value, this->front())) {
-			this->impl().push_front(value);
+			this->impl().insert(this->impl().begin(), value);
 			return this->begin();
 		} else if (this->compare()(this->back(), value)) {
 			this->impl().push_back(value);
@@ -618,7 +646,7 @@ public:
 	}
 	iterator insert(Type &&value) {
 		if (this->empty() || this->compare()(value, this->front())) {
-			this->impl().push_front(std::move(value));
+			this->impl().insert(this->impl().begin(), std::move(value));
 			return this->begin();
 		} else if (this->compare()(this->back(), value)) {
 			this->impl().push_back(std::move(value));
@@ -692,7 +720,7 @@ public:
 		finalize();
 	}
 
-	void merge(const flat_multi_set<Type, Compare> &other) {
+	void merge(const flat_multi_set<Type, Compare, Storage> &other) {
 		merge(other.begin(), other.end());
 	}
 
@@ -715,4 +743,13 @@ private:
 
 };
 
+template <typename Type, typename Compare = std::less<>>
+using vector_flat_set = flat_set<Type, Compare, flat_vector_storage>;
+
+template <typename Type, typename Compare = std::less<>>
+using vector_flat_multi_set = flat_multi_set<
+	Type,
+	Compare,
+	flat_vector_storage>;
+
 } // namespace base
@@ -8,6 +8,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "catch.hpp"
 
 #include "base/flat_set.h"
+#include <algorithm>
+#include <random>
+#include <vector>
 
 struct int_wrap {
 	int value;
@@ -82,3 +85,58 @@ TEST_CASE("flat_sets with custom comparators", "[flat_set]") {
 		checkSorted();
 	}
 }
+
+TEST_CASE("vector_flat_sets should keep items sorted", "[flat_set]") {
+	base::vector_flat_set<int> v;
+	v.insert(0);
+	v.insert(5);
+	v.insert(4);
+	v.insert(2);
+	v.insert(-1);
+
+	REQUIRE(v.size() == 5);
+	REQUIRE(v.contains(4));
+	REQUIRE(!v.contains(3));
+	REQUIRE(v.front() == -1);
+	REQUIRE(v.back() == 5);
+	for (auto i = v.begin() + 1; i != v.end(); ++i) {
+		REQUIRE(*(i - 1) < *i);
+	}
+
+	SECTION("adding item puts it in the right position") {
+		v.insert(3);
+		REQUIRE(v.size() == 6);
+		REQUIRE(v.find(3) == v.find(2) + 1);
+		REQUIRE(v.find(6) == v.end());
+	}
+	SECTION("removing keeps other items") {
+		v.remove(4);
+		REQUIRE(v.size() == 4);
+		REQUIRE(!v.contains(4));
+		REQUIRE(v.contains(5));
+	}
+}
+
+TEST_CASE("branchless lower_bound matches std::lower_bound", "[flat_set]") {
+	auto generator = std::mt19937(42);
+	auto values = std::uniform_int_distribution<int>(-100, 100);
+	for (auto size = 0; size != 70; ++size) {
+		auto data = std::vector<int>(size);
+		for (auto &value : data) {
+			value = values(generator);
+		}
+		std::sort(begin(data), end(data));
+		for (auto value = -102; value != 103; ++value) {
+			const auto branchless = base::details::flat_branchless_lower_bound(
+				begin(data),
+				end(data),
+				value,
+				std::less<>());
+			const auto standard = std::lower_bound(
+				begin(data),
+				end(data),
+				value);
+			REQUIRE(branchless == standard);
+		}
+	}
+}
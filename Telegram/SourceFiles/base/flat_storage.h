@@ -0,0 +1,64 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <iterator>
+#include <type_traits>
+
+namespace base {
+
+// Element storage of flat_map / flat_set / flat_multi_map / flat_multi_set.
+//
+// Deque storage is the default, it inserts at the front in O(1).
+// Vector storage keeps the elements contiguous, it is faster to search and
+// iterate, so it suits containers that are mostly read or appended to.
+struct flat_deque_storage {
+	template <typename Type>
+	using container = std::deque<Type>;
+
+	static constexpr bool contiguous = false;
+};
+
+struct flat_vector_storage {
+	template <typename Type>
+	using container = std::vector<Type>;
+
+	static constexpr bool contiguous = true;
+};
+
+namespace details {
+
+// Binary search without a data dependent branch, the compiler chooses
+// the next half with a conditional move. It pays off for contiguous
+// storage of small keys, where the comparison itself is cheap.
+template <typename Storage, typename Key>
+constexpr bool flat_use_branchless_search = Storage::contiguous
+	&& std::is_scalar_v<Key>;
+
+template <typename Iterator, typename Value, typename Compare>
+Iterator flat_branchless_lower_bound(
+		Iterator first,
+		Iterator last,
+		const Value &value,
+		const Compare &compare) {
+	auto length = last - first;
+	if (!length) {
+		return first;
+	}
+	while (length > 1) {
+		const auto half = length / 2;
+		first = compare(first[half], value) ? (first + half) : first;
+		length -= half;
+	}
+	return compare(*first, value) ? (first + 1) : first;
+}
+
+} // namespace details
+} // namespace base
@@ -0,0 +1,94 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace base {
+
+// Value published by one writer thread and read by any number of threads
+// without locking. Readers never block the writer: a reader that sees a
+// store in progress or finished during its copy just copies again.
+//
+// Only one thread may store() at a time, for example all the stores are
+// done under some mutex that the readers don't need.
+template <typename Type>
+class seqlock {
+	static_assert(
+		std::is_trivially_copyable_v<Type>,
+		"seqlock value should be trivially copyable.");
+
+public:
+	seqlock() {
+		store(Type());
+	}
+	explicit seqlock(const Type &value) {
+		store(value);
+	}
+
+	seqlock(const seqlock &other) = delete;
+	seqlock &operator=(const seqlock &other) = delete;
+
+	void store(const Type &value);
+	Type load() const;
+
+private:
+	using Word = std::uint64_t;
+	static constexpr auto kWords = (sizeof(Type) + sizeof(Word) - 1)
+		/ sizeof(Word);
+	using Words = std::array<Word, kWords>;
+
+	// Sequence is odd while a store is in progress.
+	std::atomic<std::uint32_t> _sequence = 0;
+
+	// The value is kept in atomic words, so that a torn copy is
+	// detected by the sequence check instead of being a data race.
+	std::array<std::atomic<Word>, kWords> _words;
+
+};
+
+template <typename Type>
+void seqlock<Type>::store(const Type &value) {
+	auto words = Words{ { 0 } };
+	std::memcpy(words.data(), &value, sizeof(Type));
+
+	const auto sequence = _sequence.load(std::memory_order_relaxed);
+	_sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (auto i = std::size_t(); i != kWords; ++i) {
+		_words[i].store(words[i], std::memory_order_relaxed);
+	}
+	_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template <typename Type>
+Type seqlock<Type>::load() const {
+	auto words = Words();
+	while (true) {
+		const auto before = _sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			continue;
+		}
+		for (auto i = std::size_t(); i != kWords; ++i) {
+			words[i] = _words[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (_sequence.load(std::memory_order_relaxed) == before) {
+			break;
+		}
+	}
+	auto result = Type();
+	std::memcpy(static_cast<void*>(&result), words.data(), sizeof(Type));
+	return result;
+}
+
+} // namespace base
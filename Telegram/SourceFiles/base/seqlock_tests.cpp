@@ -0,0 +1,102 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "base/seqlock.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Sample {
+	std::int64_t position = 0;
+	std::int64_t length = 0;
+	int state = 0;
+	int frequency = 0;
+	std::int64_t check = 0;
+};
+
+Sample MakeSample(std::int64_t position) {
+	auto result = Sample();
+	result.position = position;
+	result.length = position * 3;
+	result.state = int(position % 7);
+	result.frequency = 48000;
+	result.check = -position;
+	return result;
+}
+
+bool Consistent(const Sample &sample) {
+	return (sample.length == sample.position * 3)
+		&& (sample.state == int(sample.position % 7))
+		&& (sample.frequency == 48000 || !sample.position)
+		&& (sample.check == -sample.position);
+}
+
+} // namespace
+
+TEST_CASE("seqlock should return the stored value", "[seqlock]") {
+	auto lock = base::seqlock<Sample>();
+	REQUIRE(lock.load().position == 0);
+
+	lock.store(MakeSample(5));
+	const auto loaded = lock.load();
+	REQUIRE(loaded.position == 5);
+	REQUIRE(Consistent(loaded));
+
+	auto small = base::seqlock<char>('a');
+	REQUIRE(small.load() == 'a');
+	small.store('b');
+	REQUIRE(small.load() == 'b');
+}
+
+TEST_CASE("seqlock should never give a torn value", "[seqlock]") {
+	// Several tracks updated by their writers while readers poll them all.
+	constexpr auto kTracks = 4;
+	constexpr auto kReaders = 4;
+	constexpr auto kStores = 200000;
+
+	base::seqlock<Sample> tracks[kTracks];
+	auto finished = std::atomic<int>(0);
+	auto writers = std::vector<std::thread>();
+	for (auto i = 0; i != kTracks; ++i) {
+		writers.emplace_back([&, i] {
+			for (auto j = 1; j <= kStores; ++j) {
+				tracks[i].store(MakeSample(j));
+			}
+			++finished;
+		});
+	}
+
+	auto readers = std::vector<std::thread>();
+	auto failed = std::atomic<int>(0);
+	for (auto i = 0; i != kReaders; ++i) {
+		readers.emplace_back([&] {
+			std::int64_t last[kTracks] = { 0 };
+			while (finished.load() != kTracks) {
+				for (auto j = 0; j != kTracks; ++j) {
+					const auto sample = tracks[j].load();
+					if (!Consistent(sample) || sample.position < last[j]) {
+						++failed;
+					}
+					last[j] = sample.position;
+				}
+			}
+		});
+	}
+	for (auto &thread : writers) {
+		thread.join();
+	}
+	for (auto &thread : readers) {
+		thread.join();
+	}
+	REQUIRE(failed == 0);
+	for (auto i = 0; i != kTracks; ++i) {
+		REQUIRE(tracks[i].load().position == kStores);
+	}
+}
@@ -0,0 +1,50 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Benchmark test cases are tagged "[.][benchmark]", so Catch skips them
+// in the usual runs. Pass the "[benchmark]" tag to the tests to run them.
+namespace base {
+namespace test {
+
+class benchmark_timer {
+public:
+	using clock = std::chrono::high_resolution_clock;
+
+	explicit benchmark_timer(std::string name)
+	: _name(std::move(name))
+	, _start(clock::now()) {
+	}
+	benchmark_timer(const benchmark_timer &other) = delete;
+	benchmark_timer &operator=(const benchmark_timer &other) = delete;
+
+	~benchmark_timer() {
+		const auto mcs = std::chrono::duration_cast<
+			std::chrono::microseconds>(clock::now() - _start).count();
+		std::cout << _name << ": " << mcs << " mcs." << std::endl;
+	}
+
+private:
+	std::string _name;
+	clock::time_point _start;
+
+};
+
+// Prints the time the method took and returns its result.
+template <typename Method>
+decltype(auto) benchmark(std::string name, Method &&method) {
+	const benchmark_timer timer(std::move(name));
+	return method();
+}
+
+} // namespace test
+} // namespace base
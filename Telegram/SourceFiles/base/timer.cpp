@@ -7,9 +7,37 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "base/timer.h"
 
+#include "base/timer_wheel.h"
 #include <QtCore/QTimerEvent>
+#include <QtCore/QThreadStorage>
 
 namespace base {
+namespace details {
+
+class TimerWheel final : public QObject {
+public:
+	TimerWheel();
+
+	static std::shared_ptr<TimerWheel> Current();
+
+	int add(TimeMs when, not_null<Timer*> timer);
+	void remove(int handle);
+
+protected:
+	void timerEvent(QTimerEvent *e) override;
+
+private:
+	void schedule();
+	void adjust();
+
+	base::timer_wheel<Timer*> _wheel;
+	TimeMs _scheduled = -1;
+	int _timerId = 0;
+	bool _firing = false;
+
+};
+
+} // namespace details
 namespace {
 
 QObject *TimersAdjuster() {
@@ -17,21 +45,33 @@ QObject *TimersAdjuster() {
 	return &adjuster;
 }
 
-} // namespace
+QThreadStorage<std::shared_ptr<details::TimerWheel>> TimerWheels;
 
-Timer::Timer(
-	not_null<QThread*> thread,
-	Fn<void()> callback)
-: Timer(std::move(callback)) {
-	moveToThread(thread);
+// Coarse timers may fire up to 5% later, same as in Qt.
+// Such deadlines are rounded up so that close ones become equal.
+TimeMs ComputeDeadline(TimeMs next, int timeout, Qt::TimerType type) {
+	const auto round = [&](TimeMs granularity) {
+		return ((next + granularity - 1) / granularity) * granularity;
+	};
+	switch (type) {
+	case Qt::PreciseTimer: return next;
+	case Qt::CoarseTimer: {
+		auto granularity = TimeMs(1);
+		while (granularity * 2 <= timeout / 20) {
+			granularity *= 2;
+		}
+		return round(granularity);
+	} break;
+	case Qt::VeryCoarseTimer: return round(1000);
+	}
+	Unexpected("Type in ComputeDeadline.");
 }
 
-Timer::Timer(Fn<void()> callback)
-: QObject(nullptr)
-, _callback(std::move(callback))
-, _type(Qt::PreciseTimer)
-, _adjusted(false) {
-	setRepeat(Repeat::Interval);
+} // namespace
+
+namespace details {
+
+TimerWheel::TimerWheel() : _wheel(crl::time()) {
 	connect(
 		TimersAdjuster(),
 		&QObject::destroyed,
@@ -40,24 +80,127 @@ Timer::Timer(Fn<void()> callback)
 		Qt::QueuedConnection);
 }
 
+std::shared_ptr<TimerWheel> TimerWheel::Current() {
+	if (!TimerWheels.hasLocalData()) {
+		TimerWheels.setLocalData(std::make_shared<TimerWheel>());
+	}
+	return TimerWheels.localData();
+}
+
+int TimerWheel::add(TimeMs when, not_null<Timer*> timer) {
+	const auto result = _wheel.add(when, timer);
+	if (!_firing) {
+		schedule();
+	}
+	return result;
+}
+
+void TimerWheel::remove(int handle) {
+	// The system timer will wake us up for nothing and get stopped then.
+	_wheel.remove(handle);
+}
+
+void TimerWheel::timerEvent(QTimerEvent *e) {
+	killTimer(base::take(_timerId));
+	_scheduled = -1;
+
+	_firing = true;
+	_wheel.advance(crl::time(), [](not_null<Timer*> timer) {
+		timer->fired();
+	});
+	_firing = false;
+
+	schedule();
+}
+
+void TimerWheel::schedule() {
+	const auto next = _wheel.next();
+	if (next < 0) {
+		if (_timerId) {
+			killTimer(base::take(_timerId));
+			_scheduled = -1;
+		}
+		return;
+	} else if (_timerId && _scheduled <= next) {
+		return;
+	} else if (_timerId) {
+		killTimer(base::take(_timerId));
+	}
+	const auto timeout = std::max(next - crl::time(), TimeMs(0));
+	_timerId = startTimer(int(timeout), Qt::PreciseTimer);
+	_scheduled = _timerId ? next : -1;
+}
+
+void TimerWheel::adjust() {
+	// After the system sleep the system timer may be late, restart it.
+	if (_timerId) {
+		killTimer(base::take(_timerId));
+		_scheduled = -1;
+	}
+	schedule();
+}
+
+} // namespace details
+
+Timer::Timer(
+	not_null<QThread*> thread,
+	Fn<void()> callback)
+: _callback(std::move(callback))
+, _thread(thread)
+, _type(Qt::PreciseTimer) {
+	setRepeat(Repeat::Interval);
+}
+
+Timer::Timer(Fn<void()> callback)
+: Timer(QThread::currentThread(), std::move(callback)) {
+}
+
+Timer::~Timer() {
+	cancel();
+}
+
 void Timer::start(TimeMs timeout, Qt::TimerType type, Repeat repeat) {
+	// The timer is added to the wheel of the current thread.
+	Expects(QThread::currentThread() == _thread);
+
 	cancel();
 
 	_type = type;
 	setRepeat(repeat);
-	_adjusted = false;
 	setTimeout(timeout);
-	_timerId = startTimer(_timeout, _type);
-	if (_timerId) {
+	_next = crl::time() + _timeout;
+	schedule();
+}
+
+void Timer::schedule() {
+	auto wheel = _wheel.lock();
+	if (!wheel) {
+		wheel = details::TimerWheel::Current();
+		_wheel = wheel;
+	}
+	_handle = wheel->add(ComputeDeadline(_next, _timeout, _type), this);
+}
+
+void Timer::fired() {
+	_handle = -1;
+	if (repeat() == Repeat::Interval) {
 		_next = crl::time() + _timeout;
-	} else {
-		_next = 0;
+		schedule();
+	}
+
+	if (_callback) {
+		_callback();
 	}
 }
 
 void Timer::cancel() {
 	if (isActive()) {
-		killTimer(base::take(_timerId));
+		Expects(QThread::currentThread() == _thread);
+
+		if (const auto wheel = _wheel.lock()) {
+			wheel->remove(_handle);
+		}
+		_handle = -1;
 	}
 }
 
@@ -71,22 +214,13 @@ TimeMs Timer::remainingTime() const {
 
 void Timer::Adjust() {
 	QObject emitter;
-	connect(
+	QObject::connect(
 		&emitter,
 		&QObject::destroyed,
 		TimersAdjuster(),
 		&QObject::destroyed);
 }
 
-void Timer::adjust() {
-	auto remaining = remainingTime();
-	if (remaining >= 0) {
-		cancel();
-		_timerId = startTimer(remaining, _type);
-		_adjusted = true;
-	}
-}
-
 void Timer::setTimeout(TimeMs timeout) {
 	Expects(timeout >= 0 && timeout <= std::numeric_limits<int>::max());
 
@@ -97,22 +231,6 @@ int Timer::timeout() const {
 	return _timeout;
 }
 
-void Timer::timerEvent(QTimerEvent *e) {
-	if (repeat() == Repeat::Interval) {
-		if (_adjusted) {
-			start(_timeout, _type, repeat());
-		} else {
-			_next = crl::time() + _timeout;
-		}
-	} else {
-		cancel();
-	}
-
-	if (_callback) {
-		_callback();
-	}
-}
-
 int DelayedCallTimer::call(
 		TimeMs timeout,
 		FnMut<void()> callback,
@@ -13,13 +13,24 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/flat_map.h"
 
 namespace base {
-
-class Timer final : private QObject {
+namespace details {
+class TimerWheel;
+} // namespace details
+
+// All the timers of a thread are kept in a single timer wheel, that wakes
+// up the thread once for all the timers that are due at the same time.
+// Coarse timers are rounded so that they are fired together more often.
+class Timer final {
 public:
+	// Timer must be started and cancelled on the thread it was created on
+	// or on the thread passed to the constructor.
 	explicit Timer(
 		not_null<QThread*> thread,
 		Fn<void()> callback = nullptr);
 	explicit Timer(Fn<void()> callback = nullptr);
+	Timer(const Timer &other) = delete;
+	Timer &operator=(const Timer &other) = delete;
+	~Timer();
 
 	static Qt::TimerType DefaultType(TimeMs timeout) {
 		constexpr auto kThreshold = TimeMs(1000);
@@ -47,7 +58,7 @@ public:
 	}
 
 	bool isActive() const {
-		return (_timerId != 0);
+		return (_handle >= 0);
 	}
 
 	void cancel();
@@ -55,16 +66,16 @@ public:
 
 	static void Adjust();
 
-protected:
-	void timerEvent(QTimerEvent *e) override;
-
 private:
+	friend class details::TimerWheel;
+
 	enum class Repeat : unsigned {
 		Interval   = 0,
 		SingleShot = 1,
 	};
 	void start(TimeMs timeout, Qt::TimerType type, Repeat repeat);
-	void adjust();
+	void schedule();
+	void fired();
 
 	void setTimeout(TimeMs timeout);
 	int timeout() const;
@@ -77,12 +88,13 @@ private:
 	}
 
 	Fn<void()> _callback;
+	const not_null<QThread*> _thread;
+	std::weak_ptr<details::TimerWheel> _wheel;
 	TimeMs _next = 0;
 	int _timeout = 0;
-	int _timerId = 0;
+	int _handle = -1;
 
 	Qt::TimerType _type : 2;
-	bool _adjusted : 1;
 	unsigned _repeat : 1;
 
 };
@@ -0,0 +1,286 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <gsl/gsl_assert>
+
+namespace base {
+
+// Hierarchical timing wheel with millisecond resolution.
+//
+// Level 0 has a bucket for each of the next 64 milliseconds, each next
+// level has buckets 64 times longer. An entry goes to the level its
+// deadline fits in and moves one level down each time the wheel reaches
+// its bucket. Adding and removing entries is O(1), advancing is O(1) per
+// passed bucket plus the number of entries that were moved or fired.
+template <typename Value>
+class timer_wheel {
+public:
+	static constexpr auto kLevels = 4;
+	static constexpr auto kSlotShift = 6;
+	static constexpr auto kSlots = (1 << kSlotShift);
+
+	explicit timer_wheel(std::int64_t now) : _now(now) {
+	}
+
+	timer_wheel(const timer_wheel &other) = delete;
+	timer_wheel &operator=(const timer_wheel &other) = delete;
+
+	std::int64_t now() const {
+		return _now;
+	}
+	bool empty() const {
+		return (_entries.size() == _freeEntries.size());
+	}
+
+	// Returns a handle for remove(), it stays valid until the entry fires.
+	int add(std::int64_t when, Value value);
+	void remove(int handle);
+
+	// The earliest time advance() should be called at, -1 if empty.
+	std::int64_t next() const;
+
+	// Calls method(value) for every entry with deadline <= now, entries
+	// added from the method with deadline <= now wait for the next call.
+	template <typename Method>
+	void advance(std::int64_t now, Method &&method);
+
+private:
+	static constexpr auto kDue = kLevels;
+
+	struct Entry {
+		std::int64_t when = 0;
+		Value value = Value();
+		int level = -1;
+		int slot = 0;
+		int index = 0;
+	};
+	using Bucket = std::vector<int>;
+
+	static std::int64_t Granularity(int level) {
+		return std::int64_t(1) << (level * kSlotShift);
+	}
+	int allocate(std::int64_t when, Value &&value);
+	void release(int handle);
+	void place(int handle);
+	void unlink(int handle);
+	void cascade(int level, std::int64_t from, std::int64_t till);
+	std::int64_t earliestIn(int level) const;
+
+	std::int64_t _now = 0;
+	std::vector<Entry> _entries;
+	std::vector<int> _freeEntries;
+	std::array<std::array<Bucket, kSlots>, kLevels> _buckets;
+	std::array<std::uint64_t, kLevels> _occupied = { { 0 } };
+	std::vector<int> _due;
+	int _dueRemoved = 0;
+
+};
+
+template <typename Value>
+int timer_wheel<Value>::add(std::int64_t when, Value value) {
+	const auto handle = allocate(when, std::move(value));
+	place(handle);
+	return handle;
+}
+
+template <typename Value>
+void timer_wheel<Value>::remove(int handle) {
+	Expects(handle >= 0 && handle < int(_entries.size()));
+	Expects(_entries[handle].level >= 0);
+
+	unlink(handle);
+	release(handle);
+}
+
+template <typename Value>
+std::int64_t timer_wheel<Value>::next() const {
+	if (int(_due.size()) > _dueRemoved) {
+		return _now;
+	}
+	auto result = std::int64_t(-1);
+	for (auto level = 0; level != kLevels; ++level) {
+		const auto earliest = earliestIn(level);
+		if (earliest >= 0 && (result < 0 || earliest < result)) {
+			result = earliest;
+		}
+	}
+	return result;
+}
+
+template <typename Value>
+template <typename Method>
+void timer_wheel<Value>::advance(std::int64_t now, Method &&method) {
+	if (now > _now) {
+		const auto was = _now;
+		_now = now;
+		for (auto level = kLevels; level != 0;) {
+			cascade(--level, was, now);
+		}
+	}
+
+	// Fire in the deadline order, removed entries leave -1 in _due.
+	const auto till = int(_due.size());
+	std::stable_sort(begin(_due), end(_due), [&](int a, int b) {
+		return (a >= 0 && b >= 0)
+			? (_entries[a].when < _entries[b].when)
+			: (a >= 0);
+	});
+	for (auto i = 0; i != till; ++i) {
+		if (_due[i] >= 0) {
+			_entries[_due[i]].index = i;
+		}
+	}
+	for (auto i = 0; i != till; ++i) {
+		const auto handle = _due[i];
+		if (handle < 0) {
+			continue;
+		}
+		_due[i] = -1;
+		++_dueRemoved;
+		auto value = std::move(_entries[handle].value);
+		release(handle);
+		method(std::move(value));
+	}
+
+	_due.erase(begin(_due), begin(_due) + till);
+	_dueRemoved = 0;
+	for (auto i = 0; i != int(_due.size()); ++i) {
+		if (_due[i] >= 0) {
+			_entries[_due[i]].index = i;
+		} else {
+			++_dueRemoved;
+		}
+	}
+}
+
+template <typename Value>
+int timer_wheel<Value>::allocate(std::int64_t when, Value &&value) {
+	auto handle = int(_entries.size());
+	if (_freeEntries.empty()) {
+		_entries.emplace_back();
+	} else {
+		handle = _freeEntries.back();
+		_freeEntries.pop_back();
+	}
+	auto &entry = _entries[handle];
+	entry.when = when;
+	entry.value = std::move(value);
+	return handle;
+}
+
+template <typename Value>
+void timer_wheel<Value>::release(int handle) {
+	auto &entry = _entries[handle];
+	entry.value = Value();
+	entry.level = -1;
+	_freeEntries.push_back(handle);
+}
+
+template <typename Value>
+void timer_wheel<Value>::place(int handle) {
+	auto &entry = _entries[handle];
+	if (entry.when <= _now) {
+		entry.level = kDue;
+		entry.index = int(_due.size());
+		_due.push_back(handle);
+		return;
+	}
+	const auto delta = entry.when - _now;
+	auto level = 0;
+	while (level + 1 < kLevels && delta >= Granularity(level + 1)) {
+		++level;
+	}
+
+	// Entries beyond the last level wait in its farthest bucket.
+	const auto when = std::min(
+		entry.when,
+		_now + Granularity(kLevels) - 1);
+	const auto slot = int((when >> (level * kSlotShift)) & (kSlots - 1));
+	auto &bucket = _buckets[level][slot];
+	entry.level = level;
+	entry.slot = slot;
+	entry.index = int(bucket.size());
+	bucket.push_back(handle);
+	_occupied[level] |= (std::uint64_t(1) << slot);
+}
+
+template <typename Value>
+void timer_wheel<Value>::unlink(int handle) {
+	auto &entry = _entries[handle];
+	if (entry.level == kDue) {
+		_due[entry.index] = -1;
+		++_dueRemoved;
+		return;
+	}
+	auto &bucket = _buckets[entry.level][entry.slot];
+	const auto moved = bucket.back();
+	bucket[entry.index] = moved;
+	_entries[moved].index = entry.index;
+	bucket.pop_back();
+	if (bucket.empty()) {
+		_occupied[entry.level] &= ~(std::uint64_t(1) << entry.slot);
+	}
+}
+
+template <typename Value>
+void timer_wheel<Value>::cascade(
+		int level,
+		std::int64_t from,
+		std::int64_t till) {
+	// Visit every bucket the wheel entered at this level on (from, till].
+	const auto shift = level * kSlotShift;
+	const auto passed = (till >> shift) - (from >> shift);
+	const auto count = int(std::min(passed, std::int64_t(kSlots)));
+	for (auto i = 0; i != count; ++i) {
+		const auto slot = int(((from >> shift) + 1 + i) & (kSlots - 1));
+		if (!(_occupied[level] & (std::uint64_t(1) << slot))) {
+			continue;
+		}
+		auto bucket = std::move(_buckets[level][slot]);
+		_buckets[level][slot] = Bucket();
+		_occupied[level] &= ~(std::uint64_t(1) << slot);
+		for (const auto handle : bucket) {
+			place(handle);
+		}
+	}
+}
+
+template <typename Value>
+std::int64_t timer_wheel<Value>::earliestIn(int level) const {
+	const auto occupied = _occupied[level];
+	if (!occupied) {
+		return -1;
+	}
+
+	// Buckets are checked starting from the one after the current.
+	const auto shift = level * kSlotShift;
+	const auto current = int((_now >> shift) & (kSlots - 1));
+	for (auto i = 1; i <= kSlots; ++i) {
+		const auto slot = (current + i) & (kSlots - 1);
+		if (!(occupied & (std::uint64_t(1) << slot))) {
+			continue;
+		}
+		auto result = std::numeric_limits<std::int64_t>::max();
+		for (const auto handle : _buckets[level][slot]) {
+			result = std::min(result, _entries[handle].when);
+		}
+
+		// Entries are moved down when their bucket starts.
+		const auto starts = ((_now >> shift) + i) << shift;
+		return std::max(starts, std::min(result, starts + Granularity(level)));
+	}
+	return -1;
+}
+
+} // namespace base
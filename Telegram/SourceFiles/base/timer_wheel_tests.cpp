@@ -0,0 +1,140 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "base/timer_wheel.h"
+#include <map>
+#include <random>
+
+using Wheel = base::timer_wheel<int>;
+
+TEST_CASE("timer_wheel should fire entries in time", "[timer_wheel]") {
+	auto wheel = Wheel(1000);
+	auto fired = std::vector<int>();
+	const auto advance = [&](std::int64_t now) {
+		wheel.advance(now, [&](int value) {
+			fired.push_back(value);
+		});
+	};
+	REQUIRE(wheel.empty());
+	REQUIRE(wheel.next() == -1);
+
+	wheel.add(1010, 1);
+	wheel.add(1005, 2);
+	wheel.add(6000, 3);
+	wheel.add(1000, 4);
+	REQUIRE(wheel.next() == 1000);
+
+	advance(1000);
+	REQUIRE(fired == std::vector<int>{ 4 });
+	REQUIRE(wheel.next() == 1005);
+
+	advance(1009);
+	REQUIRE(fired == std::vector<int>{ 4, 2 });
+	REQUIRE(wheel.next() == 1010);
+
+	SECTION("late advance fires in the deadline order") {
+		advance(10000);
+		REQUIRE(fired == std::vector<int>{ 4, 2, 1, 3 });
+		REQUIRE(wheel.empty());
+	}
+	SECTION("removed entries don't fire") {
+		const auto handle = wheel.add(2000, 5);
+		wheel.remove(handle);
+		advance(3000);
+		REQUIRE(fired == std::vector<int>{ 4, 2, 1 });
+		REQUIRE(wheel.next() == 6000);
+	}
+}
+
+TEST_CASE("timer_wheel should allow changes while firing", "[timer_wheel]") {
+	auto wheel = Wheel(0);
+	auto fired = std::vector<int>();
+	wheel.add(10, 1);
+	const auto second = wheel.add(10, 2);
+	wheel.add(10, 3);
+
+	wheel.advance(10, [&](int value) {
+		fired.push_back(value);
+		if (value == 1) {
+			wheel.remove(second);
+			wheel.add(10, 10);
+			wheel.add(20, 100);
+		}
+	});
+	REQUIRE(fired == std::vector<int>{ 1, 3 });
+	REQUIRE(wheel.next() == 10);
+
+	wheel.advance(20, [&](int value) {
+		fired.push_back(value);
+	});
+	REQUIRE(fired == std::vector<int>{ 1, 3, 10, 100 });
+	REQUIRE(wheel.empty());
+}
+
+TEST_CASE("timer_wheel should match a sorted map", "[timer_wheel]") {
+	auto generator = std::mt19937(42);
+	auto delays = std::uniform_int_distribution<int>(0, 1 << 26);
+	auto small = std::uniform_int_distribution<int>(0, 300);
+	auto steps = std::uniform_int_distribution<int>(0, 1 << 20);
+
+	auto now = std::int64_t(123456789);
+	auto wheel = Wheel(now);
+	auto expected = std::multimap<std::int64_t, int>();
+	auto handles = std::map<int, int>();
+	auto matched = true;
+	for (auto i = 0; i != 20000; ++i) {
+		const auto when = now + ((i % 2) ? small(generator) : delays(generator));
+		handles.emplace(i, wheel.add(when, i));
+		expected.emplace(when, i);
+		if (i % 7 == 0) {
+			const auto value = i / 2;
+			const auto found = handles.find(value);
+			if (found != handles.end()) {
+				wheel.remove(found->second);
+				handles.erase(found);
+				for (auto j = expected.begin(); j != expected.end(); ++j) {
+					if (j->second == value) {
+						expected.erase(j);
+						break;
+					}
+				}
+			}
+		}
+		if (i % 3 == 0) {
+			const auto next = wheel.next();
+			if (!expected.empty()) {
+				if (next < 0 || next > expected.begin()->first) {
+					matched = false;
+				}
+			}
+			now += (i % 2) ? small(generator) : steps(generator);
+			wheel.advance(now, [&](int value) {
+				const auto first = expected.begin();
+				if (first->first > now || first->second != value) {
+					const auto j = std::find_if(
+						expected.begin(),
+						expected.upper_bound(now),
+						[&](const auto &pair) { return pair.second == value; });
+					if (j == expected.upper_bound(now)) {
+						matched = false;
+						return;
+					}
+					expected.erase(j);
+				} else {
+					expected.erase(first);
+				}
+				handles.erase(value);
+			});
+			if (!expected.empty() && expected.begin()->first <= now) {
+				matched = false;
+			}
+		}
+	}
+	REQUIRE(matched);
+}
@@ -740,43 +740,12 @@ void ShareBox::Inner::updateFilter(QString filter) {
 		if (_filter.isEmpty()) {
 			refresh();
 		} else {
-			QStringList::const_iterator fb = words.cbegin(), fe = words.cend(), fi;
-
 			_filtered.clear();
 			if (!words.isEmpty()) {
-				const Dialogs::List *toFilter = nullptr;
-				if (!_chatsIndexed->isEmpty()) {
-					for (fi = fb; fi != fe; ++fi) {
-						auto found = _chatsIndexed->filtered(fi->at(0));
-						if (found->isEmpty()) {
-							toFilter = nullptr;
-							break;
-						}
-						if (!toFilter || toFilter->size() > found->size()) {
-							toFilter = found;
-						}
-					}
-				}
-				if (toFilter) {
-					_filtered.reserve(toFilter->size());
-					for (const auto row : *toFilter) {
-						auto &nameWords = row->entry()->chatsListNameWords();
-						auto nb = nameWords.cbegin(), ne = nameWords.cend(), ni = nb;
-						for (fi = fb; fi != fe; ++fi) {
-							auto filterName = *fi;
-							for (ni = nb; ni != ne; ++ni) {
-								if (ni->startsWith(*fi)) {
-									break;
-								}
-							}
-							if (ni == ne) {
-								break;
-							}
-						}
-						if (fi == fe) {
-							_filtered.push_back(row);
-						}
-					}
+				const auto found = _chatsIndexed->filtered(words);
+				_filtered.reserve(found.size());
+				for (const auto row : found) {
+					_filtered.push_back(row);
 				}
 			}
 			refresh();
@@ -124,7 +124,8 @@ GifsListWidget::GifsListWidget(
 	QWidget *parent,
 	not_null<Window::Controller*> controller)
 : Inner(parent, controller)
-, _section(Section::Gifs) {
+, _section(Section::Gifs)
+, _prefetch(st::emojiPanMaxHeight - st::emojiFooterHeight) {
 	setMouseTracking(true);
 	setAttribute(Qt::WA_OpaquePaintEvent);
 
@@ -167,6 +168,9 @@ void GifsListWidget::visibleTopBottomUpdated(
 		_lastScrolled = getms();
 	}
 	checkLoadMore();
+
+	_prefetch.scrolled(visibleTop, visibleBottom);
+	preloadAreas(true);
 }
 
 void GifsListWidget::checkLoadMore() {
@@ -401,6 +405,7 @@ TabbedSelector::InnerFooter *GifsListWidget::getFooter() const {
 
 void GifsListWidget::processHideFinished() {
 	clearSelection();
+	_prefetch.finish();
 }
 
 void GifsListWidget::processPanelHideFinished() {
@@ -610,10 +615,49 @@ void GifsListWidget::layoutInlineRow(Row &row, int fullWidth) {
 }
 
 void GifsListWidget::preloadImages() {
-	for (auto row = 0, rows = _rows.size(); row != rows; ++row) {
-		for (auto col = 0, cols = _rows[row].items.size(); col != cols; ++col) {
-			_rows[row].items[col]->preload();
+	preloadAreas(false);
+}
+
+template <typename Callback>
+void GifsListWidget::enumerateAreaItems(
+		ThumbnailsPrefetch::Area area,
+		Callback callback) const {
+	auto top = st::stickerPanPadding;
+	for (const auto &row : _rows) {
+		if (top >= area.bottom) {
+			break;
+		} else if (top + row.height > area.top) {
+			for (const auto item : row.items) {
+				callback(item);
+			}
 		}
+		top += row.height;
+	}
+}
+
+void GifsListWidget::preloadAreas(bool countShown) {
+	auto items = std::vector<LayoutItem*>();
+	const auto areas = _prefetch.prepareAreas();
+	for (auto i = 0, count = int(areas.size()); i != count; ++i) {
+		enumerateAreaItems(areas[i], [&](LayoutItem *item) {
+			if (countShown && !i) {
+				_prefetch.shown(item, item->preloaded());
+			}
+			items.push_back(item);
+		});
+	}
+	if (!_prefetch.request(items)) {
+		return;
+	}
+	for (const auto &row : _rows) {
+		for (const auto item : row.items) {
+			if (_prefetch.left(item)) {
+				item->pausePreload();
+			}
+		}
+	}
+	for (const auto item : items) {
+		item->preload();
 	}
 }
 
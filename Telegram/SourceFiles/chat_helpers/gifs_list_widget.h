@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "chat_helpers/tabbed_selector.h"
+#include "chat_helpers/thumbnails_prefetch.h"
 #include "inline_bots/inline_bot_layout_item.h"
 
 namespace InlineBots {
@@ -119,9 +120,15 @@ private:
 
 	void updateSelected();
 	void paintInlineItems(Painter &p, QRect clip);
+	void preloadAreas(bool countShown);
+	template <typename Callback>
+	void enumerateAreaItems(
+		ThumbnailsPrefetch::Area area,
+		Callback callback) const;
 
 	Section _section = Section::Gifs;
 	TimeMs _lastScrolled = 0;
+	ThumbnailsPrefetch _prefetch;
 	QTimer _updateInlineItems;
 	bool _inlineWithThumb = false;
 
@@ -681,6 +681,7 @@ StickersListWidget::StickersListWidget(QWidget *parent, not_null<Window::Control
 , _addText(lang(lng_stickers_featured_add).toUpper())
 , _addWidth(st::stickersTrendingAdd.font->width(_addText))
 , _settings(this, lang(lng_stickers_you_have))
+, _prefetch(st::emojiPanMaxHeight - st::emojiFooterHeight)
 , _searchRequestTimer([=] { sendSearchRequest(); }) {
 	setMouseTracking(true);
 	setAttribute(Qt::WA_OpaquePaintEvent);
@@ -717,6 +718,9 @@ void StickersListWidget::visibleTopBottomUpdated(
 		readVisibleSets();
 	}
 	validateSelectedIcon(ValidateIconAnimations::Full);
+
+	_prefetch.scrolled(visibleTop, visibleBottom);
+	preloadAreas(true);
 }
 
 void StickersListWidget::readVisibleSets() {
@@ -1663,6 +1667,7 @@ TabbedSelector::InnerFooter *StickersListWidget::getFooter() const {
 
 void StickersListWidget::processHideFinished() {
 	clearSelection();
+	_prefetch.finish();
 }
 
 void StickersListWidget::processPanelHideFinished() {
@@ -1757,24 +1762,68 @@ void StickersListWidget::refreshFooterIcons() {
 }
 
 void StickersListWidget::preloadImages() {
-	auto &sets = shownSets();
-	for (int i = 0, l = sets.size(), k = 0; i < l; ++i) {
-		int count = sets[i].pack.size();
-		if (sets[i].externalLayout) {
-			accumulate_min(count, _columnCount);
-		}
-		for (int j = 0; j != count; ++j) {
-			if (++k > _columnCount * (_columnCount + 1)) break;
+	preloadAreas(false);
+	if (_footer) {
+		_footer->preloadImages();
+	}
+}
 
-			const auto document = sets[i].pack[j];
-			if (!document || !document->sticker()) continue;
+template <typename Callback>
+void StickersListWidget::enumerateAreaStickers(
+		ThumbnailsPrefetch::Area area,
+		Callback callback) const {
+	const auto &sets = shownSets();
+	enumerateSections([&](const SectionInfo &info) {
+		if (area.top >= info.rowsBottom) {
+			return true;
+		} else if (area.bottom <= info.rowsTop) {
+			return false;
+		}
+		const auto &set = sets[info.section];
+		const auto count = set.externalLayout
+			? std::min(info.count, _columnCount)
+			: info.count;
+		const auto rowHeight = _singleSize.height();
+		const auto fromRow = floorclamp(area.top - info.rowsTop, rowHeight, 0, info.rowsCount);
+		const auto toRow = ceilclamp(area.bottom - info.rowsTop, rowHeight, 0, info.rowsCount);
+		const auto till = std::min(toRow * _columnCount, count);
+		for (auto index = fromRow * _columnCount; index < till; ++index) {
+			const auto document = set.pack[index];
+			if (document && document->sticker()) {
+				callback(document);
+			}
+		}
+		return true;
+	});
+}
 
-			document->checkStickerThumb();
+void StickersListWidget::preloadAreas(bool countShown) {
+	if (_singleSize.isEmpty()) {
+		return;
+	}
+	auto documents = std::vector<DocumentData*>();
+	const auto areas = _prefetch.prepareAreas();
+	for (auto i = 0, count = int(areas.size()); i != count; ++i) {
+		enumerateAreaStickers(areas[i], [&](DocumentData *document) {
+			if (countShown && !i) {
+				const auto image = document->getStickerThumb();
+				_prefetch.shown(document, image && image->loaded());
+			}
+			documents.push_back(document);
+		});
+	}
+	if (!_prefetch.request(documents)) {
+		return;
+	}
+	for (const auto &set : shownSets()) {
+		for (const auto document : set.pack) {
+			if (document && _prefetch.left(document)) {
+				document->pauseStickerThumb();
+			}
 		}
-		if (k > _columnCount * (_columnCount + 1)) break;
 	}
-	if (_footer) {
-		_footer->preloadImages();
+	for (const auto document : documents) {
+		document->checkStickerThumb();
 	}
 }
 
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "chat_helpers/tabbed_selector.h"
 #include "chat_helpers/stickers.h"
+#include "chat_helpers/thumbnails_prefetch.h"
 #include "base/variant.h"
 #include "base/timer.h"
 
@@ -203,6 +204,11 @@ private:
 	const std::vector<Set> &shownSets() const;
 	int featuredRowHeight() const;
 	void readVisibleSets();
+	void preloadAreas(bool countShown);
+	template <typename Callback>
+	void enumerateAreaStickers(
+		ThumbnailsPrefetch::Area area,
+		Callback callback) const;
 
 	void paintFeaturedStickers(Painter &p, QRect clip);
 	void paintStickers(Painter &p, QRect clip);
@@ -284,6 +290,8 @@ private:
 	QTimer _previewTimer;
 	bool _previewShown = false;
 
+	ThumbnailsPrefetch _prefetch;
+
 	std::map<QString, std::vector<uint64>> _searchCache;
 	std::vector<std::pair<uint64, QStringList>> _searchIndex;
 	base::Timer _searchRequestTimer;
@@ -0,0 +1,132 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "chat_helpers/thumbnails_prefetch.h"
+
+namespace ChatHelpers {
+namespace {
+
+// If the panel wasn't scrolled for that long, the scroll has stopped.
+constexpr auto kVelocityTimeout = TimeMs(200);
+
+// How far ahead we predict with the current velocity.
+constexpr auto kPredictTime = TimeMs(500);
+
+// Limits of the predicted part in visible heights.
+constexpr auto kMinAheadScreens = 1;
+constexpr auto kMaxAheadScreens = 5;
+
+} // namespace
+
+ThumbnailsPrefetch::ThumbnailsPrefetch(int minimalHeight)
+: _minimalHeight(minimalHeight) {
+}
+
+void ThumbnailsPrefetch::scrolled(int visibleTop, int visibleBottom) {
+	const auto now = getms();
+	const auto delta = visibleTop - _visibleTop;
+	const auto elapsed = now - _lastScrolled;
+	if (delta != 0) {
+		if (elapsed > 0 && elapsed < kVelocityTimeout) {
+			// Smooth the velocity, scroll events come unevenly.
+			const auto current = delta / float64(elapsed);
+			_velocity = (_velocity + current) / 2.;
+		} else {
+			_velocity = 0.;
+		}
+		_direction = (delta > 0) ? 1 : -1;
+		_lastScrolled = now;
+	} else if (elapsed >= kVelocityTimeout) {
+		_velocity = 0.;
+	}
+	_visibleTop = visibleTop;
+	_visibleBottom = visibleBottom;
+}
+
+auto ThumbnailsPrefetch::prepareAreas() const -> std::vector<Area> {
+	const auto height = std::max(
+		_visibleBottom - _visibleTop,
+		_minimalHeight);
+	if (height <= 0) {
+		return {};
+	}
+	const auto ahead = snap(
+		int(std::abs(_velocity) * kPredictTime),
+		height * kMinAheadScreens,
+		height * kMaxAheadScreens);
+	const auto behind = height / 2;
+	const auto top = _visibleTop;
+	const auto bottom = _visibleTop + height;
+
+	auto result = std::vector<Area>();
+	result.reserve(kMaxAheadScreens + 2);
+	result.push_back({ top, bottom });
+	for (auto skip = 0; skip < ahead; skip += height) {
+		const auto size = std::min(height, ahead - skip);
+		if (_direction > 0) {
+			result.push_back({ bottom + skip, bottom + skip + size });
+		} else {
+			result.push_back({ top - skip - size, top - skip });
+		}
+	}
+	if (_direction > 0) {
+		result.push_back({ top - behind, top });
+	} else {
+		result.push_back({ bottom, bottom + behind });
+	}
+	return result;
+}
+
+bool ThumbnailsPrefetch::requestKeys(std::vector<const void*> &&keys) {
+	if (keys == _requested) {
+		return false;
+	}
+	auto now = base::flat_set<const void*>();
+	for (const auto key : keys) {
+		now.emplace(key);
+	}
+	_left.clear();
+	for (const auto key : _requested) {
+		if (!now.contains(key)) {
+			_left.emplace(key);
+		}
+	}
+	_requested = std::move(keys);
+	return true;
+}
+
+bool ThumbnailsPrefetch::left(const void *key) const {
+	return _left.contains(key);
+}
+
+void ThumbnailsPrefetch::shown(const void *key, bool loaded) {
+	if (_counted.contains(key)) {
+		return;
+	}
+	_counted.emplace(key);
+	++_shownCount;
+	if (loaded) {
+		++_hitsCount;
+	}
+}
+
+void ThumbnailsPrefetch::finish() {
+	if (_shownCount > 0) {
+		DEBUG_LOG(("Thumbnails Prefetch: %1 of %2 shown thumbnails "
+			"were loaded (%3%)."
+			).arg(_hitsCount
+			).arg(_shownCount
+			).arg(_hitsCount * 100 / _shownCount));
+	}
+	_shownCount = _hitsCount = 0;
+	_counted.clear();
+	_requested.clear();
+	_left.clear();
+	_velocity = 0.;
+}
+
+} // namespace ChatHelpers
@@ -0,0 +1,85 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace ChatHelpers {
+
+// Predicts the part of a scrolled panel that will be visible soon from
+// the recent scroll velocity, so that the thumbnails there are requested
+// before they're painted.
+class ThumbnailsPrefetch {
+public:
+	struct Area {
+		int top = 0;
+		int bottom = 0;
+	};
+
+	// The visible height is at least minimalHeight,
+	// so that a hidden panel could preload its first screen.
+	explicit ThumbnailsPrefetch(int minimalHeight);
+
+	void scrolled(int visibleTop, int visibleBottom);
+
+	// The visible area first, then the predicted areas in the scroll
+	// direction, nearest first, then a small area behind.
+	std::vector<Area> prepareAreas() const;
+
+	// Takes the keys found in the prepared areas in priority order and
+	// drops the repeated ones. Returns false if they are the same as the
+	// last time, then the loads shouldn't be requested again.
+	//
+	// Otherwise the loads of the keys that left the areas should be
+	// paused and the loads of the keys requested again in this order.
+	// This way only the loads of this panel are reordered.
+	template <typename Key>
+	bool request(std::vector<Key*> &keys) {
+		auto unique = base::flat_set<const void*>();
+		keys.erase(std::remove_if(keys.begin(), keys.end(), [&](Key *key) {
+			if (unique.contains(key)) {
+				return true;
+			}
+			unique.emplace(key);
+			return false;
+		}), keys.end());
+		return requestKeys(std::vector<const void*>(keys.begin(), keys.end()));
+	}
+
+	// Whether the key was requested before the last changed request(),
+	// but is not in the areas any more.
+	bool left(const void *key) const;
+
+	// Counts a thumbnail in the visible area. The hit rate is the share
+	// of thumbnails that were already loaded when they became visible,
+	// each thumbnail is counted once until finish().
+	void shown(const void *key, bool loaded);
+
+	// Writes the hit rate to the log and starts counting again.
+	void finish();
+
+private:
+	bool requestKeys(std::vector<const void*> &&keys);
+
+	int _minimalHeight = 0;
+	int _visibleTop = 0;
+	int _visibleBottom = 0;
+	TimeMs _lastScrolled = 0;
+
+	// Pixels per millisecond, positive when scrolling down.
+	float64 _velocity = 0.;
+	int _direction = 1;
+
+	std::vector<const void*> _requested;
+	base::flat_set<const void*> _left;
+
+	base::flat_set<const void*> _counted;
+	int _shownCount = 0;
+	int _hitsCount = 0;
+
+};
+
+} // namespace ChatHelpers
@@ -91,6 +91,32 @@ QString stringToBinaryArray(const std::string &str) {
 	return QString("{") + ((rows.size() > 1) ? '\n' : ' ') + rows.join(",\n") + " }";
 }
 
+// Increment when the format of the parsed values changes, for example
+// the tag replacements written by ValueParser in lang_instance.cpp.
+constexpr auto kValueFormatVersion = 1;
+
+// FNV-1a of everything the parsed values depend on: the value format,
+// key indices and tags.
+quint32 countKeysChecksum(const LangPack &langpack) {
+	auto result = quint32(2166136261U);
+	auto add = [&result](const QString &value) {
+		for (auto ch : value.toUtf8() + '\n') {
+			result = (result ^ uchar(ch)) * 16777619U;
+		}
+	};
+	add(QString::number(kValueFormatVersion));
+	for (auto &tag : langpack.tags) {
+		add(tag.tag);
+	}
+	for (auto &entry : langpack.entries) {
+		add(entry.key);
+		for (auto &tag : entry.tags) {
+			add(tag.tag);
+		}
+	}
+	return result;
+}
+
 } // namespace
 
 Generator::Generator(const LangPack &langpack, const QString &destBasePath, const common::ProjectInfo &project)
@@ -169,6 +195,7 @@ ushort GetTagIndex(QLatin1String tag);\n\
 LangKey GetKeyIndex(QLatin1String key);\n\
 bool IsTagReplaced(LangKey key, ushort tag);\n\
 QString GetOriginalValue(LangKey key);\n\
+uint32 GetKeysChecksum();\n\
 \n";
 
 	return header_->finalize();
@@ -324,6 +351,10 @@ QString GetOriginalValue(LangKey key) {\n\
 	auto offset = Offsets[key];\n\
 	return QString::fromRawData(DefaultData + offset, Offsets[key + 1] - offset);\n\
 }\n\
+\n\
+uint32 GetKeysChecksum() {\n\
+	return " << countKeysChecksum(langpack_) << "U;\n\
+}\n\
 \n";
 
 	return source_->finalize();
@@ -152,6 +152,9 @@ void SignalHandler(int signum) {
 	QMutexLocker lock(&ReportingMutex);
 	ReportingThreadId = thread;
 
+	// Try to write the debug lines queued before the crash.
+	Logs::flush();
+
 	if (!ReportingHeaderWritten) {
 		ReportingHeaderWritten = true;
 		auto dec2hex = [](int value) -> char {
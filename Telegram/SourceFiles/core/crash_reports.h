@@ -64,6 +64,7 @@ inline void log(const char *message, const char *file, int line) {
 
 #ifdef LOG
 	LOG((entry));
+	Logs::flush();
 #endif // LOG
 
 	CrashReports::SetAnnotation("Assertion", info);
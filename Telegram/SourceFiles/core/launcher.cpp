@@ -12,6 +12,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_reports.h"
 #include "core/main_queue_processor.h"
 #include "core/update_checker.h"
+#include "core/startup_trace.h"
+#include "core/updates_replay.h"
 #include "base/concurrent_timer.h"
 #include "application.h"
 
@@ -56,8 +58,12 @@ int Launcher::exec() {
 	}
 
 	// both are finished in Application::closeApplication
-	Logs::start(this); // must be started before Platform is started
-	Platform::start(); // must be started before QApplication is created
+	TraceStartupPhase("Logs::start", [&] {
+		Logs::start(this); // must be started before Platform is started
+	});
+	TraceStartupPhase("Platform::start", [] {
+		Platform::start(); // must be started before QApplication is created
+	});
 
 	auto result = executeApplication();
 
@@ -190,6 +196,9 @@ void Launcher::processArguments() {
 		{ "-startintray"    , KeyFormat::NoValues },
 		{ "-sendpath"       , KeyFormat::AllLeftValues },
 		{ "-workdir"        , KeyFormat::OneValue },
+		{ "-tracestartup"   , KeyFormat::NoValues },
+		{ "-recordupdates"  , KeyFormat::NoValues },
+		{ "-replayupdates"  , KeyFormat::OneValue },
 		{ "--"              , KeyFormat::OneValue },
 	};
 	auto parseResult = QMap<QByteArray, QStringList>();
@@ -220,6 +229,14 @@ void Launcher::processArguments() {
 	}
 	gTestMode = parseResult.contains("-testmode");
 	Logs::SetDebugEnabled(parseResult.contains("-debug"));
+	if (parseResult.contains("-tracestartup")) {
+		StartStartupTrace();
+	}
+	if (parseResult.contains("-recordupdates")) {
+		StartUpdatesRecord();
+	}
+	SetUpdatesReplayPath(
+		parseResult.value("-replayupdates", {}).join(QString()));
 	gManyInstance = parseResult.contains("-many");
 	gKeyFile = parseResult.value("-key", {}).join(QString()).toLower();
 	gKeyFile = gKeyFile.replace(QRegularExpression("[^a-z0-9\\-_]"), {});
@@ -0,0 +1,101 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/startup_trace.h"
+
+#include <chrono>
+
+namespace Core {
+namespace {
+
+struct Event {
+	const char *name = nullptr;
+	int64 started = 0;
+	int64 duration = 0;
+	quintptr thread = 0;
+};
+
+std::atomic<bool> Enabled = false;
+int64 Origin = 0;
+QMutex EventsMutex;
+std::vector<Event> Events;
+
+int64 Now() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+		steady_clock::now().time_since_epoch()).count();
+}
+
+QByteArray Serialize(const std::vector<Event> &events) {
+	auto list = QJsonArray();
+	for (const auto &event : events) {
+		auto object = QJsonObject();
+		object.insert(qsl("name"), QString::fromLatin1(event.name));
+		object.insert(qsl("cat"), qsl("startup"));
+		object.insert(qsl("ph"), qsl("X"));
+		object.insert(qsl("ts"), double(event.started - Origin));
+		object.insert(qsl("dur"), double(event.duration));
+		object.insert(qsl("pid"), 1);
+		object.insert(qsl("tid"), double(event.thread));
+		list.append(object);
+	}
+	auto result = QJsonObject();
+	result.insert(qsl("traceEvents"), list);
+	result.insert(qsl("displayTimeUnit"), qsl("ms"));
+	return QJsonDocument(result).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+void StartStartupTrace() {
+	Origin = Now();
+	Enabled = true;
+}
+
+void FinishStartupTrace() {
+	if (!Enabled.exchange(false)) {
+		return;
+	}
+	auto events = [&] {
+		QMutexLocker lock(&EventsMutex);
+		return base::take(Events);
+	}();
+
+	const auto folder = cWorkingDir() + qsl("DebugLogs/");
+	QDir().mkpath(folder);
+	auto file = QFile(folder + qsl("startup_trace.json"));
+	if (!file.open(QIODevice::WriteOnly)) {
+		LOG(("Startup Trace Error: Could not open '%1' for writing."
+			).arg(file.fileName()));
+		return;
+	}
+	file.write(Serialize(events));
+	LOG(("Startup Trace: %1 phases written to '%2'."
+		).arg(events.size()
+		).arg(file.fileName()));
+}
+
+StartupPhase::StartupPhase(const char *name)
+: _name(name)
+, _started(Enabled ? Now() : 0) {
+}
+
+StartupPhase::~StartupPhase() {
+	if (!_started || !Enabled) {
+		return;
+	}
+	auto event = Event();
+	event.name = _name;
+	event.started = _started;
+	event.duration = Now() - _started;
+	event.thread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+	QMutexLocker lock(&EventsMutex);
+	Events.push_back(event);
+}
+
+} // namespace Core
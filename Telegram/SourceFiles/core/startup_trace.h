@@ -0,0 +1,37 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Core {
+
+// When launched with -tracestartup the timings of the startup phases are
+// recorded and written to DebugLogs/startup_trace.json in Chrome trace
+// format, it can be opened in chrome://tracing. Phases may be nested.
+void StartStartupTrace();
+void FinishStartupTrace();
+
+class StartupPhase {
+public:
+	explicit StartupPhase(const char *name);
+	StartupPhase(const StartupPhase &other) = delete;
+	StartupPhase &operator=(const StartupPhase &other) = delete;
+	~StartupPhase();
+
+private:
+	const char *_name = nullptr;
+	int64 _started = 0;
+
+};
+
+template <typename Callback>
+inline auto TraceStartupPhase(const char *name, Callback &&callback) {
+	const auto phase = StartupPhase(name);
+	return callback();
+}
+
+} // namespace Core
@@ -0,0 +1,315 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/updates_replay.h"
+
+#include "mainwidget.h"
+#include <chrono>
+
+namespace Core {
+namespace {
+
+constexpr auto kRecordMagic = "TGUR";
+constexpr auto kRecordVersion = 1;
+constexpr auto kMaxRecordPrimes = 64 * 1024 * 1024;
+
+struct Record {
+	UpdatesRecordType type = UpdatesRecordType();
+	ChannelId channelId = NoChannel;
+	mtpBuffer data;
+};
+
+struct StageStats {
+	int count = 0;
+	int64 duration = 0;
+};
+
+struct Replay {
+	std::vector<Record> records;
+	int index = 0;
+	int updates = 0;
+	int64 duration = 0;
+	int64 started = 0;
+};
+
+std::atomic<bool> Recording = false;
+std::unique_ptr<QFile> RecordFile;
+
+QString ReplayPath;
+bool ReplayActive = false;
+std::map<QByteArray, StageStats> Stages;
+
+int64 Now() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+		steady_clock::now().time_since_epoch()).count();
+}
+
+QString FormatDuration(int64 duration) {
+	return QString::number(duration / 1000., 'f', 3) + qsl(" ms");
+}
+
+bool OpenRecordFile() {
+	const auto folder = cWorkingDir() + qsl("DebugLogs/");
+	QDir().mkpath(folder);
+	RecordFile = std::make_unique<QFile>(folder + qsl("updates_record.bin"));
+	if (!RecordFile->open(QIODevice::WriteOnly)) {
+		LOG(("Updates Record Error: Could not open '%1' for writing."
+			).arg(RecordFile->fileName()));
+		RecordFile = nullptr;
+		return false;
+	}
+	QDataStream stream(RecordFile.get());
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream.writeRawData(kRecordMagic, 4);
+	stream << qint32(kRecordVersion);
+	LOG(("Updates Record: Writing to '%1'.").arg(RecordFile->fileName()));
+	return true;
+}
+
+std::vector<Record> ReadRecords(const QString &path) {
+	auto file = QFile(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		LOG(("Updates Replay Error: Could not open '%1'.").arg(path));
+		return {};
+	}
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	char magic[4] = { 0 };
+	auto version = qint32();
+	stream.readRawData(magic, 4);
+	stream >> version;
+	if (memcmp(magic, kRecordMagic, 4) || version != kRecordVersion) {
+		LOG(("Updates Replay Error: Bad file '%1'.").arg(path));
+		return {};
+	}
+	auto result = std::vector<Record>();
+	while (!stream.atEnd()) {
+		auto type = qint32();
+		auto channelId = qint32();
+		auto size = qint32();
+		stream >> type >> channelId >> size;
+		if (stream.status() != QDataStream::Ok
+			|| size < 0
+			|| size > kMaxRecordPrimes) {
+			LOG(("Updates Replay Error: Bad record %1 in '%2'."
+				).arg(int(result.size())
+				).arg(path));
+			return {};
+		}
+		auto record = Record();
+		record.type = static_cast<UpdatesRecordType>(type);
+		record.channelId = channelId;
+		record.data.resize(size);
+		const auto bytes = size * int(sizeof(mtpPrime));
+		if (stream.readRawData(
+				reinterpret_cast<char*>(record.data.data()),
+				bytes) != bytes) {
+			LOG(("Updates Replay Error: Unexpected end of '%1'."
+				).arg(path));
+			return {};
+		}
+		result.push_back(std::move(record));
+	}
+	return result;
+}
+
+int CountUpdates(const MTPUpdates &updates) {
+	switch (updates.type()) {
+	case mtpc_updates: return updates.c_updates().vupdates.v.size();
+	case mtpc_updatesCombined:
+		return updates.c_updatesCombined().vupdates.v.size();
+	case mtpc_updatesTooLong: return 0;
+	}
+	return 1;
+}
+
+int CountUpdates(const MTPupdates_Difference &difference) {
+	switch (difference.type()) {
+	case mtpc_updates_difference: {
+		const auto &data = difference.c_updates_difference();
+		return data.vnew_messages.v.size() + data.vother_updates.v.size();
+	} break;
+	case mtpc_updates_differenceSlice: {
+		const auto &data = difference.c_updates_differenceSlice();
+		return data.vnew_messages.v.size() + data.vother_updates.v.size();
+	} break;
+	}
+	return 0;
+}
+
+int CountUpdates(const MTPupdates_ChannelDifference &difference) {
+	switch (difference.type()) {
+	case mtpc_updates_channelDifference: {
+		const auto &data = difference.c_updates_channelDifference();
+		return data.vnew_messages.v.size() + data.vother_updates.v.size();
+	} break;
+	case mtpc_updates_channelDifferenceTooLong:
+		return difference.c_updates_channelDifferenceTooLong().vmessages.v.size();
+	}
+	return 0;
+}
+
+// Returns the count of the fed updates, throws mtpErrorUnexpected.
+int FeedRecord(not_null<MainWidget*> main, const Record &record) {
+	auto from = record.data.constData();
+	const auto end = from + record.data.size();
+	switch (record.type) {
+	case UpdatesRecordType::State: {
+		auto state = MTPupdates_State();
+		state.read(from, end);
+		TraceUpdatesStage("gotState", [&] {
+			main->gotState(state);
+		});
+		return 0;
+	} break;
+	case UpdatesRecordType::Updates: {
+		auto updates = MTPUpdates();
+		updates.read(from, end);
+		TraceUpdatesStage("feedUpdates", [&] {
+			main->feedUpdates(updates);
+		});
+		return CountUpdates(updates);
+	} break;
+	case UpdatesRecordType::Difference: {
+		auto difference = MTPupdates_Difference();
+		difference.read(from, end);
+		TraceUpdatesStage("gotDifference", [&] {
+			main->gotDifference(difference);
+		});
+		return CountUpdates(difference);
+	} break;
+	case UpdatesRecordType::ChannelDifference: {
+		auto difference = MTPupdates_ChannelDifference();
+		difference.read(from, end);
+		const auto channel = App::channel(record.channelId);
+		TraceUpdatesStage("gotChannelDifference", [&] {
+			main->gotChannelDifference(channel, difference);
+		});
+		return CountUpdates(difference);
+	} break;
+	}
+	LOG(("Updates Replay Error: Unknown record type %1."
+		).arg(int(record.type)));
+	return 0;
+}
+
+void FinishReplay(const Replay &replay) {
+	ReplayActive = false;
+
+	const auto stages = base::take(Stages);
+	const auto seconds = replay.duration / 1000000.;
+	LOG(("Updates Replay: %1 records with %2 updates fed, "
+		"main thread %3, total %4, %5 updates per second."
+		).arg(int(replay.records.size())
+		).arg(replay.updates
+		).arg(FormatDuration(replay.duration)
+		).arg(FormatDuration(Now() - replay.started)
+		).arg(seconds > 0. ? int(replay.updates / seconds) : 0));
+	for (const auto &[name, stats] : stages) {
+		LOG(("Updates Replay: Stage '%1' called %2 times, %3."
+			).arg(QString::fromLatin1(name)
+			).arg(stats.count
+			).arg(FormatDuration(stats.duration)));
+	}
+}
+
+// One record in each main loop iteration, so that everything the
+// record has posted to the main queue is processed before the next one.
+void ReplayNext(
+		not_null<MainWidget*> main,
+		const std::shared_ptr<Replay> &replay) {
+	if (replay->index == int(replay->records.size())) {
+		FinishReplay(*replay);
+		return;
+	}
+	const auto &record = replay->records[replay->index++];
+	const auto started = Now();
+	try {
+		replay->updates += FeedRecord(main, record);
+	} catch (mtpErrorUnexpected &) {
+		LOG(("Updates Replay Error: Could not read record %1."
+			).arg(replay->index - 1));
+	}
+	replay->duration += Now() - started;
+
+	crl::on_main(main.get(), [=] {
+		ReplayNext(main, replay);
+	});
+}
+
+} // namespace
+
+void StartUpdatesRecord() {
+	Recording = true;
+}
+
+bool UpdatesRecording() {
+	return Recording;
+}
+
+void RecordUpdates(
+		UpdatesRecordType type,
+		const mtpPrime *from,
+		const mtpPrime *end,
+		ChannelId channelId) {
+	Expects(end >= from);
+
+	if (!Recording || (!RecordFile && !OpenRecordFile())) {
+		Recording = false;
+		return;
+	}
+	QDataStream stream(RecordFile.get());
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream
+		<< qint32(type)
+		<< qint32(channelId)
+		<< qint32(end - from);
+	stream.writeRawData(
+		reinterpret_cast<const char*>(from),
+		(end - from) * sizeof(mtpPrime));
+	RecordFile->flush();
+}
+
+void SetUpdatesReplayPath(const QString &path) {
+	ReplayPath = path;
+}
+
+bool UpdatesReplaying() {
+	return !ReplayPath.isEmpty();
+}
+
+void StartUpdatesReplay(not_null<MainWidget*> main) {
+	Expects(UpdatesReplaying());
+
+	auto replay = std::make_shared<Replay>();
+	replay->records = ReadRecords(ReplayPath);
+	replay->started = Now();
+	LOG(("Updates Replay: Feeding %1 records from '%2'."
+		).arg(int(replay->records.size())
+		).arg(ReplayPath));
+
+	ReplayActive = true;
+	ReplayNext(main, replay);
+}
+
+UpdatesStage::UpdatesStage(const char *name)
+: _name(name)
+, _started(ReplayActive ? Now() : 0) {
+}
+
+UpdatesStage::~UpdatesStage() {
+	if (!_started || !ReplayActive) {
+		return;
+	}
+	auto &stats = Stages[QByteArray::fromRawData(_name, strlen(_name))];
+	++stats.count;
+	stats.duration += Now() - _started;
+}
+
+} // namespace Core
@@ -0,0 +1,77 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class MainWidget;
+
+namespace Core {
+
+// When launched with -recordupdates the updates, the states and the
+// differences received by MainWidget are written to
+// DebugLogs/updates_record.bin in the order they were received.
+//
+// When launched with -replayupdates <path> the updates from the server are
+// ignored and no differences are requested. Instead the recorded ones are
+// fed to MainWidget one by one when it is started, and the main thread
+// time of each ingestion stage is written to the log after the last one.
+enum class UpdatesRecordType : int32 {
+	State = 1,
+	Updates = 2,
+	Difference = 3,
+	ChannelDifference = 4,
+};
+
+void StartUpdatesRecord();
+bool UpdatesRecording();
+void RecordUpdates(
+	UpdatesRecordType type,
+	const mtpPrime *from,
+	const mtpPrime *end,
+	ChannelId channelId = NoChannel);
+
+template <typename Type>
+inline void RecordUpdates(
+		UpdatesRecordType type,
+		const Type &data,
+		ChannelId channelId = NoChannel) {
+	if (!UpdatesRecording()) {
+		return;
+	}
+	auto buffer = mtpBuffer();
+	data.write(buffer);
+	RecordUpdates(
+		type,
+		buffer.constData(),
+		buffer.constData() + buffer.size(),
+		channelId);
+}
+
+void SetUpdatesReplayPath(const QString &path);
+bool UpdatesReplaying();
+void StartUpdatesReplay(not_null<MainWidget*> main);
+
+class UpdatesStage {
+public:
+	explicit UpdatesStage(const char *name);
+	UpdatesStage(const UpdatesStage &other) = delete;
+	UpdatesStage &operator=(const UpdatesStage &other) = delete;
+	~UpdatesStage();
+
+private:
+	const char *_name = nullptr;
+	int64 _started = 0;
+
+};
+
+template <typename Callback>
+inline auto TraceUpdatesStage(const char *name, Callback &&callback) {
+	const auto stage = UpdatesStage(name);
+	return callback();
+}
+
+} // namespace Core
@@ -399,16 +399,6 @@ Data::FileOrigin StickerData::setOrigin() const {
 	});
 }
 
-VoiceData::~VoiceData() {
-	if (!waveform.isEmpty()
-		&& waveform[0] == -1
-		&& waveform.size() > int32(sizeof(TaskId))) {
-		TaskId taskId = 0;
-		memcpy(&taskId, waveform.constData() + 1, sizeof(taskId));
-		Local::cancelTask(taskId);
-	}
-}
-
 DocumentData::DocumentData(DocumentId id, not_null<AuthSession*> session)
 : id(id)
 , _session(session) {
@@ -993,6 +983,12 @@ void DocumentData::checkStickerThumb() {
 	}
 }
 
+void DocumentData::pauseStickerThumb() {
+	if (hasGoodStickerThumb()) {
+		thumb->pauseLoading();
+	}
+}
+
 ImagePtr DocumentData::getStickerThumb() {
 	if (hasGoodStickerThumb()) {
 		return thumb;
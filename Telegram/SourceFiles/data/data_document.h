@@ -56,8 +56,6 @@ struct SongData : public DocumentAdditionalData {
 };
 
 struct VoiceData : public DocumentAdditionalData {
-	~VoiceData();
-
 	int duration = 0;
 	VoiceWaveform waveform;
 	char wavemax = 0;
@@ -127,6 +125,7 @@ public:
 	StickerData *sticker() const;
 	void checkSticker();
 	void checkStickerThumb();
+	void pauseStickerThumb();
 	ImagePtr getStickerThumb();
 	Data::FileOrigin stickerSetOrigin() const;
 	Data::FileOrigin stickerOrGifOrigin() const;
@@ -0,0 +1,172 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_history_cache.h"
+
+#include "data/data_session.h"
+#include "data/data_peer.h"
+#include "history/history_item.h"
+#include "history/history.h"
+#include "storage/cache/storage_cache_database.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kSerializeVersion = mtpPrime(1);
+
+PeerId UserPeerId(const MTPUser &user) {
+	switch (user.type()) {
+	case mtpc_user: return peerFromUser(user.c_user().vid);
+	case mtpc_userEmpty: return peerFromUser(user.c_userEmpty().vid);
+	}
+	return PeerId(0);
+}
+
+PeerId ChatPeerId(const MTPChat &chat) {
+	switch (chat.type()) {
+	case mtpc_chat: return peerFromChat(chat.c_chat().vid);
+	case mtpc_chatEmpty: return peerFromChat(chat.c_chatEmpty().vid);
+	case mtpc_chatForbidden:
+		return peerFromChat(chat.c_chatForbidden().vid);
+	case mtpc_channel: return peerFromChannel(chat.c_channel().vid);
+	case mtpc_channelForbidden:
+		return peerFromChannel(chat.c_channelForbidden().vid);
+	}
+	return PeerId(0);
+}
+
+// The saved users and chats are older than anything we've received
+// in this session, so we use them only for the peers we don't know yet.
+template <typename Type, typename Method>
+MTPVector<Type> FilterUnknown(
+		const MTPVector<Type> &list,
+		Method peerId) {
+	auto result = QVector<Type>();
+	result.reserve(list.v.size());
+	for (const auto &entry : list.v) {
+		if (!App::peerLoaded(peerId(entry))) {
+			result.push_back(entry);
+		}
+	}
+	return MTP_vector<Type>(std::move(result));
+}
+
+} // namespace
+
+HistoryCache::HistoryCache(not_null<Session*> owner)
+: _owner(owner) {
+	_owner->historyCleared(
+	) | rpl::start_with_next([=](not_null<const History*> history) {
+		forget(history->peer->id);
+	}, _lifetime);
+}
+
+void HistoryCache::saveLastPage(
+		not_null<PeerData*> peer,
+		const MTPmessages_Messages &page) {
+	const auto normalized = [&] {
+		switch (page.type()) {
+		case mtpc_messages_messages: return MTPmessages_Messages(page);
+		case mtpc_messages_messagesSlice: {
+			const auto &data = page.c_messages_messagesSlice();
+			return MTP_messages_messages(
+				data.vmessages,
+				data.vchats,
+				data.vusers);
+		}
+		case mtpc_messages_channelMessages: {
+			// Don't save pts, it will be outdated when we read it back.
+			const auto &data = page.c_messages_channelMessages();
+			return MTP_messages_messages(
+				data.vmessages,
+				data.vchats,
+				data.vusers);
+		}
+		}
+		return MTP_messages_messages(
+			MTP_vector<MTPMessage>(),
+			MTP_vector<MTPChat>(),
+			MTP_vector<MTPUser>());
+	}();
+	if (normalized.c_messages_messages().vmessages.v.isEmpty()) {
+		forget(peer->id);
+		return;
+	}
+	auto buffer = mtpBuffer();
+	buffer.reserve(1 + normalized.innerLength() / sizeof(mtpPrime));
+	buffer.push_back(kSerializeVersion);
+	normalized.write(buffer);
+
+	_forgotten.erase(peer->id);
+	_owner->cache().put(
+		HistoryPageCacheKey(peer->id),
+		QByteArray(
+			reinterpret_cast<const char*>(buffer.constData()),
+			buffer.size() * sizeof(mtpPrime)));
+}
+
+void HistoryCache::loadLastPage(
+		not_null<PeerData*> peer,
+		Fn<void(const QVector<MTPMessage> &messages)> done) {
+	const auto peerId = peer->id;
+	_owner->cache().get(HistoryPageCacheKey(peerId), [=](
+			QByteArray &&value) {
+		// Parse the page in the database thread.
+		if (value.isEmpty() || value.size() % sizeof(mtpPrime)) {
+			return;
+		}
+		auto from = reinterpret_cast<const mtpPrime*>(value.constData());
+		const auto end = from + (value.size() / sizeof(mtpPrime));
+		if (*from++ != kSerializeVersion) {
+			return;
+		}
+		auto page = MTPmessages_Messages();
+		try {
+			page.read(from, end);
+		} catch (Exception &) {
+			LOG(("Cache Error: Bad history page for peer %1.").arg(peerId));
+			return;
+		}
+		crl::on_main(this, [=, page = std::move(page)] {
+			if (!_forgotten.contains(peerId)) {
+				applyLoaded(page, done);
+			}
+		});
+	});
+}
+
+void HistoryCache::applyLoaded(
+		const MTPmessages_Messages &page,
+		const Fn<void(const QVector<MTPMessage> &messages)> &done) {
+	if (page.type() != mtpc_messages_messages) {
+		return;
+	}
+	const auto &data = page.c_messages_messages();
+	if (data.vmessages.v.isEmpty()) {
+		return;
+	}
+	App::feedUsers(FilterUnknown(data.vusers, UserPeerId));
+	App::feedChats(FilterUnknown(data.vchats, ChatPeerId));
+	done(data.vmessages.v);
+}
+
+void HistoryCache::forget(PeerId peerId) {
+	if (_forgotten.contains(peerId)) {
+		return;
+	}
+	_forgotten.emplace(peerId);
+	_owner->cache().remove(HistoryPageCacheKey(peerId));
+}
+
+void HistoryCache::itemRemoved(not_null<const HistoryItem*> item) {
+	// Don't show the deleted messages from the saved page even for a moment.
+	if (IsServerMsgId(item->id) && !item->isLogEntry()) {
+		forget(item->history()->peer->id);
+	}
+}
+
+} // namespace Data
@@ -0,0 +1,49 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class HistoryItem;
+
+namespace Data {
+
+class Session;
+
+// Last page of each opened chat, kept in the storage cache.
+//
+// When a chat is opened for the first time after the launch it is shown
+// from this page at once and refreshed when the server page arrives.
+class HistoryCache final : public base::has_weak_ptr {
+public:
+	explicit HistoryCache(not_null<Session*> owner);
+
+	void saveLastPage(
+		not_null<PeerData*> peer,
+		const MTPmessages_Messages &page);
+
+	// Feeds users and chats we don't know yet and calls done() with the
+	// page messages, newest first. Doesn't call done() if there is nothing.
+	void loadLastPage(
+		not_null<PeerData*> peer,
+		Fn<void(const QVector<MTPMessage> &messages)> done);
+
+	void forget(PeerId peerId);
+	void itemRemoved(not_null<const HistoryItem*> item);
+
+private:
+	void applyLoaded(
+		const MTPmessages_Messages &page,
+		const Fn<void(const QVector<MTPMessage> &messages)> &done);
+
+	const not_null<Session*> _owner;
+	base::flat_set<PeerId> _forgotten;
+
+	rpl::lifetime _lifetime;
+
+};
+
+} // namespace Data
@@ -0,0 +1,349 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_messages_search_index.h"
+
+#include "data/data_session.h"
+#include "history/history_item.h"
+#include "history/history.h"
+#include "data/data_peer.h"
+#include "storage/cache/storage_cache_database.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kSaveDelay = TimeMs(5000);
+constexpr auto kMaxItemsInIndex = 10000;
+constexpr auto kSerializeVersion = qint32(1);
+
+} // namespace
+
+MessagesSearchIndex::MessagesSearchIndex(not_null<Session*> owner)
+: _owner(owner)
+, _saveTimer([=] { save(); }) {
+}
+
+void MessagesSearchIndex::add(
+		not_null<const HistoryItem*> item,
+		const QString &text) {
+	if (!IsServerMsgId(item->id) || item->isLogEntry()) {
+		return;
+	}
+	const auto peerId = item->history()->peer->id;
+	const auto serial = ++_pendingSerial;
+	_pendingSerials[std::make_pair(peerId, item->id)] = serial;
+	if (_pending.empty()) {
+		crl::on_main(this, [=] { indexPending(); });
+	}
+	_pending.push_back({ peerId, item->id, text, serial });
+}
+
+void MessagesSearchIndex::indexPending() {
+	if (_pending.empty()) {
+		return;
+	}
+	const auto weak = base::make_weak(this);
+	crl::async([=, pending = base::take(_pending)] {
+		auto prepared = std::vector<PreparedWords>();
+		prepared.reserve(pending.size());
+		for (const auto &entry : pending) {
+			auto words = TextUtilities::PrepareSearchWords(entry.text);
+			words.sort();
+			words.erase(std::unique(words.begin(), words.end()), words.end());
+			prepared.push_back({
+				entry.peerId,
+				entry.msgId,
+				std::move(words),
+				entry.serial });
+		}
+		crl::on_main(weak, [=, prepared = std::move(prepared)]() mutable {
+			applyPrepared(std::move(prepared));
+		});
+	});
+}
+
+void MessagesSearchIndex::applyPrepared(
+		std::vector<PreparedWords> &&prepared) {
+	for (auto &entry : prepared) {
+		// Skip the texts that were changed or removed after this batch.
+		const auto i = _pendingSerials.find(
+			std::make_pair(entry.peerId, entry.msgId));
+		if (i == _pendingSerials.end() || i->second != entry.serial) {
+			continue;
+		}
+		_pendingSerials.erase(i);
+		apply(entry.peerId, entry.msgId, std::move(entry.words));
+	}
+}
+
+void MessagesSearchIndex::apply(
+		PeerId peerId,
+		MsgId msgId,
+		QStringList &&words) {
+	auto &index = enforceIndex(peerId);
+	const auto i = index.items.find(msgId);
+	if (i == index.items.end() ? words.isEmpty() : (i->second == words)) {
+		return;
+	}
+	removeWords(index, msgId);
+	if (!words.isEmpty()) {
+		addWords(index, msgId, std::move(words));
+		removeOldest(index);
+	}
+	changed(peerId);
+}
+
+void MessagesSearchIndex::remove(not_null<const HistoryItem*> item) {
+	if (!IsServerMsgId(item->id) || item->isLogEntry()) {
+		return;
+	}
+	const auto peerId = item->history()->peer->id;
+	_pendingSerials.erase(std::make_pair(peerId, item->id));
+
+	// The saved index may contain this item even if it's not in memory,
+	// so it is loaded and merged before the next save.
+	auto &index = enforceIndex(peerId);
+	if (!index.loaded) {
+		index.removedWhileLoading.emplace(item->id);
+		changed(peerId);
+	}
+	if (index.items.contains(item->id)) {
+		removeWords(index, item->id);
+		changed(peerId);
+	}
+}
+
+std::vector<MsgId> MessagesSearchIndex::query(
+		PeerId peerId,
+		const QString &query) {
+	if (_queriedPeerId != peerId) {
+		dropIfSaved(base::take(_queriedPeerId));
+		_queriedPeerId = peerId;
+	}
+	auto &index = enforceIndex(peerId);
+	if (!index.loaded && !index.loading) {
+		load(peerId, index);
+	}
+	auto result = std::vector<MsgId>();
+	auto first = true;
+	for (const auto &word : TextUtilities::PrepareSearchWords(query)) {
+		auto found = std::vector<MsgId>();
+		const auto from = index.words.lower_bound(word);
+		for (auto i = from; i != index.words.end(); ++i) {
+			if (!i->first.startsWith(word)) {
+				break;
+			}
+			found.insert(found.end(), i->second.begin(), i->second.end());
+		}
+		ranges::sort(found);
+		found.erase(ranges::unique(found), found.end());
+		if (first) {
+			result = std::move(found);
+			first = false;
+		} else {
+			auto intersection = std::vector<MsgId>();
+			std::set_intersection(
+				result.begin(),
+				result.end(),
+				found.begin(),
+				found.end(),
+				std::back_inserter(intersection));
+			result = std::move(intersection);
+		}
+		if (result.empty()) {
+			break;
+		}
+	}
+	ranges::reverse(result);
+	return result;
+}
+
+rpl::producer<PeerId> MessagesSearchIndex::loaded() const {
+	return _loaded.events();
+}
+
+void MessagesSearchIndex::clear(PeerId peerId) {
+	_indices.erase(peerId);
+	_changed.remove(peerId);
+	for (auto i = _pendingSerials.begin(); i != _pendingSerials.end();) {
+		if (i->first.first == peerId) {
+			i = _pendingSerials.erase(i);
+		} else {
+			++i;
+		}
+	}
+	_owner->cache().remove(MessagesSearchIndexCacheKey(peerId));
+}
+
+auto MessagesSearchIndex::enforceIndex(PeerId peerId) -> PeerIndex& {
+	return _indices[peerId];
+}
+
+void MessagesSearchIndex::dropIfSaved(PeerId peerId) {
+	const auto i = _indices.find(peerId);
+	if (i != _indices.end()
+		&& i->second.loaded
+		&& !_changed.contains(peerId)) {
+		_indices.erase(i);
+	}
+}
+
+void MessagesSearchIndex::load(PeerId peerId, PeerIndex &index) {
+	const auto serial = ++_loadSerial;
+	index.loading = true;
+	index.loadSerial = serial;
+	_owner->cache().get(
+		MessagesSearchIndexCacheKey(peerId),
+		[=](QByteArray &&value) {
+			crl::on_main(this, [=, value = std::move(value)] {
+				applyLoaded(peerId, serial, value);
+			});
+		});
+}
+
+void MessagesSearchIndex::applyLoaded(
+		PeerId peerId,
+		uint64 serial,
+		const QByteArray &serialized) {
+	// The index could be cleared while it was loading.
+	const auto i = _indices.find(peerId);
+	if (i == _indices.end()
+		|| !i->second.loading
+		|| i->second.loadSerial != serial) {
+		return;
+	}
+	auto &index = i->second;
+	index.loading = false;
+	index.loaded = true;
+	const auto removed = base::take(index.removedWhileLoading);
+	if (serialized.isEmpty()) {
+		return;
+	}
+
+	QDataStream stream(serialized);
+	stream.setVersion(QDataStream::Qt_5_1);
+	auto version = qint32();
+	auto count = qint32();
+	stream >> version >> count;
+	if (stream.status() != QDataStream::Ok
+		|| version != kSerializeVersion
+		|| count < 0
+		|| count > kMaxItemsInIndex) {
+		return;
+	}
+	auto added = false;
+	for (auto i = 0; i != count; ++i) {
+		auto msgId = qint32();
+		auto words = QStringList();
+		stream >> msgId >> words;
+		if (stream.status() != QDataStream::Ok) {
+			LOG(("Cache Error: Bad search index for peer %1.").arg(peerId));
+			break;
+		}
+
+		// Items indexed in this session are newer than the saved ones.
+		if (!removed.contains(msgId) && !index.items.contains(msgId)) {
+			addWords(index, msgId, std::move(words));
+			added = true;
+		}
+	}
+	if (!removed.empty()) {
+		changed(peerId);
+	}
+	if (added) {
+		removeOldest(index);
+		_loaded.fire_copy(peerId);
+	}
+}
+
+void MessagesSearchIndex::addWords(
+		PeerIndex &index,
+		MsgId msgId,
+		QStringList &&words) {
+	for (const auto &word : words) {
+		index.words[word].emplace(msgId);
+	}
+	index.items.emplace(msgId, std::move(words));
+}
+
+void MessagesSearchIndex::removeWords(PeerIndex &index, MsgId msgId) {
+	const auto words = index.items.take(msgId);
+	if (!words) {
+		return;
+	}
+	for (const auto &word : *words) {
+		const auto i = index.words.find(word);
+		if (i != index.words.end()) {
+			i->second.erase(msgId);
+			if (i->second.empty()) {
+				index.words.erase(i);
+			}
+		}
+	}
+}
+
+void MessagesSearchIndex::removeOldest(PeerIndex &index) {
+	while (int(index.items.size()) > kMaxItemsInIndex) {
+		removeWords(index, index.items.front().first);
+	}
+}
+
+void MessagesSearchIndex::changed(PeerId peerId) {
+	_changed.emplace(peerId);
+	if (!_saveTimer.isActive()) {
+		_saveTimer.callOnce(kSaveDelay);
+	}
+}
+
+void MessagesSearchIndex::save() {
+	for (auto i = _changed.begin(); i != _changed.end();) {
+		const auto peerId = *i;
+		const auto index = _indices.find(peerId);
+		if (index == _indices.end()) {
+			i = _changed.erase(i);
+		} else if (!index->second.loaded) {
+			// Don't overwrite the saved index until we've merged it.
+			if (!index->second.loading) {
+				load(peerId, index->second);
+			}
+			++i;
+		} else {
+			_owner->cache().put(
+				MessagesSearchIndexCacheKey(peerId),
+				serialize(index->second));
+			i = _changed.erase(i);
+
+			// Only the index of the searched peer is kept in memory,
+			// the others are loaded and merged again when changed.
+			if (peerId != _queriedPeerId) {
+				_indices.erase(index);
+			}
+		}
+	}
+	if (!_changed.empty()) {
+		_saveTimer.callOnce(kSaveDelay);
+	}
+}
+
+QByteArray MessagesSearchIndex::serialize(const PeerIndex &index) const {
+	auto result = QByteArray();
+	{
+		QDataStream stream(&result, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << kSerializeVersion << qint32(index.items.size());
+		for (const auto &[msgId, words] : index.items) {
+			stream << qint32(msgId) << words;
+		}
+	}
+	return result;
+}
+
+MessagesSearchIndex::~MessagesSearchIndex() {
+	save();
+}
+
+} // namespace Data
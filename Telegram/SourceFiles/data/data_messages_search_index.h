@@ -0,0 +1,98 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/timer.h"
+
+class HistoryItem;
+
+namespace Data {
+
+class Session;
+
+// Inverted index of the words from the message texts we've seen.
+//
+// It is kept per peer in the storage cache, so the in-chat search can
+// show local results before the server answers or when it can't answer.
+class MessagesSearchIndex final : public base::has_weak_ptr {
+public:
+	explicit MessagesSearchIndex(not_null<Session*> owner);
+
+	// Texts are collected and split to words in a background thread,
+	// so an added message appears in the index a bit later.
+	void add(not_null<const HistoryItem*> item, const QString &text);
+	void remove(not_null<const HistoryItem*> item);
+
+	// Returns ids of the messages containing all the query words
+	// as word prefixes, newest first. If the index of this peer is not
+	// read from the storage cache yet, starts reading it and fires
+	// loaded() for this peer when it is finished.
+	std::vector<MsgId> query(PeerId peerId, const QString &query);
+	rpl::producer<PeerId> loaded() const;
+
+	// Removes the index of this peer from memory and from the cache,
+	// when its history is cleared or the chat is deleted.
+	void clear(PeerId peerId);
+
+	~MessagesSearchIndex();
+
+private:
+	struct PeerIndex {
+		std::map<QString, base::flat_set<MsgId>> words;
+		base::flat_map<MsgId, QStringList> items;
+		base::flat_set<MsgId> removedWhileLoading;
+		uint64 loadSerial = 0;
+		bool loading = false;
+		bool loaded = false;
+	};
+	struct PendingText {
+		PeerId peerId = 0;
+		MsgId msgId = 0;
+		QString text;
+		uint64 serial = 0;
+	};
+	struct PreparedWords {
+		PeerId peerId = 0;
+		MsgId msgId = 0;
+		QStringList words;
+		uint64 serial = 0;
+	};
+
+	void indexPending();
+	void applyPrepared(std::vector<PreparedWords> &&prepared);
+	void apply(PeerId peerId, MsgId msgId, QStringList &&words);
+
+	PeerIndex &enforceIndex(PeerId peerId);
+	void dropIfSaved(PeerId peerId);
+	void load(PeerId peerId, PeerIndex &index);
+	void applyLoaded(
+		PeerId peerId,
+		uint64 serial,
+		const QByteArray &serialized);
+	void addWords(PeerIndex &index, MsgId msgId, QStringList &&words);
+	void removeWords(PeerIndex &index, MsgId msgId);
+	void removeOldest(PeerIndex &index);
+	void changed(PeerId peerId);
+	void save();
+
+	QByteArray serialize(const PeerIndex &index) const;
+
+	const not_null<Session*> _owner;
+	std::map<PeerId, PeerIndex> _indices;
+	std::vector<PendingText> _pending;
+	std::map<std::pair<PeerId, MsgId>, uint64> _pendingSerials;
+	uint64 _pendingSerial = 0;
+	uint64 _loadSerial = 0;
+	PeerId _queriedPeerId = 0;
+	base::flat_set<PeerId> _changed;
+	base::Timer _saveTimer;
+	rpl::event_stream<PeerId> _loaded;
+
+};
+
+} // namespace Data
@@ -72,6 +72,8 @@ Session::Session(not_null<AuthSession*> session)
 	Local::cachePath(),
 	Local::cacheSettings()))
 , _groups(this)
+, _messagesSearchIndex(this)
+, _historyCache(this)
 , _unmuteByFinishedTimer([=] { unmuteByFinished(); }) {
 	_cache->open(Local::cacheKey());
 
@@ -353,10 +355,16 @@ rpl::producer<not_null<const HistoryItem*>> Session::itemRepaintRequest() const
 }
 
 void Session::requestViewRepaint(not_null<const ViewElement*> view) {
-	_viewRepaintRequest.fire_copy(view);
+	_viewRepaintRequest.fire({ view, QRect() });
 }
 
-rpl::producer<not_null<const ViewElement*>> Session::viewRepaintRequest() const {
+void Session::requestViewRepaint(
+		not_null<const ViewElement*> view,
+		QRect rect) {
+	_viewRepaintRequest.fire({ view, rect });
+}
+
+rpl::producer<Session::ViewRepaint> Session::viewRepaintRequest() const {
 	return _viewRepaintRequest.events();
 }
 
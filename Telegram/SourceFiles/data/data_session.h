@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "chat_helpers/stickers.h"
 #include "dialogs/dialogs_key.h"
 #include "data/data_groups.h"
+#include "data/data_messages_search_index.h"
+#include "data/data_history_cache.h"
 #include "base/timer.h"
 
 class HistoryItem;
@@ -103,8 +105,13 @@ public:
 	[[nodiscard]] rpl::producer<not_null<const ViewElement*>> viewLayoutChanged() const;
 	void requestItemRepaint(not_null<const HistoryItem*> item);
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemRepaintRequest() const;
+	struct ViewRepaint {
+		not_null<const ViewElement*> view;
+		QRect rect; // In the view coordinates, empty for the whole view.
+	};
 	void requestViewRepaint(not_null<const ViewElement*> view);
-	[[nodiscard]] rpl::producer<not_null<const ViewElement*>> viewRepaintRequest() const;
+	void requestViewRepaint(not_null<const ViewElement*> view, QRect rect);
+	[[nodiscard]] rpl::producer<ViewRepaint> viewRepaintRequest() const;
 	void requestItemResize(not_null<const HistoryItem*> item);
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemResizeRequest() const;
 	void requestViewResize(not_null<ViewElement*> view);
@@ -428,6 +435,12 @@ public:
 	const Groups &groups() const {
 		return _groups;
 	}
+	MessagesSearchIndex &messagesSearchIndex() {
+		return _messagesSearchIndex;
+	}
+	HistoryCache &historyCache() {
+		return _historyCache;
+	}
 
 private:
 	void suggestStartExport();
@@ -548,7 +561,7 @@ private:
 	rpl::event_stream<not_null<const HistoryItem*>> _itemLayoutChanges;
 	rpl::event_stream<not_null<const ViewElement*>> _viewLayoutChanges;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemRepaintRequest;
-	rpl::event_stream<not_null<const ViewElement*>> _viewRepaintRequest;
+	rpl::event_stream<ViewRepaint> _viewRepaintRequest;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemResizeRequest;
 	rpl::event_stream<not_null<ViewElement*>> _viewResizeRequest;
 	rpl::event_stream<not_null<HistoryItem*>> _itemViewRefreshRequest;
@@ -622,6 +635,8 @@ private:
 	base::flat_map<FeedId, std::unique_ptr<Feed>> _feeds;
 	rpl::variable<FeedId> _defaultFeedId = FeedId();
 	Groups _groups;
+	MessagesSearchIndex _messagesSearchIndex;
+	HistoryCache _historyCache;
 	std::map<
 		not_null<const HistoryItem*>,
 		std::vector<not_null<ViewElement*>>> _views;
@@ -11,7 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_sparse_ids_list.h"
 
 SparseIdsSlice::SparseIdsSlice(
-	const base::flat_set<MsgId> &ids,
+	const base::vector_flat_set<MsgId> &ids,
 	MsgRange range,
 	std::optional<int> fullCount,
 	std::optional<int> skippedBefore,
@@ -209,7 +209,7 @@ bool SparseIdsSliceBuilder::applyUpdate(
 		update.count,
 		needMergeMessages
 			? *update.messages
-			: base::flat_set<MsgId> {},
+			: base::vector_flat_set<MsgId> {},
 		skippedBefore,
 		skippedAfter);
 	return true;
@@ -267,7 +267,7 @@ void SparseIdsSliceBuilder::checkInsufficient() {
 
 void SparseIdsSliceBuilder::mergeSliceData(
 		std::optional<int> count,
-		const base::flat_set<MsgId> &messageIds,
+		const base::vector_flat_set<MsgId> &messageIds,
 		std::optional<int> skippedBefore,
 		std::optional<int> skippedAfter) {
 	if (messageIds.empty()) {
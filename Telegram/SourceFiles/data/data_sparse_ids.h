@@ -20,7 +20,7 @@ public:
 
 	SparseIdsSlice() = default;
 	SparseIdsSlice(
-		const base::flat_set<MsgId> &ids,
+		const base::vector_flat_set<MsgId> &ids,
 		MsgRange range,
 		std::optional<int> fullCount,
 		std::optional<int> skippedBefore,
@@ -36,7 +36,7 @@ public:
 	std::optional<MsgId> nearest(MsgId msgId) const;
 
 private:
-	base::flat_set<MsgId> _ids;
+	base::vector_flat_set<MsgId> _ids;
 	MsgRange _range;
 	std::optional<int> _fullCount;
 	std::optional<int> _skippedBefore;
@@ -201,12 +201,12 @@ private:
 
 	void mergeSliceData(
 		std::optional<int> count,
-		const base::flat_set<MsgId> &messageIds,
+		const base::vector_flat_set<MsgId> &messageIds,
 		std::optional<int> skippedBefore = std::nullopt,
 		std::optional<int> skippedAfter = std::nullopt);
 
 	Key _key;
-	base::flat_set<MsgId> _ids;
+	base::vector_flat_set<MsgId> _ids;
 	MsgRange _range;
 	std::optional<int> _fullCount;
 	std::optional<int> _skippedBefore;
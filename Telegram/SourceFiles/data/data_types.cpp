@@ -25,6 +25,9 @@ constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kUrlCacheMask = 0x000000FFFFFFFFFFULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
 constexpr auto kGeoPointCacheMask = 0x000000FFFFFFFFFFULL;
+constexpr auto kMessagesSearchIndexCacheTag = 0x0000050000000000ULL;
+constexpr auto kHistoryPageCacheTag = 0x0000060000000000ULL;
+constexpr auto kVoiceWaveformCacheTag = 0x0000070000000000ULL;
 
 } // namespace
 
@@ -88,6 +91,27 @@ Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location) {
 	};
 }
 
+Storage::Cache::Key MessagesSearchIndexCacheKey(uint64 peerId) {
+	return Storage::Cache::Key{
+		Data::kMessagesSearchIndexCacheTag,
+		peerId
+	};
+}
+
+Storage::Cache::Key HistoryPageCacheKey(uint64 peerId) {
+	return Storage::Cache::Key{
+		Data::kHistoryPageCacheTag,
+		peerId
+	};
+}
+
+Storage::Cache::Key VoiceWaveformCacheKey(uint64 documentId) {
+	return Storage::Cache::Key{
+		Data::kVoiceWaveformCacheTag,
+		documentId
+	};
+}
+
 } // namespace Data
 
 void AudioMsgId::setTypeFromAudio() {
@@ -42,6 +42,9 @@ Storage::Cache::Key StorageCacheKey(const StorageImageLocation &location);
 Storage::Cache::Key WebDocumentCacheKey(const WebFileLocation &location);
 Storage::Cache::Key UrlCacheKey(const QString &location);
 Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location);
+Storage::Cache::Key MessagesSearchIndexCacheKey(uint64 peerId);
+Storage::Cache::Key HistoryPageCacheKey(uint64 peerId);
+Storage::Cache::Key VoiceWaveformCacheKey(uint64 documentId);
 
 constexpr auto kImageCacheTag = uint8(0x01);
 constexpr auto kStickerCacheTag = uint8(0x02);
@@ -231,6 +234,18 @@ struct FullMsgId {
 
 Q_DECLARE_METATYPE(FullMsgId);
 
+namespace std {
+
+template <>
+struct hash<FullMsgId> {
+	size_t operator()(const FullMsgId &value) const {
+		return hash<uint64>()(
+			(uint64(uint32(value.channel)) << 32) | uint32(value.msg));
+	}
+};
+
+} // namespace std
+
 using MessageIdsList = std::vector<FullMsgId>;
 
 inline PeerId peerFromMessage(const MTPmessage &msg) {
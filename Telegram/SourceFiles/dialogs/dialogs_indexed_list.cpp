@@ -23,6 +23,7 @@ RowsByLetter IndexedList::addToEnd(Key key) {
 	RowsByLetter result;
 	if (!_list.contains(key)) {
 		result.emplace(0, _list.addToEnd(key));
+		_nameIndex.add(key, key.entry()->chatsListNameWords());
 		for (auto ch : key.entry()->chatsListFirstLetters()) {
 			auto j = _index.find(ch);
 			if (j == _index.cend()) {
@@ -42,6 +43,7 @@ Row *IndexedList::addByName(Key key) {
 	}
 
 	Row *result = _list.addByName(key);
+	_nameIndex.add(key, key.entry()->chatsListNameWords());
 	for (auto ch : key.entry()->chatsListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -121,6 +123,8 @@ void IndexedList::adjustByName(
 	const auto mainRow = _list.adjustByName(key);
 	if (!mainRow) return;
 
+	_nameIndex.add(key, key.entry()->chatsListNameWords());
+
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
 	for (auto ch : key.entry()->chatsListFirstLetters()) {
@@ -160,6 +164,8 @@ void IndexedList::adjustNames(
 	auto mainRow = _list.getRow(key);
 	if (!mainRow) return;
 
+	_nameIndex.add(key, key.entry()->chatsListNameWords());
+
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
 	for (auto ch : key.entry()->chatsListFirstLetters()) {
@@ -194,6 +200,7 @@ void IndexedList::adjustNames(
 
 void IndexedList::del(Key key, Row *replacedBy) {
 	if (_list.del(key, replacedBy)) {
+		_nameIndex.remove(key);
 		for (auto ch : key.entry()->chatsListFirstLetters()) {
 			if (auto it = _index.find(ch); it != _index.cend()) {
 				it->second->del(key, replacedBy);
@@ -204,6 +211,21 @@ void IndexedList::del(Key key, Row *replacedBy) {
 
 void IndexedList::clear() {
 	_index.clear();
+	_nameIndex.clear();
+}
+
+std::vector<not_null<Row*>> IndexedList::filtered(
+		const QStringList &words) const {
+	auto result = std::vector<not_null<Row*>>();
+	for (const auto key : _nameIndex.find(words)) {
+		if (const auto row = _list.getRow(key)) {
+			result.push_back(row);
+		}
+	}
+	ranges::sort(result, [](not_null<Row*> a, not_null<Row*> b) {
+		return (a->pos() < b->pos());
+	});
+	return result;
 }
 
 IndexedList::~IndexedList() {
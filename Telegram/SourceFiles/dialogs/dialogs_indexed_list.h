@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "dialogs/dialogs_entry.h"
 #include "dialogs/dialogs_list.h"
+#include "dialogs/dialogs_name_index.h"
 
 class History;
 
@@ -50,6 +51,9 @@ public:
 		return &_empty;
 	}
 
+	// Rows with a name word starting with each of the words, in all() order.
+	std::vector<not_null<Row*>> filtered(const QStringList &words) const;
+
 	~IndexedList();
 
 	// Part of List interface is duplicated here for all() list.
@@ -86,6 +90,7 @@ private:
 	SortMode _sortMode;
 	List _list, _empty;
 	base::flat_map<QChar, std::unique_ptr<List>> _index;
+	NameIndex<Key> _nameIndex;
 
 };
 
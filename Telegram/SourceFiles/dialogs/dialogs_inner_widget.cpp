@@ -1596,80 +1596,19 @@ void DialogsInner::onFilterUpdate(QString newFilter, bool force) {
 		if (_filter.isEmpty() && !_searchFromUser) {
 			clearFilter();
 		} else {
-			QStringList::const_iterator fb = words.cbegin(), fe = words.cend(), fi;
-
 			_state = State::Filtered;
 			_waitingForSearch = true;
 			_filterResults.clear();
 			_filterResultsGlobal.clear();
 			if (!_searchInChat && !words.isEmpty()) {
-				const Dialogs::List *toFilter = nullptr;
-				if (!_dialogs->isEmpty()) {
-					for (fi = fb; fi != fe; ++fi) {
-						auto found = _dialogs->filtered(fi->at(0));
-						if (found->isEmpty()) {
-							toFilter = nullptr;
-							break;
-						}
-						if (!toFilter || toFilter->size() > found->size()) {
-							toFilter = found;
-						}
-					}
-				}
-				const Dialogs::List *toFilterContacts = nullptr;
-				if (!_contactsNoDialogs->isEmpty()) {
-					for (fi = fb; fi != fe; ++fi) {
-						auto found = _contactsNoDialogs->filtered(fi->at(0));
-						if (found->isEmpty()) {
-							toFilterContacts = nullptr;
-							break;
-						}
-						if (!toFilterContacts || toFilterContacts->size() > found->size()) {
-							toFilterContacts = found;
-						}
-					}
+				const auto found = _dialogs->filtered(words);
+				const auto foundContacts = _contactsNoDialogs->filtered(words);
+				_filterResults.reserve(found.size() + foundContacts.size());
+				for (const auto row : found) {
+					_filterResults.push_back(row);
 				}
-				_filterResults.reserve((toFilter ? toFilter->size() : 0)
-					+ (toFilterContacts ? toFilterContacts->size() : 0));
-				if (toFilter) {
-					for (const auto row : *toFilter) {
-						const auto &nameWords = row->entry()->chatsListNameWords();
-						auto nb = nameWords.cbegin(), ne = nameWords.cend(), ni = nb;
-						for (fi = fb; fi != fe; ++fi) {
-							auto filterWord = *fi;
-							for (ni = nb; ni != ne; ++ni) {
-								if (ni->startsWith(filterWord)) {
-									break;
-								}
-							}
-							if (ni == ne) {
-								break;
-							}
-						}
-						if (fi == fe) {
-							_filterResults.push_back(row);
-						}
-					}
-				}
-				if (toFilterContacts) {
-					for (const auto row : *toFilterContacts) {
-						const auto &nameWords = row->entry()->chatsListNameWords();
-						auto nb = nameWords.cbegin(), ne = nameWords.cend(), ni = nb;
-						for (fi = fb; fi != fe; ++fi) {
-							auto filterWord = *fi;
-							for (ni = nb; ni != ne; ++ni) {
-								if (ni->startsWith(filterWord)) {
-									break;
-								}
-							}
-							if (ni == ne) {
-								break;
-							}
-						}
-						if (fi == fe) {
-							_filterResults.push_back(row);
-						}
-					}
+				for (const auto row : foundContacts) {
+					_filterResults.push_back(row);
 				}
 			}
 			refresh(true);
@@ -1717,6 +1656,7 @@ DialogsInner::~DialogsInner() {
 void DialogsInner::clearSearchResults(bool clearPeerSearchResults) {
 	if (clearPeerSearchResults) _peerSearchResults.clear();
 	_searchResults.clear();
+	_searchResultsLocal = false;
 	_searchedCount = _searchedMigratedCount = 0;
 	_lastSearchDate = 0;
 	_lastSearchPeer = 0;
@@ -1928,6 +1868,25 @@ bool DialogsInner::searchReceived(
 	return lastDateFound != 0;
 }
 
+void DialogsInner::searchLocalReceived(
+		std::vector<not_null<HistoryItem*>> &&items) {
+	if (items.empty() && !_searchResultsLocal) {
+		return;
+	}
+	clearSearchResults(false);
+	for (const auto item : items) {
+		_searchResults.push_back(
+			std::make_unique<Dialogs::FakeRow>(_searchInChat, item));
+	}
+	_searchResultsLocal = !_searchResults.empty();
+	_searchedCount = _searchResults.size();
+	refresh();
+}
+
+bool DialogsInner::hasLocalSearchResults() const {
+	return _searchResultsLocal;
+}
+
 void DialogsInner::peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
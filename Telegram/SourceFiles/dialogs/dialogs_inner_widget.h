@@ -41,6 +41,8 @@ public:
 		const QVector<MTPMessage> &result,
 		DialogsSearchRequestType type,
 		int fullCount);
+	void searchLocalReceived(std::vector<not_null<HistoryItem*>> &&items);
+	bool hasLocalSearchResults() const;
 	void peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -334,6 +336,7 @@ private:
 	int _peerSearchPressed = -1;
 
 	SearchResults _searchResults;
+	bool _searchResultsLocal = false;
 	int _searchedCount = 0;
 	int _searchedMigratedCount = 0;
 	int _searchedSelected = -1;
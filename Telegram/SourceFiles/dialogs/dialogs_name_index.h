@@ -0,0 +1,137 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/flat_set.h"
+
+namespace Dialogs {
+
+// Sorted index of the name words. All the words starting with some prefix
+// are found by a single lower_bound(), so the filter query doesn't need
+// to check all the names that have a word starting with the same letter.
+template <typename Value>
+class NameIndex {
+public:
+	void add(const Value &value, const base::flat_set<QString> &words);
+	void remove(const Value &value);
+	void clear();
+
+	// Returns values having a word starting with each of the query words,
+	// sorted by Value operator<().
+	std::vector<Value> find(const QStringList &query) const;
+
+private:
+	void collect(const QString &prefix, std::vector<Value> &result) const;
+	bool hasWordWithPrefix(const Value &value, const QString &prefix) const;
+
+	std::map<QString, base::flat_set<Value>> _values;
+	std::map<Value, base::flat_set<QString>> _words;
+
+};
+
+template <typename Value>
+void NameIndex<Value>::add(
+		const Value &value,
+		const base::flat_set<QString> &words) {
+	remove(value);
+	if (words.empty()) {
+		return;
+	}
+	for (const auto &word : words) {
+		_values[word].insert(value);
+	}
+	_words.emplace(value, words);
+}
+
+template <typename Value>
+void NameIndex<Value>::remove(const Value &value) {
+	const auto i = _words.find(value);
+	if (i == _words.end()) {
+		return;
+	}
+	for (const auto &word : i->second) {
+		const auto j = _values.find(word);
+		if (j != _values.end()) {
+			j->second.erase(value);
+			if (j->second.empty()) {
+				_values.erase(j);
+			}
+		}
+	}
+	_words.erase(i);
+}
+
+template <typename Value>
+void NameIndex<Value>::clear() {
+	_values.clear();
+	_words.clear();
+}
+
+template <typename Value>
+std::vector<Value> NameIndex<Value>::find(const QStringList &query) const {
+	auto result = std::vector<Value>();
+	if (query.isEmpty()) {
+		return result;
+	}
+
+	// The longest word usually has the least values to start with.
+	const auto longest = std::max_element(
+		query.begin(),
+		query.end(),
+		[](const QString &a, const QString &b) {
+			return a.size() < b.size();
+		});
+	collect(*longest, result);
+	for (auto i = query.begin(); i != query.end(); ++i) {
+		if (i == longest || result.empty()) {
+			continue;
+		}
+		const auto &prefix = *i;
+		result.erase(ranges::remove_if(result, [&](const Value &value) {
+			return !hasWordWithPrefix(value, prefix);
+		}), result.end());
+	}
+	return result;
+}
+
+template <typename Value>
+void NameIndex<Value>::collect(
+		const QString &prefix,
+		std::vector<Value> &result) const {
+	auto singleWord = true;
+	for (auto i = _values.lower_bound(prefix); i != _values.end(); ++i) {
+		if (!i->first.startsWith(prefix)) {
+			break;
+		} else if (!result.empty()) {
+			singleWord = false;
+		}
+		result.insert(result.end(), i->second.begin(), i->second.end());
+	}
+	if (!singleWord) {
+		ranges::sort(result);
+		result.erase(ranges::unique(result), result.end());
+	}
+}
+
+template <typename Value>
+bool NameIndex<Value>::hasWordWithPrefix(
+		const Value &value,
+		const QString &prefix) const {
+	const auto i = _words.find(value);
+	if (i == _words.end()) {
+		return false;
+	}
+	for (const auto &word : i->second) {
+		if (word.startsWith(prefix)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace Dialogs
@@ -0,0 +1,162 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include <QtCore/QStringList>
+#include <map>
+#include "dialogs/dialogs_name_index.h"
+#include "base/tests_benchmark.h"
+#include <random>
+
+using Dialogs::NameIndex;
+
+QString RandomWord(std::mt19937 &generator, int letters) {
+	auto length = std::uniform_int_distribution<int>(1, 8)(generator);
+	auto letter = std::uniform_int_distribution<int>(0, letters - 1);
+	auto result = QString();
+	while (length--) {
+		result.append(QChar('a' + letter(generator)));
+	}
+	return result;
+}
+
+base::flat_set<QString> RandomName(std::mt19937 &generator, int letters) {
+	auto count = std::uniform_int_distribution<int>(1, 3)(generator);
+	auto result = base::flat_set<QString>();
+	while (count--) {
+		result.insert(RandomWord(generator, letters));
+	}
+	return result;
+}
+
+// The same check DialogsInner::onFilterUpdate() did for each row.
+bool NameMatches(
+		const base::flat_set<QString> &name,
+		const QStringList &query) {
+	if (name.empty()) {
+		return false;
+	}
+	for (const auto &word : query) {
+		const auto found = ranges::find_if(name, [&](const QString &part) {
+			return part.startsWith(word);
+		});
+		if (found == name.end()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<int> FindLinear(
+		const std::vector<base::flat_set<QString>> &names,
+		const QStringList &query) {
+	auto result = std::vector<int>();
+	for (auto i = 0, count = int(names.size()); i != count; ++i) {
+		if (NameMatches(names[i], query)) {
+			result.push_back(i);
+		}
+	}
+	return result;
+}
+
+TEST_CASE("name index finds words by prefix", "[name_index]") {
+	auto index = NameIndex<int>();
+	index.add(1, { "john", "smith" });
+	index.add(2, { "johnny", "cash" });
+	index.add(3, { "jane", "smithson" });
+
+	REQUIRE(index.find({}).empty());
+	REQUIRE((index.find({ "j" }) == std::vector<int>{ 1, 2, 3 }));
+	REQUIRE((index.find({ "john" }) == std::vector<int>{ 1, 2 }));
+	REQUIRE((index.find({ "smith", "j" }) == std::vector<int>{ 1, 3 }));
+	REQUIRE((index.find({ "smiths", "ja" }) == std::vector<int>{ 3 }));
+	REQUIRE((index.find({ "johnny", "smith" }).empty()));
+	REQUIRE(index.find({ "x" }).empty());
+
+	SECTION("names are replaced") {
+		index.add(1, { "bob" });
+		REQUIRE(index.find({ "john" }) == std::vector<int>{ 2 });
+		REQUIRE(index.find({ "b" }) == std::vector<int>{ 1 });
+	}
+	SECTION("names are removed") {
+		index.remove(2);
+		index.remove(4);
+		REQUIRE(index.find({ "john" }) == std::vector<int>{ 1 });
+		REQUIRE(index.find({ "cash" }).empty());
+	}
+	SECTION("index is cleared") {
+		index.clear();
+		REQUIRE(index.find({ "j" }).empty());
+	}
+}
+
+TEST_CASE("name index finds the same as linear filter", "[name_index]") {
+	auto generator = std::mt19937(42);
+	auto names = std::vector<base::flat_set<QString>>(5000);
+	auto index = NameIndex<int>();
+	for (auto i = 0; i != int(names.size()); ++i) {
+		names[i] = RandomName(generator, 5);
+		index.add(i, names[i]);
+	}
+	for (auto i = 0; i < int(names.size()); i += 7) {
+		names[i] = RandomName(generator, 5);
+		index.add(i, names[i]);
+	}
+	for (auto i = 3; i < int(names.size()); i += 11) {
+		names[i].clear();
+		index.remove(i);
+	}
+	for (auto i = 0; i != 1000; ++i) {
+		auto query = QStringList();
+		for (auto j = i % 3; j >= 0; --j) {
+			query.push_back(RandomWord(generator, 5).mid(0, 1 + (i % 4)));
+		}
+		INFO(query.join(' ').toStdString());
+		REQUIRE((index.find(query) == FindLinear(names, query)));
+	}
+}
+
+TEST_CASE("name index typing benchmark", "[.][benchmark][name_index]") {
+	auto generator = std::mt19937(42);
+	auto names = std::vector<base::flat_set<QString>>(50000);
+	auto index = NameIndex<int>();
+	for (auto i = 0; i != int(names.size()); ++i) {
+		names[i] = RandomName(generator, 26);
+		index.add(i, names[i]);
+	}
+
+	// Imitate typing two words, each keystroke filters from scratch.
+	auto keystrokes = std::vector<QStringList>();
+	for (auto i = 0; i != 200; ++i) {
+		const auto first = RandomWord(generator, 26);
+		const auto second = RandomWord(generator, 26);
+		for (auto j = 1; j <= first.size(); ++j) {
+			keystrokes.push_back({ first.mid(0, j) });
+		}
+		for (auto j = 1; j <= second.size(); ++j) {
+			keystrokes.push_back({ first, second.mid(0, j) });
+		}
+	}
+
+	const auto measure = [&](const char *name, auto &&method) {
+		return base::test::benchmark(name, [&] {
+			auto found = 0;
+			for (const auto &query : keystrokes) {
+				found += method(query).size();
+			}
+			return found;
+		});
+	};
+	const auto linear = measure("linear filter", [&](const QStringList &query) {
+		return FindLinear(names, query);
+	});
+	const auto indexed = measure("name index", [&](const QStringList &query) {
+		return index.find(query);
+	});
+	REQUIRE(linear == indexed);
+}
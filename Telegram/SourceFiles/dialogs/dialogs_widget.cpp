@@ -132,6 +132,11 @@ DialogsWidget::DialogsWidget(QWidget *parent, not_null<Window::Controller*> cont
 		}, lifetime());
 	}
 
+	Auth().data().messagesSearchIndex().loaded(
+	) | rpl::start_with_next([=](PeerId peerId) {
+		searchLocalUpdated(peerId);
+	}, lifetime());
+
 	subscribe(Adaptive::Changed(), [this] { updateForwardBar(); });
 
 	_cancelSearch->setClickedCallback([this] { onCancelSearch(); });
@@ -605,10 +610,58 @@ bool DialogsWidget::searchForPeersRequired(const QString &query) const {
 
 void DialogsWidget::onNeedSearchMessages() {
 	if (!onSearchMessages(true)) {
+		searchLocal();
 		_searchTimer.start(AutoSearchTimeout);
 	}
 }
 
+void DialogsWidget::searchLocal() {
+	const auto peer = _searchInChat.peer();
+	const auto query = _filter->getLastText().trimmed();
+	if (!peer || _searchFromUser || query.isEmpty()) {
+		return;
+	}
+	const auto channel = peer->asChannel();
+	const auto channelId = peerToChannel(peer->id);
+	const auto peerId = peer->id;
+	const auto ids = Auth().data().messagesSearchIndex().query(
+		peerId,
+		query);
+	auto items = std::vector<not_null<HistoryItem*>>();
+	auto requested = 0;
+	for (const auto msgId : ids) {
+		if (const auto item = App::histItemById(channelId, msgId)) {
+			items.push_back(item);
+			if (int(items.size()) == SearchPerPage) {
+				break;
+			}
+		} else if (requested < SearchPerPage
+			&& !_searchLocalRequested.contains({ channelId, msgId })) {
+			// Indexed in one of the previous launches and not loaded yet.
+			_searchLocalRequested.emplace(channelId, msgId);
+			Auth().api().requestMessageData(
+				channel,
+				msgId,
+				crl::guard(this, [=](ChannelData*, MsgId) {
+					searchLocalUpdated(peerId);
+				}));
+			++requested;
+		}
+	}
+	_inner->searchLocalReceived(std::move(items));
+}
+
+void DialogsWidget::searchLocalUpdated(PeerId peerId) {
+	const auto peer = _searchInChat.peer();
+	if (!peer || peer->id != peerId) {
+		return;
+	}
+	const auto query = _filter->getLastText().trimmed();
+	if (!_searchCache.contains(query)) {
+		searchLocal();
+	}
+}
+
 void DialogsWidget::onChooseByDrag() {
 	_inner->chooseRow();
 }
@@ -646,7 +699,8 @@ void DialogsWidget::searchMessages(
 }
 
 void DialogsWidget::onSearchMore() {
-	if (!_searchRequest) {
+	// Local results are replaced by the first page of the server results.
+	if (!_searchRequest && !_inner->hasLocalSearchResults()) {
 		if (!_searchFull) {
 			auto offsetDate = _inner->lastSearchDate();
 			auto offsetPeer = _inner->lastSearchPeer();
@@ -1067,6 +1121,7 @@ void DialogsWidget::setSearchInChat(Dialogs::Key chat, UserData *from) {
 void DialogsWidget::clearSearchCache() {
 	_searchCache.clear();
 	_searchQueries.clear();
+	_searchLocalRequested.clear();
 	_searchQuery = QString();
 	_searchQueryFrom = nullptr;
 	MTP::cancel(base::take(_searchRequest));
@@ -154,6 +154,8 @@ private:
 
 	void setupConnectingWidget();
 	bool searchForPeersRequired(const QString &query) const;
+	void searchLocal();
+	void searchLocalUpdated(PeerId peerId);
 	void setSearchInChat(Dialogs::Key chat, UserData *from = nullptr);
 	void showJumpToDate();
 	void showSearchFrom();
@@ -222,6 +224,8 @@ private:
 	using SearchQueries = QMap<mtpRequestId, QString>;
 	SearchQueries _searchQueries;
 
+	base::flat_set<FullMsgId> _searchLocalRequested;
+
 	using PeerSearchCache = QMap<QString, MTPcontacts_Found>;
 	PeerSearchCache _peerSearchCache;
 
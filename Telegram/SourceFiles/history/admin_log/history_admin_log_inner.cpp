@@ -220,9 +220,9 @@ InnerWidget::InnerWidget(
 	setMouseTracking(true);
 	_scrollDateHideTimer.setCallback([this] { scrollDateHideByTimer(); });
 	Auth().data().viewRepaintRequest(
-	) | rpl::start_with_next([this](auto view) {
-		if (view->delegate() == this) {
-			repaintItem(view);
+	) | rpl::start_with_next([this](const Data::Session::ViewRepaint &request) {
+		if (request.view->delegate() == this) {
+			repaintItem(request.view, request.rect);
 		}
 	}, lifetime());
 	Auth().data().viewResizeRequest(
@@ -1643,11 +1643,15 @@ int InnerWidget::itemTop(not_null<const Element*> view) const {
 	return _itemsTop + view->y();
 }
 
-void InnerWidget::repaintItem(const Element *view) {
+void InnerWidget::repaintItem(const Element *view, QRect rect) {
 	if (!view) {
 		return;
 	}
-	update(0, itemTop(view), width(), view->height());
+	const auto top = itemTop(view);
+	const auto full = QRect(0, top, width(), view->height());
+	update(rect.isEmpty()
+		? full
+		: rect.translated(0, top).intersected(full));
 }
 
 void InnerWidget::resizeItem(not_null<Element*> view) {
@@ -51,6 +51,7 @@ constexpr auto kStatusShowClientsideChooseContact = 6000;
 constexpr auto kStatusShowClientsidePlayGame = 10000;
 constexpr auto kSetMyActionForMs = 10000;
 constexpr auto kNewBlockEachMessage = 50;
+constexpr auto kResizeBlocksAround = 1;
 constexpr auto kSkipCloudDraftsFor = TimeId(3);
 
 void checkForSwitchInlineButton(HistoryItem *item) {
@@ -656,10 +657,21 @@ HistoryItem *History::createItem(
 			result->removeMainView();
 		}
 		if (message.type() == mtpc_message) {
-			const auto media = message.c_message().has_media()
-				? &message.c_message().vmedia
-				: nullptr;
-			result->updateSentMedia(media);
+			const auto &data = message.c_message();
+			const auto edited = result->Get<HistoryMessageEdited>();
+			const auto editDate = data.has_edit_date()
+				? data.vedit_date.v
+				: TimeId(0);
+
+			// The item could be created from an outdated source, like
+			// the cached last page, and edited on the server after that.
+			if ((edited ? edited->date : TimeId(0)) != editDate) {
+				result->applyEdition(data);
+			} else {
+				result->updateSentMedia(data.has_media()
+					? &data.vmedia
+					: nullptr);
+			}
 		}
 		return result;
 	}
@@ -2424,14 +2436,43 @@ void History::resizeToWidth(int newWidth) {
 	_flags &= ~(Flag::f_has_pending_resized_items);
 
 	_width = newWidth;
+
+	// When the width changes only the blocks around the scroll position
+	// are resized, the rest will be resized when they are scrolled to.
+	const auto count = int(blocks.size());
+	const auto anchor = scrollTopItem
+		? scrollTopItem->block()->indexInHistory()
+		: (count - 1);
+	const auto from = anchor - kResizeBlocksAround;
+	const auto till = anchor + kResizeBlocksAround + 1;
 	int y = 0;
-	for (const auto &block : blocks) {
+	for (auto index = 0; index != count; ++index) {
+		const auto &block = blocks[index];
+		const auto estimate = (index < from || index >= till)
+			&& block->heightEstimated(newWidth);
 		block->setY(y);
-		y += block->resizeGetHeight(newWidth, resizeAllItems);
+		y += estimate ? block->height() : block->resizeGetHeight(newWidth);
 	}
 	_height = y;
 }
 
+bool History::requestBlocksResize(int top, int bottom) {
+	auto result = false;
+	for (const auto &block : blocks) {
+		if (block->y() >= bottom) {
+			break;
+		} else if (block->y() + block->height() > top
+			&& block->heightEstimated(_width)) {
+			block->requestResize();
+			result = true;
+		}
+	}
+	if (result) {
+		setHasPendingResizedItems();
+	}
+	return result;
+}
+
 ChannelId History::channelId() const {
 	return peerToChannel(peer->id);
 }
@@ -2658,6 +2699,7 @@ QVector<MsgId> History::collectMessagesFromUserToDelete(
 
 void History::clear() {
 	clearBlocks(false);
+	Auth().data().messagesSearchIndex().clear(peer->id);
 }
 
 void History::unloadBlocks() {
@@ -2787,7 +2829,11 @@ HistoryBlock::HistoryBlock(not_null<History*> history)
 : _history(history) {
 }
 
-int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
+int HistoryBlock::resizeGetHeight(int newWidth) {
+	const auto resizeAllItems = (_width != newWidth);
+	_width = newWidth;
+	_resizeRequested = false;
+
 	auto y = 0;
 	for (const auto &message : messages) {
 		message->setY(y);
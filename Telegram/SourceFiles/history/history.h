@@ -251,6 +251,12 @@ public:
 	void resizeToWidth(int newWidth);
 	int height() const;
 
+	// Blocks far from the scroll position are not resized when the width
+	// changes, their heights stay as estimates until they are requested.
+	// Returns true if some estimated blocks in [top, bottom) were found,
+	// they will be resized in the next resizeToWidth() call.
+	bool requestBlocksResize(int top, int bottom);
+
 	void itemRemoved(not_null<HistoryItem*> item);
 	void itemVanished(not_null<HistoryItem*> item);
 
@@ -544,7 +550,13 @@ public:
 	void remove(not_null<Element*> view);
 	void refreshView(not_null<Element*> view);
 
-	int resizeGetHeight(int newWidth, bool resizeAllItems);
+	int resizeGetHeight(int newWidth);
+	bool heightEstimated(int width) const {
+		return (_width > 0) && (_width != width) && !_resizeRequested;
+	}
+	void requestResize() {
+		_resizeRequested = true;
+	}
 	int y() const {
 		return _y;
 	}
@@ -587,7 +599,9 @@ protected:
 	const not_null<History*> _history;
 
 	int _y = 0;
+	int _width = 0;
 	int _height = 0;
 	int _indexInHistory = -1;
+	bool _resizeRequested = false;
 
 };
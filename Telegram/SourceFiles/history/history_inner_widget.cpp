@@ -19,6 +19,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_message.h"
 #include "history/view/history_view_service_message.h"
 #include "history/view/history_view_cursor_state.h"
+#include "history/view/history_view_paint_profiler.h"
 #include "ui/text_options.h"
 #include "ui/widgets/popup_menu.h"
 #include "window/window_controller.h"
@@ -157,8 +158,8 @@ HistoryInner::HistoryInner(
 		mouseActionCancel();
 	}, lifetime());
 	Auth().data().viewRepaintRequest(
-	) | rpl::start_with_next([this](not_null<const Element*> view) {
-		repaintItem(view);
+	) | rpl::start_with_next([this](const Data::Session::ViewRepaint &request) {
+		repaintItem(request.view, request.rect);
 	}, lifetime());
 	Auth().data().viewLayoutChanged(
 	) | rpl::filter([](not_null<const Element*> view) {
@@ -205,13 +206,16 @@ void HistoryInner::repaintItem(const HistoryItem *item) {
 	repaintItem(item->mainView());
 }
 
-void HistoryInner::repaintItem(const Element *view) {
+void HistoryInner::repaintItem(const Element *view, QRect rect) {
 	if (_widget->skipItemRepaint()) {
 		return;
 	}
 	const auto top = itemTop(view);
 	if (top >= 0) {
-		update(0, top, width(), view->height());
+		const auto full = QRect(0, top, width(), view->height());
+		update(rect.isEmpty()
+			? full
+			: rect.translated(0, top).intersected(full));
 	}
 }
 
@@ -582,7 +586,9 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 					view,
 					selfromy - mtop,
 					seltoy - mtop);
+				const auto profiler = HistoryView::PaintProfiler();
 				view->draw(p, clip.translated(0, -y), selection, ms);
+				profiler.finish(p, width());
 
 				if (item->hasViews()) {
 					App::main()->scheduleViewIncrement(item);
@@ -628,7 +634,9 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 						view,
 						selfromy - htop,
 						seltoy - htop);
+					const auto profiler = HistoryView::PaintProfiler();
 					view->draw(p, hclip.translated(0, -y), selection, ms);
+					profiler.finish(p, width());
 
 					if (item->hasViews()) {
 						App::main()->scheduleViewIncrement(item);
@@ -2905,6 +2913,26 @@ bool HistoryInner::hasPendingResizedItems() const {
 		|| (_migrated && _migrated->hasPendingResizedItems());
 }
 
+bool HistoryInner::requestEstimatedBlocksResize(int top, int bottom) {
+	// Request the blocks one screen above and below the visible area
+	// as well, so that they're ready before they are scrolled to.
+	const auto margin = bottom - top;
+	const auto request = [&](History *history, int historyTop) {
+		if (!history
+			|| historyTop < 0
+			|| !history->requestBlocksResize(
+				top - margin - historyTop,
+				bottom + margin - historyTop)) {
+			return false;
+		}
+		Auth().data().notifyHistoryChangeDelayed(history);
+		return true;
+	};
+	const auto history = request(_history, historyTop());
+	const auto migrated = request(_migrated, migratedTop());
+	return history || migrated;
+}
+
 void HistoryInner::deleteAsGroup(FullMsgId itemId) {
 	if (const auto item = App::histItemById(itemId)) {
 		const auto group = Auth().data().groups().find(item);
@@ -61,7 +61,7 @@ public:
 	void updateSize();
 
 	void repaintItem(const HistoryItem *item);
-	void repaintItem(const Element *view);
+	void repaintItem(const Element *view, QRect rect = QRect());
 
 	bool canCopySelected() const;
 	bool canDeleteSelected() const;
@@ -80,6 +80,10 @@ public:
 	// updates history->scrollTopItem/scrollTopOffset
 	void visibleAreaUpdated(int top, int bottom);
 
+	// Marks the blocks with estimated heights around the visible area
+	// as pending resize, returns true if there were any.
+	bool requestEstimatedBlocksResize(int top, int bottom);
+
 	int historyHeight() const;
 	int historyScrollTop() const;
 	int migratedTop() const;
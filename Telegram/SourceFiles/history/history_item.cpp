@@ -250,6 +250,8 @@ void HistoryItem::destroy() {
 					types,
 					id));
 			}
+			Auth().data().messagesSearchIndex().remove(this);
+			Auth().data().historyCache().itemRemoved(this);
 		} else {
 			Auth().api().cancelLocalItem(this);
 		}
@@ -214,7 +214,7 @@ void HistoryFileMedia::step_radial(TimeMs ms, bool timer) {
 	};
 	if (timer) {
 		if (!anim::Disabled() || updateRadial()) {
-			Auth().data().requestViewRepaint(_parent);
+			repaintRadial();
 		}
 	} else {
 		updateRadial();
@@ -224,6 +224,19 @@ void HistoryFileMedia::step_radial(TimeMs ms, bool timer) {
 	}
 }
 
+void HistoryFileMedia::repaintRadial() const {
+	// The status text changes only with the progress, while the
+	// progress is the same only the radial animation is repainted.
+	const auto progress = dataProgress();
+	if (_animation->radialRect.isEmpty()
+		|| _animation->radialProgress != progress) {
+		_animation->radialProgress = progress;
+		Auth().data().requestViewRepaint(_parent);
+	} else {
+		Auth().data().requestViewRepaint(_parent, _animation->radialRect);
+	}
+}
+
 void HistoryFileMedia::ensureAnimation() const {
 	if (!_animation) {
 		_animation = std::make_unique<AnimationData>(animation(const_cast<HistoryFileMedia*>(this), &HistoryFileMedia::step_radial));
@@ -473,6 +486,7 @@ void HistoryPhoto::draw(Painter &p, const QRect &r, TextSelection selection, Tim
 		p.setOpacity(1);
 		if (radial) {
 			QRect rinner(inner.marginsRemoved(QMargins(st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine)));
+			_animation->radialRect = _parent->paintedRect(p, inner);
 			_animation->radial.draw(p, rinner, st::msgFileRadialLine, selected ? st::historyFileThumbRadialFgSelected : st::historyFileThumbRadialFg);
 		}
 	}
@@ -648,6 +662,7 @@ void HistoryPhoto::drawGrouped(
 			const auto color = selected
 				? st::historyFileThumbRadialFgSelected
 				: st::historyFileThumbRadialFg;
+			_animation->radialRect = _parent->paintedRect(p, inner);
 			_animation->radial.draw(p, rinner, line, color);
 		}
 	}
@@ -922,6 +937,7 @@ void HistoryVideo::draw(Painter &p, const QRect &r, TextSelection selection, Tim
 	}
 	if (radial) {
 		QRect rinner(inner.marginsRemoved(QMargins(st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine)));
+		_animation->radialRect = _parent->paintedRect(p, inner);
 		_animation->radial.draw(p, rinner, st::msgFileRadialLine, selected ? st::historyFileThumbRadialFgSelected : st::historyFileThumbRadialFg);
 	}
 
@@ -1096,6 +1112,7 @@ void HistoryVideo::drawGrouped(
 		const auto color = selected
 			? st::historyFileThumbRadialFgSelected
 			: st::historyFileThumbRadialFg;
+		_animation->radialRect = _parent->paintedRect(p, inner);
 		_animation->radial.draw(p, rinner, line, color);
 	}
 }
@@ -1461,6 +1478,7 @@ void HistoryDocument::draw(Painter &p, const QRect &r, TextSelection selection,
 				p.setOpacity(1);
 
 				QRect rinner(inner.marginsRemoved(QMargins(st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine)));
+				_animation->radialRect = _parent->paintedRect(p, inner);
 				_animation->radial.draw(p, rinner, st::msgFileRadialLine, selected ? st::historyFileThumbRadialFgSelected : st::historyFileThumbRadialFg);
 			}
 		}
@@ -1501,6 +1519,7 @@ void HistoryDocument::draw(Painter &p, const QRect &r, TextSelection selection,
 		if (radial) {
 			QRect rinner(inner.marginsRemoved(QMargins(st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine)));
 			auto fg = outbg ? (selected ? st::historyFileOutRadialFgSelected : st::historyFileOutRadialFg) : (selected ? st::historyFileInRadialFgSelected : st::historyFileInRadialFg);
+			_animation->radialRect = _parent->paintedRect(p, inner);
 			_animation->radial.draw(p, rinner, st::msgFileRadialLine, fg);
 		}
 
@@ -2277,6 +2296,7 @@ void HistoryGif::draw(Painter &p, const QRect &r, TextSelection selection, TimeM
 		if (radial) {
 			p.setOpacity(1);
 			QRect rinner(inner.marginsRemoved(QMargins(st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine, st::msgFileRadialLine)));
+			_animation->radialRect = _parent->paintedRect(p, inner);
 			_animation->radial.draw(p, rinner, st::msgFileRadialLine, selected ? st::historyFileThumbRadialFgSelected : st::historyFileThumbRadialFg);
 		}
 
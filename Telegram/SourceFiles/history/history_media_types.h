@@ -97,6 +97,7 @@ protected:
 	void setStatusSize(int newSize, int fullSize, int duration, qint64 realDuration) const;
 
 	void step_radial(TimeMs ms, bool timer);
+	void repaintRadial() const;
 	void thumbAnimationCallback();
 
 	void ensureAnimation() const;
@@ -128,6 +129,10 @@ protected:
 		}
 		Animation a_thumbOver;
 		Ui::RadialAnimation radial;
+
+		// Painted rect of the radial animation in the view coordinates.
+		QRect radialRect;
+		float64 radialProgress = -1.;
 	};
 	mutable std::unique_ptr<AnimationData> _animation;
 
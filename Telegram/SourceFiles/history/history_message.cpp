@@ -968,6 +968,8 @@ void HistoryMessage::setText(const TextWithEntities &textWithEntities) {
 	if (_media && _media->consumeMessageText(textWithEntities)) {
 		setEmptyText();
 	} else {
+		Auth().data().messagesSearchIndex().add(this, textWithEntities.text);
+
 		_text.setMarkedText(
 			st::messageTextStyle,
 			textWithEntities,
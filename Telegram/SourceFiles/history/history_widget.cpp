@@ -2034,9 +2034,12 @@ void HistoryWidget::clearDelayedShowAt() {
 void HistoryWidget::clearAllLoadRequests() {
 	clearDelayedShowAt();
 	if (_firstLoadRequest) MTP::cancel(_firstLoadRequest);
+	if (_firstLoadRefreshRequest) MTP::cancel(_firstLoadRefreshRequest);
 	if (_preloadRequest) MTP::cancel(_preloadRequest);
 	if (_preloadDownRequest) MTP::cancel(_preloadDownRequest);
 	_preloadRequest = _preloadDownRequest = _firstLoadRequest = 0;
+	_firstLoadRefreshRequest = 0;
+	_firstLoadCachedIds.clear();
 }
 
 void HistoryWidget::updateFieldSubmitSettings() {
@@ -2491,6 +2494,9 @@ bool HistoryWidget::messagesFailed(const RPCError &error, mtpRequestId requestId
 	} else if (_firstLoadRequest == requestId) {
 		_firstLoadRequest = 0;
 		controller()->showBackFromStack();
+	} else if (_firstLoadRefreshRequest == requestId) {
+		_firstLoadRefreshRequest = 0;
+		controller()->showBackFromStack();
 	} else if (_delayedShowAtRequest == requestId) {
 		_delayedShowAtRequest = 0;
 	}
@@ -2500,12 +2506,14 @@ bool HistoryWidget::messagesFailed(const RPCError &error, mtpRequestId requestId
 void HistoryWidget::messagesReceived(PeerData *peer, const MTPmessages_Messages &messages, mtpRequestId requestId) {
 	if (!_history) {
 		_preloadRequest = _preloadDownRequest = _firstLoadRequest = _delayedShowAtRequest = 0;
+		_firstLoadRefreshRequest = 0;
 		return;
 	}
 
 	bool toMigrated = (peer == _peer->migrateFrom());
 	if (peer != _peer && !toMigrated) {
 		_preloadRequest = _preloadDownRequest = _firstLoadRequest = _delayedShowAtRequest = 0;
+		_firstLoadRefreshRequest = 0;
 		return;
 	}
 
@@ -2581,13 +2589,37 @@ void HistoryWidget::messagesReceived(PeerData *peer, const MTPmessages_Messages
 		} else if (_migrated) {
 			_migrated->unloadBlocks();
 		}
+		if (_firstLoadAtEnd && !toMigrated) {
+			Auth().data().historyCache().saveLastPage(peer, messages);
+		}
+		addMessagesToFront(peer, *histList);
+		_firstLoadRequest = 0;
+		if (_history->loadedAtTop() && _history->isEmpty() && count > 0) {
+			firstLoadMessages();
+			return;
+		}
+
+		historyLoaded();
+	} else if (_firstLoadRefreshRequest == requestId) {
+		_firstLoadRefreshRequest = 0;
+
+		// Replace everything shown from the cache with the server page.
+		if (_preloadRequest) MTP::cancel(_preloadRequest);
+		if (_preloadDownRequest) MTP::cancel(_preloadDownRequest);
+		_preloadRequest = _preloadDownRequest = 0;
+		_history->unloadBlocks();
+		_history->getReadyFor(ShowAtTheEndMsgId);
+		_firstLoadRequest = -1; // hack - don't updateListSize yet
 		addMessagesToFront(peer, *histList);
 		_firstLoadRequest = 0;
+		destroyFirstLoadCachedLeftovers();
+		Auth().data().historyCache().saveLastPage(peer, messages);
 		if (_history->loadedAtTop() && _history->isEmpty() && count > 0) {
 			firstLoadMessages();
 			return;
 		}
 
+		_historyInited = false;
 		historyLoaded();
 	} else if (_delayedShowAtRequest == requestId) {
 		if (toMigrated) {
@@ -2645,6 +2677,7 @@ void HistoryWidget::windowShown() {
 bool HistoryWidget::doWeReadServerHistory() const {
 	if (!_history || !_list) return true;
 	if (_firstLoadRequest || _a_show.animating()) return false;
+	if (_firstLoadRefreshRequest) return false;
 	if (_history->loadedAtBottom()) {
 		int scrollTop = _scroll->scrollTop();
 		if (scrollTop + 1 > _scroll->scrollTopMax()) return true;
@@ -2666,11 +2699,12 @@ bool HistoryWidget::doWeReadServerHistory() const {
 bool HistoryWidget::doWeReadMentions() const {
 	if (!_history || !_list) return true;
 	if (_firstLoadRequest || _a_show.animating()) return false;
+	if (_firstLoadRefreshRequest) return false;
 	return true;
 }
 
 void HistoryWidget::firstLoadMessages() {
-	if (!_history || _firstLoadRequest) return;
+	if (!_history || _firstLoadRequest || _firstLoadRefreshRequest) return;
 
 	auto from = _peer;
 	auto offsetId = 0;
@@ -2724,6 +2758,56 @@ void HistoryWidget::firstLoadMessages() {
 			MTP_int(historyHash)),
 		rpcDone(&HistoryWidget::messagesReceived, from),
 		rpcFail(&HistoryWidget::messagesFailed));
+	_firstLoadAtEnd = (from == _peer) && !offsetId && !offset;
+
+	const auto showAtEnd = (_showAtMsgId == ShowAtTheEndMsgId)
+		|| (_showAtMsgId == ShowAtUnreadMsgId);
+	if (_firstLoadAtEnd && showAtEnd && !_migrated && _history->isEmpty()) {
+		firstLoadFromCache();
+	}
+}
+
+void HistoryWidget::firstLoadFromCache() {
+	const auto history = _history;
+	const auto requestId = _firstLoadRequest;
+	Auth().data().historyCache().loadLastPage(_peer, crl::guard(this, [=](
+			const QVector<MTPMessage> &messages) {
+		if (_history != history
+			|| _firstLoadRequest != requestId
+			|| !_history->isEmpty()) {
+			return;
+		}
+		_firstLoadRefreshRequest = base::take(_firstLoadRequest);
+		_firstLoadRequest = -1; // hack - don't updateListSize yet
+		addMessagesToFront(_peer, messages);
+		_firstLoadRequest = 0;
+		if (_history->isEmpty()) {
+			// Nothing to show, wait for the server page as usual.
+			_history->unloadBlocks();
+			_history->getReadyFor(ShowAtTheEndMsgId);
+			_firstLoadRequest = base::take(_firstLoadRefreshRequest);
+			return;
+		}
+		_firstLoadCachedIds.clear();
+		_firstLoadCachedIds.reserve(messages.size());
+		for (const auto &message : messages) {
+			_firstLoadCachedIds.push_back(idFromMessage(message));
+		}
+		historyLoaded();
+	}));
+}
+
+void HistoryWidget::destroyFirstLoadCachedLeftovers() {
+	// The messages from the cached page that are not in the server page
+	// were deleted while we were offline, don't keep them in memory.
+	const auto channelId = _history->channelId();
+	for (const auto msgId : base::take(_firstLoadCachedIds)) {
+		if (const auto item = App::histItemById(channelId, msgId)) {
+			if (!item->mainView()) {
+				item->destroy();
+			}
+		}
+	}
 }
 
 void HistoryWidget::loadMessages() {
@@ -2885,6 +2969,13 @@ void HistoryWidget::visibleAreaUpdated() {
 		auto scrollTop = _scroll->scrollTop();
 		auto scrollBottom = scrollTop + _scroll->height();
 		_list->visibleAreaUpdated(scrollTop, scrollBottom);
+		if (_list->requestEstimatedBlocksResize(scrollTop, scrollBottom)) {
+			// Resize the blocks right away, so that they're not painted
+			// with the estimated heights even for a single frame.
+			handlePendingHistoryUpdate();
+			scrollTop = _scroll->scrollTop();
+			scrollBottom = scrollTop + _scroll->height();
+		}
 		if (_history->loadedAtBottom() && (_history->unreadCount() > 0 || (_migrated && _migrated->unreadCount() > 0))) {
 			const auto unread = firstUnreadMessage();
 			const auto unreadVisible = unread
@@ -210,6 +210,8 @@ public:
 	void loadMessages();
 	void loadMessagesDown();
 	void firstLoadMessages();
+	void firstLoadFromCache();
+	void destroyFirstLoadCachedLeftovers();
 	void delayedShowAt(MsgId showAtMsgId);
 
 	void newUnreadMsg(
@@ -755,6 +757,12 @@ private:
 	MsgId _showAtMsgId = ShowAtUnreadMsgId;
 
 	mtpRequestId _firstLoadRequest = 0;
+	bool _firstLoadAtEnd = false;
+
+	// The last page was shown from the cache, waiting for the server one.
+	mtpRequestId _firstLoadRefreshRequest = 0;
+	std::vector<MsgId> _firstLoadCachedIds;
+
 	mtpRequestId _preloadRequest = 0;
 	mtpRequestId _preloadDownRequest = 0;
 
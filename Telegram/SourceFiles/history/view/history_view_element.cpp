@@ -177,6 +177,14 @@ void Element::setY(int y) {
 void Element::refreshDataIdHook() {
 }
 
+void Element::rememberPaintOrigin(Painter &p) const {
+	_paintOrigin = p.transform().map(QPoint());
+}
+
+QRect Element::paintedRect(Painter &p, QRect rect) const {
+	return p.transform().mapRect(rect).translated(-_paintOrigin);
+}
+
 void Element::paintHighlight(
 		Painter &p,
 		int geometryHeight) const {
@@ -200,6 +200,12 @@ public:
 		TextSelection selection,
 		TextSelectType type) const;
 
+	// Animations inside the element request a repaint of only the rect
+	// they've painted, in the element coordinates. The painter origin
+	// is remembered by draw() to compute them.
+	void rememberPaintOrigin(Painter &p) const;
+	QRect paintedRect(Painter &p, QRect rect) const;
+
 	// ClickHandlerHost interface.
 	void clickHandlerActiveChanged(
 		const ClickHandlerPtr &handler,
@@ -280,6 +286,7 @@ private:
 
 	int _y = 0;
 	Context _context = Context();
+	mutable QPoint _paintOrigin;
 
 	Flags _flags = Flag::NeedsResize;
 
@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_element.h"
 #include "history/view/history_view_message.h"
 #include "history/view/history_view_service_message.h"
+#include "history/view/history_view_paint_profiler.h"
 #include "history/view/history_view_cursor_state.h"
 #include "chat_helpers/message_field.h"
 #include "mainwindow.h"
@@ -244,9 +245,9 @@ ListWidget::ListWidget(
 	setMouseTracking(true);
 	_scrollDateHideTimer.setCallback([this] { scrollDateHideByTimer(); });
 	Auth().data().viewRepaintRequest(
-	) | rpl::start_with_next([this](auto view) {
-		if (view->delegate() == this) {
-			repaintItem(view);
+	) | rpl::start_with_next([this](const Data::Session::ViewRepaint &request) {
+		if (request.view->delegate() == this) {
+			repaintItem(request.view, request.rect);
 		}
 	}, lifetime());
 	Auth().data().viewResizeRequest(
@@ -1280,11 +1281,13 @@ void ListWidget::paintEvent(QPaintEvent *e) {
 		p.translate(0, top);
 		for (auto i = from; i != to; ++i) {
 			const auto view = *i;
+			const auto profiler = PaintProfiler();
 			view->draw(
 				p,
 				clip.translated(0, -top),
 				itemRenderSelection(view),
 				ms);
+			profiler.finish(p, width());
 			const auto height = view->height();
 			top += height;
 			p.translate(0, height);
@@ -2334,11 +2337,15 @@ int ListWidget::itemTop(not_null<const Element*> view) const {
 	return _itemsTop + view->y();
 }
 
-void ListWidget::repaintItem(const Element *view) {
+void ListWidget::repaintItem(const Element *view, QRect rect) {
 	if (!view) {
 		return;
 	}
-	update(0, itemTop(view), width(), view->height());
+	const auto top = itemTop(view);
+	const auto full = QRect(0, top, width(), view->height());
+	update(rect.isEmpty()
+		? full
+		: rect.translated(0, top).intersected(full));
 }
 
 void ListWidget::repaintItem(FullMsgId itemId) {
@@ -367,6 +367,8 @@ void Message::draw(
 		QRect clip,
 		TextSelection selection,
 		TimeMs ms) const {
+	rememberPaintOrigin(p);
+
 	auto g = countGeometry();
 	if (g.width() < 1) {
 		return;
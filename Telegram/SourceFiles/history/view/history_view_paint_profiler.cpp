@@ -0,0 +1,64 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "history/view/history_view_paint_profiler.h"
+
+#include <chrono>
+
+namespace HistoryView {
+namespace {
+
+// Paints taking longer than that are highlighted.
+constexpr auto kSlowPaint = 1000LL;
+
+bool Enabled = false;
+
+int64 Now() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+		steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool PaintProfilerEnabled() {
+#ifdef _DEBUG
+	return Enabled;
+#else // _DEBUG
+	return false;
+#endif // _DEBUG
+}
+
+void TogglePaintProfiler() {
+	Enabled = !Enabled;
+}
+
+PaintProfiler::PaintProfiler()
+: _started(PaintProfilerEnabled() ? Now() : 0) {
+}
+
+void PaintProfiler::finish(Painter &p, int width) const {
+	if (!_started) {
+		return;
+	}
+	const auto duration = Now() - _started;
+	const auto text = QString::number(duration) + qsl(" us");
+	const auto &font = st::normalFont;
+	const auto textWidth = font->width(text);
+	const auto padding = font->spacew;
+	const auto rect = QRect(
+		width - textWidth - 2 * padding,
+		0,
+		textWidth + 2 * padding,
+		font->height);
+	p.fillRect(rect, QColor(0, 0, 0, 160));
+	p.setFont(font);
+	p.setPen((duration >= kSlowPaint) ? QColor(255, 96, 96) : QColor(255, 255, 255));
+	p.drawTextLeft(rect.x() + padding, rect.y(), width, text, textWidth);
+}
+
+} // namespace HistoryView
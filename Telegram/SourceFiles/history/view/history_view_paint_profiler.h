@@ -0,0 +1,29 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace HistoryView {
+
+// In debug builds the "paintprofiler" code toggles an overlay over the
+// messages with the time their last paint took, partial ones included.
+bool PaintProfilerEnabled();
+void TogglePaintProfiler();
+
+class PaintProfiler {
+public:
+	PaintProfiler();
+
+	// The painter should be at the top left corner of the element.
+	void finish(Painter &p, int width) const;
+
+private:
+	int64 _started = 0;
+
+};
+
+} // namespace HistoryView
@@ -386,6 +386,8 @@ void Service::draw(
 		QRect clip,
 		TextSelection selection,
 		TimeMs ms) const {
+	rememberPaintOrigin(p);
+
 	const auto item = message();
 	auto g = countGeometry();
 	if (g.width() < 1) {
@@ -391,6 +391,24 @@ void Sticker::preload() const {
 	}
 }
 
+void Sticker::pausePreload() const {
+	if (const auto document = getShownDocument()) {
+		document->pauseStickerThumb();
+	} else if (const auto thumb = getResultThumb()) {
+		thumb->pauseLoading();
+	}
+}
+
+bool Sticker::preloaded() const {
+	if (const auto document = getShownDocument()) {
+		const auto image = document->getStickerThumb();
+		return image && image->loaded();
+	} else if (const auto thumb = getResultThumb()) {
+		return thumb->loaded();
+	}
+	return true;
+}
+
 void Sticker::paint(Painter &p, const QRect &clip, const PaintContext *context) const {
 	bool loaded = getShownDocument()->loaded();
 
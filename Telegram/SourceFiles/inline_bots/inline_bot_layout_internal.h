@@ -151,6 +151,8 @@ public:
 		return false;
 	}
 	void preload() const override;
+	void pausePreload() const override;
+	bool preloaded() const override;
 
 	void paint(Painter &p, const QRect &clip, const PaintContext *context) const override;
 	TextState getState(
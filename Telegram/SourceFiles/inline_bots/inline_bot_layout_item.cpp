@@ -84,6 +84,39 @@ void ItemBase::preload() const {
 	}
 }
 
+void ItemBase::pausePreload() const {
+	if (_result) {
+		if (_result->_photo) {
+			_result->_photo->thumb->pauseLoading();
+		} else if (_result->_document) {
+			_result->_document->thumb->pauseLoading();
+		} else if (!_result->_thumb->isNull()) {
+			_result->_thumb->pauseLoading();
+		}
+	} else if (_doc) {
+		_doc->thumb->pauseLoading();
+	} else if (_photo) {
+		_photo->medium->pauseLoading();
+	}
+}
+
+bool ItemBase::preloaded() const {
+	if (_result) {
+		if (_result->_photo) {
+			return _result->_photo->thumb->loaded();
+		} else if (_result->_document) {
+			return _result->_document->thumb->loaded();
+		} else if (!_result->_thumb->isNull()) {
+			return _result->_thumb->loaded();
+		}
+	} else if (_doc) {
+		return _doc->thumb->loaded();
+	} else if (_photo) {
+		return _photo->medium->loaded();
+	}
+	return true;
+}
+
 void ItemBase::update() {
 	if (_position >= 0) {
 		context()->inlineItemRepaint(this);
@@ -77,6 +77,8 @@ public:
 	PhotoData *getPreviewPhoto() const;
 
 	virtual void preload() const;
+	virtual void pausePreload() const;
+	virtual bool preloaded() const;
 
 	void update();
 	void layoutChanged();
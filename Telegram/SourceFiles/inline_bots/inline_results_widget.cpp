@@ -39,7 +39,8 @@ constexpr auto kInlineBotRequestDelay = 400;
 } // namespace
 
 Inner::Inner(QWidget *parent, not_null<Window::Controller*> controller) : TWidget(parent)
-, _controller(controller) {
+, _controller(controller)
+, _prefetch(st::emojiPanMaxHeight) {
 	resize(st::emojiPanWidth - st::emojiScroll.width - st::buttonRadius, st::emojiPanMinHeight);
 
 	setMouseTracking(true);
@@ -78,6 +79,8 @@ void Inner::visibleTopBottomUpdated(
 		_visibleTop = visibleTop;
 		_lastScrolled = getms();
 	}
+	_prefetch.scrolled(visibleTop, visibleBottom);
+	preloadAreas(true);
 }
 
 void Inner::checkRestrictedPeer() {
@@ -265,6 +268,7 @@ void Inner::clearSelection() {
 }
 
 void Inner::hideFinish(bool completely) {
+	_prefetch.finish();
 	if (completely) {
 		auto itemForget = [](auto &item) {
 			if (auto document = item->getDocument()) {
@@ -401,10 +405,52 @@ Inner::Row &Inner::layoutInlineRow(Row &row, int32 sumWidth) {
 }
 
 void Inner::preloadImages() {
-	for (auto row = 0, rows = _rows.size(); row != rows; ++row) {
-		for (auto col = 0, cols = _rows[row].items.size(); col != cols; ++col) {
-			_rows[row].items[col]->preload();
+	preloadAreas(false);
+}
+
+template <typename Callback>
+void Inner::enumerateAreaItems(
+		ChatHelpers::ThumbnailsPrefetch::Area area,
+		Callback callback) const {
+	auto top = st::stickerPanPadding;
+	if (_switchPmButton) {
+		top += _switchPmButton->height() + st::inlineResultsSkip;
+	}
+	for (const auto &row : _rows) {
+		if (top >= area.bottom) {
+			break;
+		} else if (top + row.height > area.top) {
+			for (const auto item : row.items) {
+				callback(item);
+			}
 		}
+		top += row.height;
+	}
+}
+
+void Inner::preloadAreas(bool countShown) {
+	auto items = std::vector<ItemBase*>();
+	const auto areas = _prefetch.prepareAreas();
+	for (auto i = 0, count = int(areas.size()); i != count; ++i) {
+		enumerateAreaItems(areas[i], [&](ItemBase *item) {
+			if (countShown && !i) {
+				_prefetch.shown(item, item->preloaded());
+			}
+			items.push_back(item);
+		});
+	}
+	if (!_prefetch.request(items)) {
+		return;
+	}
+	for (const auto &row : _rows) {
+		for (const auto item : row.items) {
+			if (_prefetch.left(item)) {
+				item->pausePreload();
+			}
+		}
+	}
+	for (const auto item : items) {
+		item->preload();
 	}
 }
 
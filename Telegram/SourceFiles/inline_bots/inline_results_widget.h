@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/effects/panel_animation.h"
 #include "mtproto/sender.h"
 #include "inline_bots/inline_bot_layout_item.h"
+#include "chat_helpers/thumbnails_prefetch.h"
 
 namespace Ui {
 class ScrollArea;
@@ -106,6 +107,11 @@ private:
 	bool isRestrictedView();
 
 	void paintInlineItems(Painter &p, const QRect &r);
+	void preloadAreas(bool countShown);
+	template <typename Callback>
+	void enumerateAreaItems(
+		ChatHelpers::ThumbnailsPrefetch::Area area,
+		Callback callback) const;
 
 	void refreshSwitchPmButton(const CacheEntry *entry);
 
@@ -117,6 +123,7 @@ private:
 	UserData *_inlineBot = nullptr;
 	PeerData *_inlineQueryPeer = nullptr;
 	TimeMs _lastScrolled = 0;
+	ChatHelpers::ThumbnailsPrefetch _prefetch;
 	QTimer _updateInlineItems;
 	bool _inlineWithThumb = false;
 
@@ -0,0 +1,132 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "lang/lang_compiled.h"
+
+namespace Lang {
+namespace {
+
+constexpr auto kCompiledMagic = "TDLP";
+constexpr auto kCompiledVersion = 1;
+
+struct Header {
+	char magic[4] = { 0 };
+	int32 version = 0;
+	uint32 checksum = 0;
+	int32 count = 0;
+};
+
+constexpr auto kOffsetsStart = int(sizeof(Header));
+constexpr auto kOffsetsSize = (kLangKeysCount + 1) * int(sizeof(int32));
+constexpr auto kSetStart = kOffsetsStart + kOffsetsSize;
+constexpr auto kCharsStart = kSetStart + kLangKeysCount;
+
+} // namespace
+
+QByteArray CompiledPack::Compile(
+		const std::vector<QString> &values,
+		const std::vector<uchar> &nonDefaultSet) {
+	Expects(values.size() == kLangKeysCount);
+	Expects(nonDefaultSet.size() == kLangKeysCount);
+
+	auto length = 0;
+	for (auto i = 0; i != kLangKeysCount; ++i) {
+		if (nonDefaultSet[i]) {
+			length += values[i].size();
+		}
+	}
+	auto result = QByteArray(kCharsStart + length * sizeof(ushort), 0);
+	const auto data = result.data();
+
+	auto header = Header();
+	memcpy(header.magic, kCompiledMagic, sizeof(header.magic));
+	header.version = kCompiledVersion;
+	header.checksum = GetKeysChecksum();
+	header.count = kLangKeysCount;
+	memcpy(data, &header, sizeof(header));
+
+	auto offset = int32(0);
+	for (auto i = 0; i != kLangKeysCount; ++i) {
+		memcpy(data + kOffsetsStart + i * sizeof(int32), &offset, sizeof(int32));
+		if (nonDefaultSet[i]) {
+			const auto &value = values[i];
+			data[kSetStart + i] = 1;
+			memcpy(
+				data + kCharsStart + offset * sizeof(ushort),
+				value.constData(),
+				value.size() * sizeof(ushort));
+			offset += value.size();
+		}
+	}
+	memcpy(data + kOffsetsStart + kLangKeysCount * sizeof(int32), &offset, sizeof(int32));
+	return result;
+}
+
+bool CompiledPack::load(const QByteArray &data) {
+	clear();
+	if (data.size() < kCharsStart) {
+		return false;
+	}
+	auto header = Header();
+	memcpy(&header, data.constData(), sizeof(header));
+	if (memcmp(header.magic, kCompiledMagic, sizeof(header.magic))
+		|| header.version != kCompiledVersion
+		|| header.checksum != GetKeysChecksum()
+		|| header.count != kLangKeysCount) {
+		return false;
+	}
+	_data = data;
+	_offsets = _data.constData() + kOffsetsStart;
+	_set = reinterpret_cast<const uchar*>(_data.constData() + kSetStart);
+	_chars = _data.constData() + kCharsStart;
+
+	// Only the offsets are checked, so that value() can't read outside.
+	const auto length = (_data.size() - kCharsStart) / int(sizeof(ushort));
+	auto previous = 0;
+	for (auto i = 0; i <= kLangKeysCount; ++i) {
+		const auto current = offset(i);
+		if (current < previous || current > length) {
+			clear();
+			return false;
+		}
+		previous = current;
+	}
+	return true;
+}
+
+void CompiledPack::clear() {
+	_data = QByteArray();
+	_offsets = nullptr;
+	_set = nullptr;
+	_chars = nullptr;
+}
+
+int CompiledPack::offset(int index) const {
+	auto result = int32();
+	memcpy(&result, _offsets + index * sizeof(int32), sizeof(int32));
+	return result;
+}
+
+bool CompiledPack::isSet(LangKey key) const {
+	Expects(key >= 0 && key < kLangKeysCount);
+
+	return !empty() && _set[key];
+}
+
+QString CompiledPack::value(LangKey key) const {
+	Expects(isSet(key));
+
+	const auto from = offset(key);
+	auto result = QString(offset(key + 1) - from, Qt::Uninitialized);
+	memcpy(
+		result.data(),
+		_chars + from * sizeof(ushort),
+		result.size() * sizeof(ushort));
+	return result;
+}
+
+} // namespace Lang
@@ -0,0 +1,47 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "lang_auto.h"
+
+namespace Lang {
+
+// Parsed values of a lang pack in the layout codegen_lang uses for the
+// default ones: a fixed index offset table into the UTF-16 data.
+//
+// It is written together with the raw values of the lang pack, so that
+// when the pack is loaded nothing is parsed or decoded. The data is kept
+// as is and each value is copied from it when it is used the first time.
+// The data is in the native byte order, it is stored only locally.
+class CompiledPack {
+public:
+	static QByteArray Compile(
+		const std::vector<QString> &values,
+		const std::vector<uchar> &nonDefaultSet);
+
+	// Returns false if the data is broken or was compiled for other keys.
+	bool load(const QByteArray &data);
+	void clear();
+
+	bool empty() const {
+		return _data.isEmpty();
+	}
+	bool isSet(LangKey key) const;
+	QString value(LangKey key) const;
+
+private:
+	int offset(int index) const;
+
+	QByteArray _data;
+	const char *_offsets = nullptr;
+	const uchar *_set = nullptr;
+	const char *_chars = nullptr;
+
+};
+
+} // namespace Lang
@@ -22,6 +22,8 @@ constexpr auto kDefaultLanguage = str_const("en");
 constexpr auto kCloudLangPackName = str_const("tdesktop");
 constexpr auto kLangValuesLimit = 20000;
 
+// Compiled lang packs store the parsed values, so changes of the result
+// format need kValueFormatVersion in codegen_lang to be incremented.
 class ValueParser {
 public:
 	ValueParser(
@@ -196,6 +198,8 @@ void Instance::reset() {
 	_values.clear();
 	_nonDefaultValues.clear();
 	_nonDefaultSet.clear();
+	_compiled.clear();
+	_compiledPending.clear();
 	_legacyId = kLegacyLanguageNone;
 	_customFilePathAbsolute = QString();
 	_customFilePathRelative = QString();
@@ -212,6 +216,7 @@ void Instance::fillDefaults() {
 		_values.emplace_back(GetOriginalValue(LangKey(i)));
 	}
 	_nonDefaultSet = std::vector<uchar>(kLangKeysCount, 0);
+	_compiledPending = std::vector<uchar>(kLangKeysCount, 0);
 }
 
 QString Instance::systemLangCode() const {
@@ -242,6 +247,18 @@ QString Instance::langPackName() const {
 }
 
 QByteArray Instance::serialize() const {
+	auto values = std::vector<QString>();
+	values.reserve(kLangKeysCount);
+	for (auto i = 0; i != kLangKeysCount; ++i) {
+		const auto key = LangKey(i);
+		values.push_back(!_nonDefaultSet[i]
+			? QString()
+			: _compiledPending[i]
+			? _compiled.value(key)
+			: _values[i]);
+	}
+	const auto compiled = CompiledPack::Compile(values, _nonDefaultSet);
+
 	auto size = Serialize::stringSize(_id);
 	size += sizeof(qint32); // version
 	size += Serialize::stringSize(_customFilePathAbsolute) + Serialize::stringSize(_customFilePathRelative);
@@ -250,6 +267,7 @@ QByteArray Instance::serialize() const {
 	for (auto &nonDefault : _nonDefaultValues) {
 		size += Serialize::bytearraySize(nonDefault.first) + Serialize::bytearraySize(nonDefault.second);
 	}
+	size += Serialize::bytearraySize(compiled);
 
 	auto result = QByteArray();
 	result.reserve(size);
@@ -262,6 +280,7 @@ QByteArray Instance::serialize() const {
 		for (auto &nonDefault : _nonDefaultValues) {
 			stream << nonDefault.first << nonDefault.second;
 		}
+		stream << compiled;
 	}
 	return result;
 }
@@ -309,16 +328,44 @@ void Instance::fillFromSerialized(const QByteArray &data) {
 		nonDefaultStrings.push_back(value);
 	}
 
+	// Lang packs serialized by older versions don't have compiled values.
+	auto compiled = QByteArray();
+	if (!stream.atEnd()) {
+		stream >> compiled;
+		if (stream.status() != QDataStream::Ok) {
+			compiled = QByteArray();
+		}
+	}
+
 	_id = id;
 	_version = version;
 	_customFilePathAbsolute = customFilePathAbsolute;
 	_customFilePathRelative = customFilePathRelative;
 	_customFileContent = customFileContent;
+	if (_compiled.load(compiled)) {
+		LOG(("Lang Info: Loaded cached compiled, keys: %1"
+			).arg(nonDefaultValuesCount));
+		for (auto i = 0, count = nonDefaultValuesCount * 2; i != count; i += 2) {
+			_nonDefaultValues[std::move(nonDefaultStrings[i])]
+				= std::move(nonDefaultStrings[i + 1]);
+		}
+		for (auto i = 0; i != kLangKeysCount; ++i) {
+			if (_compiled.isSet(LangKey(i))) {
+				_nonDefaultSet[i] = _compiledPending[i] = 1;
+			}
+		}
+		updatePluralRules();
+		return;
+	}
+
 	LOG(("Lang Info: Loaded cached, keys: %1").arg(nonDefaultValuesCount));
 	for (auto i = 0, count = nonDefaultValuesCount * 2; i != count; i += 2) {
 		applyValue(nonDefaultStrings[i], nonDefaultStrings[i + 1]);
 	}
 	updatePluralRules();
+
+	// Write the compiled values, so that they are not parsed next time.
+	Local::writeLangPack();
 }
 
 void Instance::loadFromContent(const QByteArray &content) {
@@ -478,11 +525,17 @@ QString Instance::getNonDefaultValue(const QByteArray &key) const {
 		: QString();
 }
 
+void Instance::loadCompiledValue(LangKey key) const {
+	_values[key] = _compiled.value(key);
+	_compiledPending[key] = 0;
+}
+
 void Instance::applyValue(const QByteArray &key, const QByteArray &value) {
 	_nonDefaultValues[key] = value;
 	auto index = ParseKeyValue(key, value, _values);
 	if (index != kLangKeysCount) {
 		_nonDefaultSet[index] = 1;
+		_compiledPending[index] = 0;
 	}
 }
 
@@ -508,6 +561,7 @@ void Instance::resetValue(const QByteArray &key) {
 	auto keyIndex = GetKeyIndex(QLatin1String(key));
 	if (keyIndex != kLangKeysCount) {
 		_values[keyIndex] = GetOriginalValue(keyIndex);
+		_compiledPending[keyIndex] = 0;
 	}
 }
 
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <rpl/producer.h>
 #include "lang_auto.h"
+#include "lang/lang_compiled.h"
 #include "base/weak_ptr.h"
 
 namespace Lang {
@@ -79,10 +80,15 @@ public:
 		return _updated;
 	}
 
+	// Loads the value from the compiled pack the first time, not thread safe.
+	// Lang::Current() is used only from the main thread.
 	QString getValue(LangKey key) const {
 		Expects(key >= 0 && key < kLangKeysCount);
 		Expects(_values.size() == kLangKeysCount);
 
+		if (_compiledPending[key]) {
+			loadCompiledValue(key);
+		}
 		return _values[key];
 	}
 	QString getNonDefaultValue(const QByteArray &key) const;
@@ -115,6 +121,7 @@ private:
 		const QByteArray &value,
 		Result &result);
 
+	void loadCompiledValue(LangKey key) const;
 	void applyValue(const QByteArray &key, const QByteArray &value);
 	void resetValue(const QByteArray &key);
 	void reset();
@@ -137,10 +144,15 @@ private:
 
 	mutable QString _systemLanguage;
 
-	std::vector<QString> _values;
+	mutable std::vector<QString> _values;
 	std::vector<uchar> _nonDefaultSet;
 	std::map<QByteArray, QByteArray> _nonDefaultValues;
 
+	// Values of the keys marked here are still in the compiled pack.
+	// They are loaded in getValue(), other const methods don't load them.
+	CompiledPack _compiled;
+	mutable std::vector<uchar> _compiledPending;
+
 };
 
 } // namespace Lang
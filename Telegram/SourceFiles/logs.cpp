@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/connection.h"
 #include "core/crash_reports.h"
 #include "core/launcher.h"
+#include "base/bounded_queue.h"
 
 enum LogDataType {
 	LogDataMain,
@@ -105,6 +106,26 @@ public:
 		file->flush();
 	}
 
+	// Only LogsWriter thread writes debug logs, so they're not locked.
+	void writeQueued(LogDataType type, const QString &msg) {
+		Expects(type != LogDataMain);
+
+		reopenDebug();
+		const auto file = files[type].get();
+		if (file && file->isOpen()) {
+			file->write(msg.toUtf8());
+		}
+	}
+
+	void flushQueued() {
+		for (const auto type : { LogDataDebug, LogDataTcp, LogDataMtp }) {
+			const auto file = files[type].get();
+			if (file && file->isOpen()) {
+				file->flush();
+			}
+		}
+	}
+
 private:
 	std::unique_ptr<QFile> files[LogDataCount];
 
@@ -233,6 +254,128 @@ NEW LOGGING INSTANCE STARTED!!!\n\
 
 LogsDataFields *LogsData = 0;
 
+// Debug, tcp and mtp logs are written from the network threads a lot,
+// so they're passed to a separate thread that writes and flushes them
+// in batches. If the queue is full the lines are dropped and counted.
+class LogsWriter : public QThread {
+public:
+	LogsWriter();
+
+	void push(LogDataType type, const QString &msg);
+
+	// Writes the queued lines in the calling thread. Gives up if the
+	// writer thread doesn't finish its batch in time, for example if it
+	// is the thread that crashed.
+	void flush();
+
+	void stop();
+
+protected:
+	void run() override;
+
+private:
+	struct Entry {
+		LogDataType type = LogDataDebug;
+		QString msg;
+	};
+
+	static constexpr auto kQueueSize = 16384;
+	static constexpr auto kFlushDelay = 100; // ms
+
+	void writeQueued();
+
+	base::bounded_queue<Entry> _queue;
+	std::atomic<int> _dropped = { 0 };
+	QMutex _writeMutex;
+	QMutex _mutex;
+	QWaitCondition _wake;
+	bool _stopping = false;
+
+};
+
+LogsWriter::LogsWriter() : _queue(kQueueSize) {
+}
+
+void LogsWriter::push(LogDataType type, const QString &msg) {
+	if (!_queue.try_push({ type, msg })) {
+		++_dropped;
+	}
+}
+
+void LogsWriter::flush() {
+	constexpr auto kFlushTimeout = 100; // ms
+	if (_writeMutex.tryLock(kFlushTimeout)) {
+		writeQueued();
+		_writeMutex.unlock();
+	}
+}
+
+void LogsWriter::stop() {
+	{
+		QMutexLocker lock(&_mutex);
+		_stopping = true;
+	}
+	_wake.wakeOne();
+	wait();
+
+	// Write the lines pushed while the thread was finishing.
+	flush();
+
+	QMutexLocker lock(&_mutex);
+	_stopping = false;
+}
+
+void LogsWriter::run() {
+	auto stopping = false;
+	while (!stopping) {
+		{
+			QMutexLocker lock(&_mutex);
+			if (!_stopping) {
+				_wake.wait(&_mutex, kFlushDelay);
+			}
+			stopping = _stopping;
+		}
+		QMutexLocker lock(&_writeMutex);
+		writeQueued();
+	}
+}
+
+void LogsWriter::writeQueued() {
+	auto entry = Entry();
+	auto written = false;
+	while (_queue.try_pop(entry)) {
+		LogsData->writeQueued(entry.type, entry.msg);
+		written = true;
+	}
+	if (written) {
+		LogsData->flushQueued();
+	}
+	if (const auto dropped = _dropped.exchange(0)) {
+		// The main log is written right away and gets to crash reports.
+		LOG(("Logs Error: Dropped %1 debug lines, the queue was full."
+			).arg(dropped));
+	}
+}
+
+// Other threads may still be pushing lines while the logs finish,
+// so the writer is never destroyed, it is only stopped.
+LogsWriter &LogsWriterInstance() {
+	static LogsWriter result;
+	return result;
+}
+std::atomic<bool> LogsWriterStarted = { false };
+
+void LogsWriterStart() {
+	LogsWriterInstance().start();
+	LogsWriterStarted = true;
+}
+
+void LogsWriterStop() {
+	if (LogsWriterStarted.exchange(false)) {
+		LogsWriterInstance().stop();
+	}
+}
+
 typedef QList<QPair<LogDataType, QString> > LogsInMemoryList;
 LogsInMemoryList *LogsInMemory = 0;
 LogsInMemoryList *DeletedLogsInMemory = SharedMemoryLocation<LogsInMemoryList, 0>();
@@ -241,8 +384,10 @@ QString LogsBeforeSingleInstanceChecked; // LogsInMemory already dumped in LogsD
 
 void _logsWrite(LogDataType type, const QString &msg) {
 	if (LogsData && (type == LogDataMain || LogsStartIndexChosen < 0)) {
-		if (type == LogDataMain || Logs::DebugEnabled()) {
+		if (type == LogDataMain) {
 			LogsData->write(type, msg);
+		} else if (Logs::DebugEnabled() && LogsWriterStarted) {
+			LogsWriterInstance().push(type, msg);
 		}
 	} else if (LogsInMemory != DeletedLogsInMemory) {
 		if (!LogsInMemory) {
@@ -446,6 +591,7 @@ void start(not_null<Core::Launcher*> launcher) {
 }
 
 void finish() {
+	LogsWriterStop();
 	delete LogsData;
 	LogsData = 0;
 
@@ -463,10 +609,19 @@ bool started() {
 	return LogsData != 0;
 }
 
+void flush() {
+	if (LogsData && LogsWriterStarted) {
+		LogsWriterInstance().flush();
+	}
+}
+
 bool instanceChecked() {
 	if (!LogsData) return false;
 
+	LogsWriterStart();
 	if (!LogsData->instanceChecked()) {
+		LogsWriterStop();
+
 		LogsBeforeSingleInstanceChecked = Logs::full();
 
 		delete LogsData;
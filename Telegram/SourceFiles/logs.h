@@ -22,6 +22,9 @@ void start(not_null<Core::Launcher*> launcher);
 bool started();
 void finish();
 
+// Writes the queued debug lines synchronously, before a crash.
+void flush();
+
 bool instanceChecked();
 void multipleInstances();
 
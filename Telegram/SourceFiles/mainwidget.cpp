@@ -46,6 +46,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_service_message.h"
 #include "history/view/history_view_element.h"
 #include "lang/lang_keys.h"
+#include "core/updates_replay.h"
 #include "lang/lang_cloud_manager.h"
 #include "boxes/add_contact_box.h"
 #include "storage/file_upload.h"
@@ -93,6 +94,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
+// After a long offline period hundreds of channels may need a difference,
+// they are requested a few at a time, the open chat and the ones with the
+// most unread messages first.
+constexpr auto kChannelDifferencesParallel = 8;
+constexpr auto kChannelDifferencesLogEach = 20;
+
 bool IsForceLogoutNotification(const MTPDupdateServiceNotification &data) {
 	return qs(data.vtype).startsWith(qstr("AUTH_KEY_DROP_"));
 }
@@ -1097,6 +1104,7 @@ void MainWidget::deleteConversation(
 			history->markFullyLoaded();
 		}
 	}
+	Auth().data().messagesSearchIndex().clear(peer->id);
 	if (const auto channel = peer->asChannel()) {
 		channel->ptsWaitingForShortPoll(-1);
 	}
@@ -3253,6 +3261,11 @@ void MainWidget::updSetState(int32 pts, int32 date, int32 qts, int32 seq) {
 void MainWidget::gotChannelDifference(
 		ChannelData *channel,
 		const MTPupdates_ChannelDifference &diff) {
+	Core::RecordUpdates(
+		Core::UpdatesRecordType::ChannelDifference,
+		diff,
+		channel->bareId());
+
 	_channelFailDifferenceTimeout.remove(channel);
 
 	int32 timeout = 0;
@@ -3319,13 +3332,21 @@ void MainWidget::gotChannelDifference(
 
 void MainWidget::feedChannelDifference(
 		const MTPDupdates_channelDifference &data) {
-	App::feedUsers(data.vusers);
-	App::feedChats(data.vchats);
+	Core::TraceUpdatesStage("App::feedUsers", [&] {
+		App::feedUsers(data.vusers);
+	});
+	Core::TraceUpdatesStage("App::feedChats", [&] {
+		App::feedChats(data.vchats);
+	});
 
 	_handlingChannelDifference = true;
 	feedMessageIds(data.vother_updates);
-	App::feedMsgs(data.vnew_messages, NewMessageUnread);
-	feedUpdateVector(data.vother_updates, true);
+	Core::TraceUpdatesStage("App::feedMsgs", [&] {
+		App::feedMsgs(data.vnew_messages, NewMessageUnread);
+	});
+	Core::TraceUpdatesStage("feedUpdateVector", [&] {
+		feedUpdateVector(data.vother_updates, true);
+	});
 	_handlingChannelDifference = false;
 }
 
@@ -3333,11 +3354,16 @@ bool MainWidget::failChannelDifference(ChannelData *channel, const RPCError &err
 	if (MTP::isDefaultHandledError(error)) return false;
 
 	LOG(("RPC Error in getChannelDifference: %1 %2: %3").arg(error.code()).arg(error.type()).arg(error.description()));
+	_channelDifferencesSent.remove(channel);
 	failDifferenceStartTimerFor(channel);
+	sendChannelDifferences();
+	checkChannelDifferencesFinished();
 	return true;
 }
 
 void MainWidget::gotState(const MTPupdates_State &state) {
+	Core::RecordUpdates(Core::UpdatesRecordType::State, state);
+
 	auto &d = state.c_updates_state();
 	updSetState(d.vpts.v, d.vdate.v, d.vqts.v, d.vseq.v);
 
@@ -3350,6 +3376,8 @@ void MainWidget::gotState(const MTPupdates_State &state) {
 }
 
 void MainWidget::gotDifference(const MTPupdates_Difference &difference) {
+	Core::RecordUpdates(Core::UpdatesRecordType::Difference, difference);
+
 	_failDifferenceTimeout = 1;
 
 	switch (difference.type()) {
@@ -3474,11 +3502,19 @@ void MainWidget::feedDifference(
 		const MTPVector<MTPMessage> &msgs,
 		const MTPVector<MTPUpdate> &other) {
 	Auth().checkAutoLock();
-	App::feedUsers(users);
-	App::feedChats(chats);
+	Core::TraceUpdatesStage("App::feedUsers", [&] {
+		App::feedUsers(users);
+	});
+	Core::TraceUpdatesStage("App::feedChats", [&] {
+		App::feedChats(chats);
+	});
 	feedMessageIds(other);
-	App::feedMsgs(msgs, NewMessageUnread);
-	feedUpdateVector(other, true);
+	Core::TraceUpdatesStage("App::feedMsgs", [&] {
+		App::feedMsgs(msgs, NewMessageUnread);
+	});
+	Core::TraceUpdatesStage("feedUpdateVector", [&] {
+		feedUpdateVector(other, true);
+	});
 }
 
 bool MainWidget::failDifference(const RPCError &error) {
@@ -3542,7 +3578,7 @@ void MainWidget::onGetDifferenceTimeAfterFail() {
 }
 
 void MainWidget::getDifference() {
-	if (this != App::main()) return;
+	if (this != App::main() || Core::UpdatesReplaying()) return;
 
 	_getDifferenceTimeByPts = 0;
 
@@ -3560,7 +3596,9 @@ void MainWidget::getDifference() {
 }
 
 void MainWidget::getChannelDifference(ChannelData *channel, ChannelDifferenceRequest from) {
-	if (this != App::main() || !channel) return;
+	if (this != App::main() || !channel || Core::UpdatesReplaying()) {
+		return;
+	}
 
 	if (from != ChannelDifferenceRequest::PtsGapOrShortPoll) {
 		_channelGetDifferenceTimeByPts.remove(channel);
@@ -3574,14 +3612,101 @@ void MainWidget::getChannelDifference(ChannelData *channel, ChannelDifferenceReq
 
 	channel->ptsSetRequesting(true);
 
-	auto filter = MTP_channelMessagesFilterEmpty();
 	auto flags = MTPupdates_GetChannelDifference::Flag::f_force | 0;
 	if (from != ChannelDifferenceRequest::PtsGapOrShortPoll) {
 		if (!channel->ptsWaitingForSkipped()) {
 			flags = 0; // No force flag when requesting for short poll.
 		}
 	}
-	MTP::send(MTPupdates_GetChannelDifference(MTP_flags(flags), channel->inputChannel, filter, MTP_int(channel->pts()), MTP_int(MTPChannelGetDifferenceLimit)), rpcDone(&MainWidget::gotChannelDifference, channel), rpcFail(&MainWidget::failChannelDifference, channel));
+	if (!_channelDifferencesStarted) {
+		_channelDifferencesStarted = getms(true);
+		_channelDifferencesApplied = 0;
+	}
+	_channelDifferencesQueued.emplace(
+		channel,
+		MTPupdates_GetChannelDifference::Flags(flags));
+	sendChannelDifferences();
+}
+
+int MainWidget::channelDifferencePriority(
+		not_null<ChannelData*> channel) const {
+	if (_controller->activeChatCurrent().peer() == channel) {
+		return std::numeric_limits<int>::max();
+	} else if (const auto history = App::historyLoaded(channel->id)) {
+		return history->unreadCount();
+	}
+	return 0;
+}
+
+void MainWidget::sendChannelDifferences() {
+	while (!_channelDifferencesQueued.empty()
+		&& (int(_channelDifferencesSent.size())
+			< kChannelDifferencesParallel)) {
+		auto best = _channelDifferencesQueued.begin();
+		auto bestPriority = channelDifferencePriority(best->first);
+		for (auto i = std::next(best); i != _channelDifferencesQueued.end(); ++i) {
+			const auto priority = channelDifferencePriority(i->first);
+			if (priority > bestPriority) {
+				best = i;
+				bestPriority = priority;
+			}
+		}
+		const auto channel = best->first;
+		const auto flags = best->second;
+		_channelDifferencesQueued.erase(best);
+		_channelDifferencesSent.emplace(channel);
+
+		MTP::send(
+			MTPupdates_GetChannelDifference(
+				MTP_flags(flags),
+				channel->inputChannel,
+				MTP_channelMessagesFilterEmpty(),
+				MTP_int(channel->pts()),
+				MTP_int(MTPChannelGetDifferenceLimit)),
+			rpcDone(&MainWidget::channelDifferenceReceived, channel.get()),
+			rpcFail(&MainWidget::failChannelDifference, channel.get()));
+	}
+}
+
+void MainWidget::channelDifferenceReceived(
+		ChannelData *channel,
+		const MTPupdates_ChannelDifference &difference) {
+	_channelDifferencesSent.remove(channel);
+	_channelDifferencesReceived.emplace_back(channel, difference);
+	if (_channelDifferencesReceived.size() == 1) {
+		crl::on_main(this, [=] { applyChannelDifferences(); });
+	}
+	sendChannelDifferences();
+}
+
+void MainWidget::applyChannelDifferences() {
+	// All the results received in one main loop iteration are applied
+	// together, so that a burst of them doesn't interleave with painting.
+	const auto received = base::take(_channelDifferencesReceived);
+	for (const auto &[channel, difference] : received) {
+		gotChannelDifference(channel, difference);
+		if (!(++_channelDifferencesApplied % kChannelDifferencesLogEach)) {
+			DEBUG_LOG(("Channels Difference: %1 applied, %2 left."
+				).arg(_channelDifferencesApplied
+				).arg(int(_channelDifferencesQueued.size()
+					+ _channelDifferencesSent.size())));
+		}
+	}
+	Auth().data().sendHistoryChangeNotifications();
+	checkChannelDifferencesFinished();
+}
+
+void MainWidget::checkChannelDifferencesFinished() {
+	if (!_channelDifferencesStarted
+		|| !_channelDifferencesQueued.empty()
+		|| !_channelDifferencesSent.empty()
+		|| !_channelDifferencesReceived.empty()) {
+		return;
+	}
+	DEBUG_LOG(("Channels Difference: %1 differences applied in %2 ms."
+		).arg(_channelDifferencesApplied
+		).arg(getms(true) - _channelDifferencesStarted));
+	_channelDifferencesStarted = 0;
 }
 
 void MainWidget::mtpPing() {
@@ -3596,7 +3721,11 @@ void MainWidget::start() {
 	cSetOtherOnline(0);
 	Auth().user()->loadUserpic();
 
-	MTP::send(MTPupdates_GetState(), rpcDone(&MainWidget::gotState));
+	if (Core::UpdatesReplaying()) {
+		Core::StartUpdatesReplay(this);
+	} else {
+		MTP::send(MTPupdates_GetState(), rpcDone(&MainWidget::gotState));
+	}
 	update();
 
 	_started = true;
@@ -4131,7 +4260,7 @@ void MainWidget::checkIdleFinish() {
 }
 
 void MainWidget::updateReceived(const mtpPrime *from, const mtpPrime *end) {
-	if (end <= from) return;
+	if (end <= from || Core::UpdatesReplaying()) return;
 
 	Auth().checkAutoLock();
 
@@ -4146,8 +4275,13 @@ void MainWidget::updateReceived(const mtpPrime *from, const mtpPrime *end) {
 		return getDifference();
 	} else {
 		try {
+			const auto start = from;
 			MTPUpdates updates;
 			updates.read(from, end);
+			Core::RecordUpdates(
+				Core::UpdatesRecordType::Updates,
+				start,
+				from);
 
 			_lastUpdateTime = getms(true);
 			noUpdatesTimer.start(NoUpdatesTimeout);
@@ -503,6 +503,14 @@ private:
 
 	bool getDifferenceTimeChanged(ChannelData *channel, int32 ms, ChannelGetDifferenceTime &channelCurTime, TimeMs &curTime);
 
+	int channelDifferencePriority(not_null<ChannelData*> channel) const;
+	void sendChannelDifferences();
+	void channelDifferenceReceived(
+		ChannelData *channel,
+		const MTPupdates_ChannelDifference &difference);
+	void applyChannelDifferences();
+	void checkChannelDifferencesFinished();
+
 	void viewsIncrementDone(QVector<MTPint> ids, const MTPVector<MTPint> &result, mtpRequestId req);
 	bool viewsIncrementFail(const RPCError &error, mtpRequestId req);
 
@@ -574,6 +582,16 @@ private:
 	TimeMs _getDifferenceTimeByPts = 0;
 	TimeMs _getDifferenceTimeAfterFail = 0;
 
+	base::flat_map<
+		not_null<ChannelData*>,
+		MTPupdates_GetChannelDifference::Flags> _channelDifferencesQueued;
+	base::flat_set<not_null<ChannelData*>> _channelDifferencesSent;
+	std::vector<std::pair<
+		not_null<ChannelData*>,
+		MTPupdates_ChannelDifference>> _channelDifferencesReceived;
+	TimeMs _channelDifferencesStarted = 0;
+	int _channelDifferencesApplied = 0;
+
 	SingleTimer _byPtsTimer;
 
 	QMap<int32, MTPUpdates> _bySeqUpdates;
@@ -502,7 +502,7 @@ void Mixer::onUpdated(const AudioMsgId &audio) {
 void Mixer::onError(const AudioMsgId &audio) {
 	emit stoppedOnError(audio);
 
-	QMutexLocker lock(&AudioMutex);
+	internal::AudioLocker lock;
 	auto type = audio.type();
 	if (type == AudioMsgId::Type::Voice) {
 		if (auto current = trackForType(type)) {
@@ -516,7 +516,7 @@ void Mixer::onError(const AudioMsgId &audio) {
 void Mixer::onStopped(const AudioMsgId &audio) {
 	emit updated(audio);
 
-	QMutexLocker lock(&AudioMutex);
+	internal::AudioLocker lock;
 	auto type = audio.type();
 	if (type == AudioMsgId::Type::Voice) {
 		if (auto current = trackForType(type)) {
@@ -629,7 +629,7 @@ void Mixer::play(
 	AudioMsgId stopped;
 	auto notLoadedYet = false;
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		Audio::AttachToDevice();
 		if (!AudioDevice) return;
 
@@ -730,13 +730,15 @@ void Mixer::feedFromVideo(VideoSoundPart &&part) {
 TimeMs Mixer::getVideoCorrectedTime(const AudioMsgId &audio, TimeMs frameMs, TimeMs systemMs) {
 	auto result = frameMs;
 
-	QMutexLocker lock(&AudioMutex);
-	auto type = audio.type();
-	auto track = trackForType(type);
-	if (track && track->state.id == audio && track->lastUpdateWhen > 0) {
-		result = static_cast<TimeMs>(track->lastUpdateCorrectedMs);
-		if (systemMs > track->lastUpdateWhen) {
-			result += (systemMs - track->lastUpdateWhen);
+	const auto published = publishedState(audio.type());
+	if (!published) {
+		return result;
+	}
+	const auto track = published->load();
+	if (track.state.id == audio && track.lastUpdateWhen > 0) {
+		result = static_cast<TimeMs>(track.lastUpdateCorrectedMs);
+		if (systemMs > track.lastUpdateWhen) {
+			result += (systemMs - track.lastUpdateWhen);
 		}
 	}
 
@@ -746,7 +748,7 @@ TimeMs Mixer::getVideoCorrectedTime(const AudioMsgId &audio, TimeMs frameMs, Tim
 void Mixer::videoSoundProgress(const AudioMsgId &audio) {
 	auto type = audio.type();
 
-	QMutexLocker lock(&AudioMutex);
+	internal::AudioLocker lock;
 
 	auto current = trackForType(type);
 	if (current && current->state.length && current->state.frequency) {
@@ -771,7 +773,7 @@ bool Mixer::checkCurrentALError(AudioMsgId::Type type) {
 void Mixer::pause(const AudioMsgId &audio, bool fast) {
 	AudioMsgId current;
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		auto type = audio.type();
 		auto track = trackForType(type);
 		if (!track || track->state.id != audio) {
@@ -818,7 +820,7 @@ void Mixer::pause(const AudioMsgId &audio, bool fast) {
 void Mixer::resume(const AudioMsgId &audio, bool fast) {
 	AudioMsgId current;
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		auto type = audio.type();
 		auto track = trackForType(type);
 		if (!track || track->state.id != audio) {
@@ -874,7 +876,7 @@ void Mixer::resume(const AudioMsgId &audio, bool fast) {
 }
 
 void Mixer::seek(AudioMsgId::Type type, TimeMs positionMs) {
-	QMutexLocker lock(&AudioMutex);
+	internal::AudioLocker lock;
 
 	const auto current = trackForType(type);
 	const auto audio = current->state.id;
@@ -942,7 +944,7 @@ void Mixer::seek(AudioMsgId::Type type, TimeMs positionMs) {
 void Mixer::stop(const AudioMsgId &audio) {
 	AudioMsgId current;
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		auto type = audio.type();
 		auto track = trackForType(type);
 		if (!track || track->state.id != audio) {
@@ -965,7 +967,7 @@ void Mixer::stop(const AudioMsgId &audio, State state) {
 
 	AudioMsgId current;
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		auto type = audio.type();
 		auto track = trackForType(type);
 		if (!track || track->state.id != audio || IsStopped(track->state.state)) {
@@ -986,7 +988,7 @@ void Mixer::stop(const AudioMsgId &audio, State state) {
 void Mixer::stopAndClear() {
 	Track *current_audio = nullptr, *current_song = nullptr;
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		if ((current_audio = trackForType(AudioMsgId::Type::Voice))) {
 			setStoppedState(current_audio);
 		}
@@ -1001,7 +1003,7 @@ void Mixer::stopAndClear() {
 		emit updated(current_audio->state.id);
 	}
 	{
-		QMutexLocker lock(&AudioMutex);
+		internal::AudioLocker lock;
 		auto clearAndCancel = [this](AudioMsgId::Type type, int index) {
 			auto track = trackForType(type, index);
 			if (track->state.id) {
@@ -1018,12 +1020,34 @@ void Mixer::stopAndClear() {
 }
 
 TrackState Mixer::currentState(AudioMsgId::Type type) {
-	QMutexLocker lock(&AudioMutex);
-	auto current = trackForType(type);
-	if (!current) {
-		return TrackState();
+	if (const auto published = publishedState(type)) {
+		return published->load().state;
 	}
-	return current->state;
+	return TrackState();
+}
+
+base::seqlock<Mixer::PublishedState> *Mixer::publishedState(AudioMsgId::Type type) {
+	switch (type) {
+	case AudioMsgId::Type::Voice: return &_publishedAudio;
+	case AudioMsgId::Type::Song: return &_publishedSong;
+	case AudioMsgId::Type::Video: return &_publishedVideo;
+	}
+	return nullptr;
+}
+
+// Thread: Any. Must be locked: AudioMutex.
+void Mixer::publishStates() {
+	const auto publish = [&](AudioMsgId::Type type) {
+		const auto track = trackForType(type);
+		auto published = PublishedState();
+		published.state = track->state;
+		published.lastUpdateWhen = track->lastUpdateWhen;
+		published.lastUpdateCorrectedMs = track->lastUpdateCorrectedMs;
+		publishedState(type)->store(published);
+	};
+	publish(AudioMsgId::Type::Voice);
+	publish(AudioMsgId::Type::Song);
+	publish(AudioMsgId::Type::Video);
 }
 
 void Mixer::setStoppedState(Track *current, State state) {
@@ -1036,7 +1060,7 @@ void Mixer::setStoppedState(Track *current, State state) {
 }
 
 void Mixer::clearStoppedAtStart(const AudioMsgId &audio) {
-	QMutexLocker lock(&AudioMutex);
+	internal::AudioLocker lock;
 	auto track = trackForType(audio.type());
 	if (track && track->state.id == audio && track->state.state == State::StoppedAtStart) {
 		setStoppedState(track);
@@ -1117,7 +1141,7 @@ void Fader::onInit() {
 }
 
 void Fader::onTimer() {
-	QMutexLocker lock(&AudioMutex);
+	internal::AudioLocker lock;
 	if (!mixer()) return;
 
 	auto volumeChangedAll = false;
@@ -1352,6 +1376,28 @@ QMutex *audioPlayerMutex() {
 	return &AudioMutex;
 }
 
+AudioLocker::AudioLocker() : _locked(true) {
+	AudioMutex.lock();
+}
+
+void AudioLocker::unlock() {
+	if (!_locked) {
+		return;
+	}
+	_locked = false;
+
+	// All the track state changes are done under AudioMutex, so the
+	// states can't change until the next lock.
+	if (const auto instance = mixer()) {
+		instance->publishStates();
+	}
+	AudioMutex.unlock();
+}
+
+AudioLocker::~AudioLocker() {
+	unlock();
+}
+
 // Thread: Any.
 bool audioCheckError() {
 	return !Audio::PlaybackErrorHappened();
@@ -1381,7 +1427,7 @@ bool CheckAudioDeviceConnected() {
 
 // Thread: Main. Locks: AudioMutex.
 void DetachFromDevice() {
-	QMutexLocker lock(&AudioMutex);
+	AudioLocker lock;
 	Audio::ClosePlaybackDevice();
 	if (mixer()) {
 		mixer()->reattachIfNeeded();
@@ -1534,7 +1580,6 @@ public:
 		buffer.reserve(AudioVoiceMsgBufferSize);
 		int64 countbytes = sampleSize() * samplesCount();
 		int64 processed = 0;
-		int64 sumbytes = 0;
 		if (samplesCount() < Media::Player::kWaveformSamplesCount) {
 			return false;
 		}
@@ -1543,15 +1588,11 @@ public:
 		peaks.reserve(Media::Player::kWaveformSamplesCount);
 
 		auto fmt = format();
-		auto peak = uint16(0);
-		auto callback = [&](uint16 sample) {
-			accumulate_max(peak, sample);
-			sumbytes += Media::Player::kWaveformSamplesCount;
-			if (sumbytes >= countbytes) {
-				sumbytes -= countbytes;
-				peaks.push_back(peak);
-				peak = 0;
-			}
+		auto counter = Media::Audio::PeaksCounter(
+			Media::Player::kWaveformSamplesCount,
+			countbytes);
+		auto callback = [&](uint16 peak) {
+			peaks.push_back(peak);
 		};
 		while (processed < countbytes) {
 			buffer.resize(0);
@@ -1567,14 +1608,14 @@ public:
 
 			auto sampleBytes = bytes::make_span(buffer);
 			if (fmt == AL_FORMAT_MONO8 || fmt == AL_FORMAT_STEREO8) {
-				Media::Audio::IterateSamples<uchar>(sampleBytes, callback);
+				counter.feed<uchar>(sampleBytes, callback);
 			} else if (fmt == AL_FORMAT_MONO16 || fmt == AL_FORMAT_STEREO16) {
-				Media::Audio::IterateSamples<int16>(sampleBytes, callback);
+				counter.feed<int16>(sampleBytes, callback);
 			}
 			processed += sampleSize() * samples;
 		}
-		if (sumbytes > 0 && peaks.size() < Media::Player::kWaveformSamplesCount) {
-			peaks.push_back(peak);
+		if (counter.accumulated() > 0 && peaks.size() < Media::Player::kWaveformSamplesCount) {
+			peaks.push_back(counter.peak());
 		}
 
 		if (peaks.isEmpty()) {
@@ -1582,7 +1623,7 @@ public:
 		}
 
 		auto sum = std::accumulate(peaks.cbegin(), peaks.cend(), 0LL);
-		peak = qMax(int32(sum * 1.8 / peaks.size()), 2500);
+		auto peak = uint16(qMax(int32(sum * 1.8 / peaks.size()), 2500));
 
 		result.resize(peaks.size());
 		for (int32 i = 0, l = peaks.size(); i != l; ++i) {
@@ -9,6 +9,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "storage/localimageloader.h"
 #include "base/bytes.h"
+#include "base/seqlock.h"
+#include "media/media_audio_peaks.h"
 
 struct VideoSoundData;
 struct VideoSoundPart;
@@ -123,6 +125,8 @@ public:
 
 	void stopAndClear();
 
+	// Thread: Any. Doesn't lock, returns the state published on the
+	// last AudioMutex unlock.
 	TrackState currentState(AudioMsgId::Type type);
 
 	void clearStoppedAtStart(const AudioMsgId &audio);
@@ -136,6 +140,9 @@ public:
 	// Thread: Any. Must be locked: AudioMutex.
 	void reattachTracks();
 
+	// Thread: Any. Must be locked: AudioMutex.
+	void publishStates();
+
 	// Thread: Any.
 	void setSongVolume(float64 volume);
 	float64 getSongVolume() const;
@@ -222,6 +229,14 @@ private:
 	// Thread: Any. Must be locked: AudioMutex.
 	void setStoppedState(Track *current, State state = State::Stopped);
 
+	// Current track state of each type, readable without AudioMutex.
+	struct PublishedState {
+		TrackState state;
+		TimeMs lastUpdateWhen = 0;
+		TimeMs lastUpdateCorrectedMs = 0;
+	};
+	base::seqlock<PublishedState> *publishedState(AudioMsgId::Type type);
+
 	Track *trackForType(AudioMsgId::Type type, int index = -1); // -1 uses currentIndex(type)
 	const Track *trackForType(AudioMsgId::Type type, int index = -1) const;
 	int *currentIndex(AudioMsgId::Type type);
@@ -235,6 +250,10 @@ private:
 
 	Track _videoTrack;
 
+	base::seqlock<PublishedState> _publishedAudio;
+	base::seqlock<PublishedState> _publishedSong;
+	base::seqlock<PublishedState> _publishedVideo;
+
 	QAtomicInt _volumeVideo;
 	QAtomicInt _volumeSong;
 
@@ -311,6 +330,23 @@ void DetachFromDevice();
 // Thread: Any.
 QMutex *audioPlayerMutex();
 
+// Thread: Any. Locks: AudioMutex.
+// Publishes the track states for Mixer::currentState() when unlocking.
+class AudioLocker {
+public:
+	AudioLocker();
+	AudioLocker(const AudioLocker &other) = delete;
+	AudioLocker &operator=(const AudioLocker &other) = delete;
+
+	void unlock();
+
+	~AudioLocker();
+
+private:
+	bool _locked = false;
+
+};
+
 // Thread: Any.
 bool audioCheckError();
 
@@ -320,27 +356,3 @@ bool audioCheckError();
 } // namespace Media
 
 VoiceWaveform audioCountWaveform(const FileLocation &file, const QByteArray &data);
-
-namespace Media {
-namespace Audio {
-
-TG_FORCE_INLINE uint16 ReadOneSample(uchar data) {
-	return qAbs((static_cast<int16>(data) - 0x80) * 0x100);
-}
-
-TG_FORCE_INLINE uint16 ReadOneSample(int16 data) {
-	return qAbs(data);
-}
-
-template <typename SampleType, typename Callback>
-void IterateSamples(bytes::const_span bytes, Callback &&callback) {
-	auto samplesPointer = reinterpret_cast<const SampleType*>(bytes.data());
-	auto samplesCount = bytes.size() / sizeof(SampleType);
-	auto samplesData = gsl::make_span(samplesPointer, samplesCount);
-	for (auto sampleData : samplesData) {
-		callback(ReadOneSample(sampleData));
-	}
-}
-
-} // namespace Audio
-} // namespace Media
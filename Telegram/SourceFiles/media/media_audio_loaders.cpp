@@ -89,7 +89,7 @@ void Loaders::onStart(const AudioMsgId &audio, qint64 positionMs) {
 	auto type = audio.type();
 	clear(type);
 	{
-		QMutexLocker lock(internal::audioPlayerMutex());
+		internal::AudioLocker lock;
 		if (!mixer()) return;
 
 		auto track = mixer()->trackForType(type);
@@ -150,7 +150,7 @@ void Loaders::loadData(AudioMsgId audio, TimeMs positionMs) {
 		if (res == Result::Error) {
 			if (errAtStart) {
 				{
-					QMutexLocker lock(internal::audioPlayerMutex());
+					internal::AudioLocker lock;
 					if (auto track = checkLoader(type)) {
 						track->state.state = State::StoppedAtStart;
 					}
@@ -173,14 +173,14 @@ void Loaders::loadData(AudioMsgId audio, TimeMs positionMs) {
 			break;
 		}
 
-		QMutexLocker lock(internal::audioPlayerMutex());
+		internal::AudioLocker lock;
 		if (!checkLoader(type)) {
 			clear(type);
 			return;
 		}
 	}
 
-	QMutexLocker lock(internal::audioPlayerMutex());
+	internal::AudioLocker lock;
 	auto track = checkLoader(type);
 	if (!track) {
 		clear(type);
@@ -284,7 +284,7 @@ AudioPlayerLoader *Loaders::setupLoader(
 		SetupError &err,
 		TimeMs positionMs) {
 	err = SetupErrorAtStart;
-	QMutexLocker lock(internal::audioPlayerMutex());
+	internal::AudioLocker lock;
 	if (!mixer()) return nullptr;
 
 	auto track = mixer()->trackForType(audio.type());
@@ -378,7 +378,7 @@ void Loaders::onCancel(const AudioMsgId &audio) {
 	case AudioMsgId::Type::Video: if (_video == audio) clear(audio.type()); break;
 	}
 
-	QMutexLocker lock(internal::audioPlayerMutex());
+	internal::AudioLocker lock;
 	if (!mixer()) return;
 
 	for (auto i = 0; i != kTogetherLimit; ++i) {
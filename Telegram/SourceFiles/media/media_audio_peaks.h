@@ -0,0 +1,98 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/bytes.h"
+#include "base/assertion.h"
+#include "base/algorithm.h"
+
+namespace Media {
+namespace Audio {
+
+TG_FORCE_INLINE uint16 ReadOneSample(uchar data) {
+	return qAbs((static_cast<int16>(data) - 0x80) * 0x100);
+}
+
+TG_FORCE_INLINE uint16 ReadOneSample(int16 data) {
+	return qAbs(data);
+}
+
+template <typename SampleType, typename Callback>
+void IterateSamples(bytes::const_span bytes, Callback &&callback) {
+	auto samplesPointer = reinterpret_cast<const SampleType*>(bytes.data());
+	auto samplesCount = bytes.size() / sizeof(SampleType);
+	auto samplesData = gsl::make_span(samplesPointer, samplesCount);
+	for (auto sampleData : samplesData) {
+		callback(ReadOneSample(sampleData));
+	}
+}
+
+// Independent lanes let the compiler vectorize the loop.
+template <typename SampleType>
+uint16 MaxSample(const SampleType *from, const SampleType *till) {
+	constexpr auto kLanes = 16;
+	uint16 lanes[kLanes] = { 0 };
+	for (; till - from >= kLanes; from += kLanes) {
+		for (auto i = 0; i != kLanes; ++i) {
+			const auto sample = ReadOneSample(from[i]);
+			lanes[i] = (lanes[i] < sample) ? sample : lanes[i];
+		}
+	}
+	auto result = uint16(0);
+	for (const auto lane : lanes) {
+		accumulate_max(result, lane);
+	}
+	for (; from != till; ++from) {
+		accumulate_max(result, ReadOneSample(*from));
+	}
+	return result;
+}
+
+// Finds peaks of the sample groups in consecutive buffers. Each sample
+// adds weight to the current group, it ends when the total reaches size.
+class PeaksCounter {
+public:
+	PeaksCounter(int64 weight, int64 size) : _weight(weight), _size(size) {
+		Expects(weight > 0 && size >= weight);
+	}
+
+	template <typename SampleType, typename Callback>
+	void feed(bytes::const_span bytes, Callback &&callback) {
+		auto from = reinterpret_cast<const SampleType*>(bytes.data());
+		const auto till = from + (bytes.size() / sizeof(SampleType));
+		while (from != till) {
+			const auto left = (_size - _accumulated + _weight - 1) / _weight;
+			const auto count = std::min(int64(till - from), left);
+			accumulate_max(_peak, MaxSample(from, from + count));
+			from += count;
+			_accumulated += count * _weight;
+			if (_accumulated >= _size) {
+				_accumulated -= _size;
+				callback(base::take(_peak));
+			}
+		}
+	}
+
+	// The unfinished group.
+	int64 accumulated() const {
+		return _accumulated;
+	}
+	uint16 peak() const {
+		return _peak;
+	}
+
+private:
+	int64 _weight = 0;
+	int64 _size = 0;
+	int64 _accumulated = 0;
+	uint16 _peak = 0;
+
+};
+
+} // namespace Audio
+} // namespace Media
@@ -0,0 +1,148 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "media/media_audio_peaks.h"
+#include <random>
+#include <limits>
+
+using namespace Media::Audio;
+
+struct Peaks {
+	std::vector<uint16> finished;
+	int64 accumulated = 0;
+	uint16 peak = 0;
+};
+
+bool operator==(const Peaks &a, const Peaks &b) {
+	return (a.finished == b.finished)
+		&& (a.accumulated == b.accumulated)
+		&& (a.peak == b.peak);
+}
+
+template <typename SampleType>
+std::vector<SampleType> RandomSamples(std::mt19937 &generator, int count) {
+	auto values = std::uniform_int_distribution<int>(
+		std::numeric_limits<SampleType>::min(),
+		std::numeric_limits<SampleType>::max());
+	auto result = std::vector<SampleType>(count);
+	for (auto &sample : result) {
+		sample = SampleType(values(generator));
+	}
+	return result;
+}
+
+// Splits the buffer at random sample boundaries, like readMore() does.
+std::vector<bytes::const_span> RandomParts(
+		std::mt19937 &generator,
+		bytes::const_span buffer,
+		int sampleSize) {
+	auto samples = std::uniform_int_distribution<int>(0, 300);
+	auto result = std::vector<bytes::const_span>();
+	while (!buffer.empty()) {
+		const auto size = std::min(
+			samples(generator) * sampleSize,
+			int(buffer.size()));
+		result.push_back(buffer.subspan(0, size));
+		buffer = buffer.subspan(size);
+	}
+	return result;
+}
+
+// Same loop as in the original FFMpegWaveformCounter and Track code.
+template <typename SampleType>
+Peaks ReferencePeaks(
+		const std::vector<bytes::const_span> &parts,
+		int64 weight,
+		int64 size) {
+	auto result = Peaks();
+	auto callback = [&](uint16 sample) {
+		accumulate_max(result.peak, sample);
+		result.accumulated += weight;
+		if (result.accumulated >= size) {
+			result.accumulated -= size;
+			result.finished.push_back(result.peak);
+			result.peak = 0;
+		}
+	};
+	for (const auto part : parts) {
+		IterateSamples<SampleType>(part, callback);
+	}
+	return result;
+}
+
+template <typename SampleType>
+Peaks CounterPeaks(
+		const std::vector<bytes::const_span> &parts,
+		int64 weight,
+		int64 size) {
+	auto result = Peaks();
+	auto counter = PeaksCounter(weight, size);
+	auto callback = [&](uint16 peak) {
+		result.finished.push_back(peak);
+	};
+	for (const auto part : parts) {
+		counter.feed<SampleType>(part, callback);
+	}
+	result.accumulated = counter.accumulated();
+	result.peak = counter.peak();
+	return result;
+}
+
+template <typename SampleType>
+void CheckSamples(
+		std::mt19937 &generator,
+		const std::vector<SampleType> &samples) {
+	constexpr auto kWaveformSamplesCount = 100;
+	const auto sampleSize = int(sizeof(SampleType));
+	const auto buffer = bytes::make_span(samples);
+	const auto countbytes = int64(buffer.size());
+	const auto whole = std::vector<bytes::const_span>{ buffer };
+	const auto parts = RandomParts(generator, buffer, sampleSize);
+
+	// Voice message waveform and Audio::Track peaks.
+	const auto options = std::vector<std::pair<int64, int64>>{
+		{ kWaveformSamplesCount, std::max(countbytes, int64(100)) },
+		{ 1, 1 },
+		{ 1, 7 },
+		{ 1, 441 },
+		{ 3, 3 },
+		{ 5, 17 },
+	};
+	for (const auto &[weight, size] : options) {
+		for (const auto &split : { whole, parts }) {
+			REQUIRE(CounterPeaks<SampleType>(split, weight, size)
+				== ReferencePeaks<SampleType>(split, weight, size));
+		}
+	}
+}
+
+TEST_CASE("peaks counter matches the sample loop", "[media_audio]") {
+	auto generator = std::mt19937(7);
+
+	SECTION("int16 samples") {
+		for (const auto count : { 0, 1, 15, 16, 17, 100, 1000, 48000 }) {
+			CheckSamples(generator, RandomSamples<int16>(generator, count));
+		}
+		const auto extremes = std::vector<int16>{
+			std::numeric_limits<int16>::min(),
+			0,
+			std::numeric_limits<int16>::max(),
+			-1,
+			1,
+		};
+		CheckSamples(generator, extremes);
+	}
+	SECTION("uchar samples") {
+		for (const auto count : { 0, 1, 15, 16, 17, 100, 1000, 48000 }) {
+			CheckSamples(generator, RandomSamples<uchar>(generator, count));
+		}
+		const auto extremes = std::vector<uchar>{ 0, 0x80, 0xFF, 0x7F, 0x81 };
+		CheckSamples(generator, extremes);
+	}
+}
@@ -271,6 +271,13 @@ bool FFMpegReaderImplementation::renderFrame(QImage &to, bool &hasAlpha, const Q
 	return true;
 }
 
+void FFMpegReaderImplementation::skipFrame() {
+	Expects(_frameRead);
+	_frameRead = false;
+
+	av_frame_unref(_frame);
+}
+
 FFMpegReaderImplementation::Rotation FFMpegReaderImplementation::rotationFromDegrees(int degrees) const {
 	switch (degrees) {
 	case 90: return Rotation::Degrees90;
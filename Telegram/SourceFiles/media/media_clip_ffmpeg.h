@@ -30,6 +30,7 @@ public:
 	TimeMs framePresentationTime() const override;
 
 	bool renderFrame(QImage &to, bool &hasAlpha, const QSize &size) override;
+	void skipFrame() override;
 
 	TimeMs durationMs() const override;
 	bool hasAudio() const override {
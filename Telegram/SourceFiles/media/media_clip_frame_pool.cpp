@@ -0,0 +1,132 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/media_clip_frame_pool.h"
+
+namespace Media {
+namespace Clip {
+namespace internal {
+namespace {
+
+constexpr auto kBuffersLimit = 4 * 1024 * 1024;
+constexpr auto kScaledLimit = 8 * 1024 * 1024;
+constexpr auto kScaledLoopFrames = 48;
+constexpr auto kMaxScaledLoopMs = TimeMs(4000);
+
+int64 ImageBytes(const QImage &image) {
+	return int64(image.bytesPerLine()) * image.height();
+}
+
+int64 FrameBytes(const ScaledFrame &frame) {
+	// Pixmap is kept in memory same as the image on the raster platforms.
+	const auto pix = int64(frame.pix.width()) * frame.pix.height() * 4;
+	return ImageBytes(frame.original) + pix;
+}
+
+auto RequestTuple(const FrameRequest &request) {
+	return std::make_tuple(
+		request.factor,
+		request.framew,
+		request.frameh,
+		request.outerw,
+		request.outerh,
+		request.radius,
+		request.corners.value());
+}
+
+} // namespace
+
+bool operator<(const ScaledFrameKey &a, const ScaledFrameKey &b) {
+	if (a.document != b.document) {
+		return (a.document < b.document);
+	} else if (a.positionMs != b.positionMs) {
+		return (a.positionMs < b.positionMs);
+	}
+	return RequestTuple(a.request) < RequestTuple(b.request);
+}
+
+QImage FramePool::takeBuffer(QSize size) {
+	for (auto i = _buffers.begin(); i != _buffers.end(); ++i) {
+		if (i->size() == size) {
+			auto result = std::move(*i);
+			_buffers.erase(i);
+			_buffersBytes -= ImageBytes(result);
+			return result;
+		}
+	}
+	return QImage();
+}
+
+void FramePool::putBuffer(QImage &&image) {
+	// Someone else still uses it, we can't write there.
+	if (image.isNull() || !image.isDetached()) {
+		return;
+	}
+	const auto bytes = ImageBytes(image);
+	if (bytes > kBuffersLimit) {
+		return;
+	}
+	while (_buffersBytes + bytes > kBuffersLimit) {
+		_buffersBytes -= ImageBytes(_buffers.front());
+		_buffers.erase(_buffers.begin());
+	}
+	_buffersBytes += bytes;
+	_buffers.push_back(std::move(image));
+}
+
+bool FramePool::Cacheable(QSize size, TimeMs durationMs) {
+	// A whole loop should fit, otherwise frames get evicted before reuse.
+	const auto bytes = int64(size.width()) * size.height() * 4 * 2;
+	return (durationMs > 0)
+		&& (durationMs <= kMaxScaledLoopMs)
+		&& (bytes * kScaledLoopFrames <= kScaledLimit);
+}
+
+const ScaledFrame *FramePool::findScaled(const ScaledFrameKey &key) {
+	const auto i = _scaled.find(key);
+	if (i == _scaled.end()) {
+		return nullptr;
+	}
+	i->second.lastUsed = ++_scaledUseCounter;
+	return &i->second.frame;
+}
+
+void FramePool::putScaled(
+		const ScaledFrameKey &key,
+		const ScaledFrame &frame) {
+	auto &cached = _scaled[key];
+	_scaledBytes += FrameBytes(frame) - FrameBytes(cached.frame);
+	cached.frame = frame;
+	cached.lastUsed = ++_scaledUseCounter;
+	evictScaled();
+}
+
+void FramePool::evictScaled() {
+	while (_scaledBytes > kScaledLimit && !_scaled.empty()) {
+		const auto oldest = std::min_element(
+			_scaled.begin(),
+			_scaled.end(),
+			[](const auto &a, const auto &b) {
+				return (a.second.lastUsed < b.second.lastUsed);
+			});
+		_scaledBytes -= FrameBytes(oldest->second.frame);
+		auto original = std::move(oldest->second.frame.original);
+		_scaled.erase(oldest);
+		putBuffer(std::move(original));
+	}
+}
+
+void FramePool::clear() {
+	_buffers.clear();
+	_buffersBytes = 0;
+	_scaled.clear();
+	_scaledBytes = 0;
+}
+
+} // namespace internal
+} // namespace Clip
+} // namespace Media
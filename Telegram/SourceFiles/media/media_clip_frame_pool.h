@@ -0,0 +1,65 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "media/media_clip_reader.h"
+
+namespace Media {
+namespace Clip {
+namespace internal {
+
+struct ScaledFrameKey {
+	DocumentId document = 0;
+	TimeMs positionMs = 0;
+	FrameRequest request;
+};
+
+bool operator<(const ScaledFrameKey &a, const ScaledFrameKey &b);
+
+struct ScaledFrame {
+	QImage original;
+	QPixmap pix;
+	bool alpha = true;
+};
+
+// Frame buffers shared by all the readers of one Manager thread.
+//
+// Buffers of the removed readers and evicted frames are given to the next
+// readers of the same size instead of allocating new ones. Recently scaled
+// frames of short GIFs are kept, so that the next loops and other readers
+// of the same GIF at the same size don't scale and round them again.
+class FramePool {
+public:
+	QImage takeBuffer(QSize size);
+	void putBuffer(QImage &&image);
+
+	static bool Cacheable(QSize size, TimeMs durationMs);
+	const ScaledFrame *findScaled(const ScaledFrameKey &key);
+	void putScaled(const ScaledFrameKey &key, const ScaledFrame &frame);
+
+	void clear();
+
+private:
+	struct CachedFrame {
+		ScaledFrame frame;
+		int64 lastUsed = 0;
+	};
+	void evictScaled();
+
+	std::vector<QImage> _buffers;
+	int64 _buffersBytes = 0;
+
+	std::map<ScaledFrameKey, CachedFrame> _scaled;
+	int64 _scaledBytes = 0;
+	int64 _scaledUseCounter = 0;
+
+};
+
+} // namespace internal
+} // namespace Clip
+} // namespace Media
@@ -40,6 +40,9 @@ public:
 	// Render current frame to an image with specific size.
 	virtual bool renderFrame(QImage &to, bool &hasAlpha, const QSize &size) = 0;
 
+	// Drop current frame without rendering, if it was rendered before.
+	virtual void skipFrame() = 0;
+
 	virtual TimeMs durationMs() const = 0;
 	virtual bool hasAudio() const = 0;
 
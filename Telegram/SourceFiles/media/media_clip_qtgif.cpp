@@ -81,6 +81,10 @@ bool QtGifReaderImplementation::renderFrame(QImage &to, bool &hasAlpha, const QS
 	return true;
 }
 
+void QtGifReaderImplementation::skipFrame() {
+	_frame = QImage();
+}
+
 TimeMs QtGifReaderImplementation::durationMs() const {
 	return 0; // not supported
 }
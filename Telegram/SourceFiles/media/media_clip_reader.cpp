@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_document.h"
 #include "storage/file_download.h"
 #include "media/media_clip_ffmpeg.h"
+#include "media/media_clip_frame_pool.h"
 #include "media/media_clip_qtgif.h"
 #include "mainwidget.h"
 #include "mainwindow.h"
@@ -25,6 +26,8 @@ namespace Media {
 namespace Clip {
 namespace {
 
+constexpr auto kStatsLogPeriod = TimeMs(10000);
+
 QVector<QThread*> threads;
 QVector<Manager*> managers;
 
@@ -184,6 +187,12 @@ void Reader::moveToNextWrite() const {
 	}
 }
 
+void Reader::frameShown() {
+	if (managers.size() > _threadIndex) {
+		managers.at(_threadIndex)->frameShown();
+	}
+}
+
 void Reader::callback(Reader *reader, int32 threadIndex, Notification notification) {
 	// check if reader is not deleted already
 	if (managers.size() > threadIndex && managers.at(threadIndex)->carries(reader) && reader->_callback) {
@@ -220,7 +229,9 @@ QPixmap Reader::current(int32 framew, int32 frameh, int32 outerw, int32 outerh,
 
 	auto shouldBePaused = !ms;
 	if (!shouldBePaused) {
-		frame->displayed.storeRelease(1);
+		if (frame->displayed.fetchAndStoreRelease(1) != 1) {
+			frameShown();
+		}
 		if (_autoPausedGif.loadAcquire()) {
 			_autoPausedGif.storeRelease(0);
 			if (managers.size() <= _threadIndex) error();
@@ -270,7 +281,9 @@ QPixmap Reader::current() {
 	auto frame = frameToShow();
 	Assert(frame != nullptr);
 
-	frame->displayed.storeRelease(1);
+	if (frame->displayed.fetchAndStoreRelease(1) != 1) {
+		frameShown();
+	}
 	moveToNextShow();
 	return frame->pix;
 }
@@ -350,7 +363,8 @@ Reader::~Reader() {
 
 class ReaderPrivate {
 public:
-	ReaderPrivate(Reader *reader, const FileLocation &location, const QByteArray &data) : _interface(reader)
+	ReaderPrivate(Reader *reader, not_null<internal::FramePool*> pool, const FileLocation &location, const QByteArray &data) : _interface(reader)
+	, _pool(pool)
 	, _mode(reader->mode())
 	, _audioMsgId(reader->audioMsgId())
 	, _seekPositionMs(reader->seekPositionMs())
@@ -461,7 +475,23 @@ public:
 
 	bool renderFrame() {
 		Assert(frame() != 0 && _request.valid());
-		if (!_implementation->renderFrame(frame()->original, frame()->alpha, QSize(_request.framew, _request.frameh))) {
+		const auto key = scaledFrameKey();
+		if (key) {
+			if (const auto scaled = _pool->findScaled(*key)) {
+				// The decoded frame is still needed for the next ones.
+				_implementation->skipFrame();
+				frame()->original = scaled->original;
+				frame()->pix = scaled->pix;
+				frame()->alpha = scaled->alpha;
+				frame()->when = _nextFrameWhen;
+				frame()->positionMs = _nextFramePositionMs;
+				_frameReused = true;
+				return true;
+			}
+		}
+		const auto size = QSize(_request.framew, _request.frameh);
+		prepareBuffer(frame()->original, size);
+		if (!_implementation->renderFrame(frame()->original, frame()->alpha, size)) {
 			return false;
 		}
 		frame()->original.setDevicePixelRatio(_request.factor);
@@ -469,9 +499,41 @@ public:
 		frame()->pix = PrepareFrame(_request, frame()->original, frame()->alpha, frame()->cache);
 		frame()->when = _nextFrameWhen;
 		frame()->positionMs = _nextFramePositionMs;
+		if (key) {
+			_pool->putScaled(*key, { frame()->original, frame()->pix, frame()->alpha });
+		}
+		_frameReused = false;
 		return true;
 	}
 
+	std::optional<internal::ScaledFrameKey> scaledFrameKey() const {
+		const auto document = _audioMsgId.audio();
+		if (_mode != Reader::Mode::Gif || !document) {
+			return std::nullopt;
+		}
+		const auto size = QSize(
+			std::max(_request.framew, _request.outerw),
+			std::max(_request.frameh, _request.outerh));
+		if (!internal::FramePool::Cacheable(size, _durationMs)) {
+			return std::nullopt;
+		}
+		return internal::ScaledFrameKey{
+			document->id,
+			_nextFramePositionMs,
+			_request };
+	}
+
+	void prepareBuffer(QImage &buffer, QSize size) {
+		if (buffer.size() == size && buffer.isDetached()) {
+			return;
+		}
+		auto pooled = _pool->takeBuffer(size);
+		if (!pooled.isNull()) {
+			_pool->putBuffer(std::move(buffer));
+			buffer = std::move(pooled);
+		}
+	}
+
 	bool init() {
 		if (_data.isEmpty() && QFileInfo(_location->name()).size() <= Storage::kMaxAnimationInMemory) {
 			QFile f(_location->name());
@@ -546,10 +608,14 @@ public:
 	~ReaderPrivate() {
 		stop(Player::State::Stopped);
 		_data.clear();
+		for (auto &frame : _frames) {
+			_pool->putBuffer(std::move(frame.original));
+		}
 	}
 
 private:
 	Reader *_interface;
+	not_null<internal::FramePool*> _pool;
 	State _state = State::Reading;
 	Reader::Mode _mode;
 	AudioMsgId _audioMsgId;
@@ -589,13 +655,17 @@ private:
 
 	bool _autoPausedGif = false;
 	bool _started = false;
+	bool _frameReused = false;
 	TimeMs _videoPausedAtMs = 0;
 
 	friend class Manager;
 
 };
 
-Manager::Manager(QThread *thread) : _processingInThread(0), _needReProcess(false) {
+Manager::Manager(QThread *thread)
+: _processingInThread(0)
+, _needReProcess(false)
+, _framePool(std::make_unique<internal::FramePool>()) {
 	moveToThread(thread);
 	connect(thread, SIGNAL(started()), this, SLOT(process()));
 	connect(thread, SIGNAL(finished()), this, SLOT(finish()));
@@ -609,7 +679,7 @@ Manager::Manager(QThread *thread) : _processingInThread(0), _needReProcess(false
 }
 
 void Manager::append(Reader *reader, const FileLocation &location, const QByteArray &data) {
-	reader->_private = new ReaderPrivate(reader, location, data);
+	reader->_private = new ReaderPrivate(reader, _framePool.get(), location, data);
 	_loadLevel.fetchAndAddRelaxed(AverageGifSize);
 	update(reader);
 }
@@ -746,7 +816,12 @@ Manager::ResultHandleState Manager::handleResult(ReaderPrivate *reader, ProcessR
 				reader->_frame = index;
 			}
 		}
-		return handleResult(reader, reader->finishProcess(ms), ms);
+		const auto finished = reader->finishProcess(ms);
+		if (finished == ProcessResult::CopyFrame) {
+			++_decodedFrames;
+			++(reader->_frameReused ? _reusedFrames : _scaledFrames);
+		}
+		return handleResult(reader, finished, ms);
 	}
 
 	return ResultHandleContinue;
@@ -825,6 +900,7 @@ void Manager::process() {
 	}
 
 	ms = getms();
+	logStats(ms);
 	if (_needReProcess || minms <= ms) {
 		_needReProcess = false;
 		_timer.start(1);
@@ -835,6 +911,29 @@ void Manager::process() {
 	_processingInThread = 0;
 }
 
+void Manager::logStats(TimeMs ms) {
+	if (!_statsStarted) {
+		_statsStarted = ms;
+		return;
+	} else if (ms - _statsStarted < kStatsLogPeriod) {
+		return;
+	}
+	const auto shown = _shownFrames.fetchAndStoreRelaxed(0);
+	if (_decodedFrames || shown) {
+		const auto perSecond = [&](int count) {
+			return QString::number(count * 1000. / (ms - _statsStarted), 'f', 1);
+		};
+		DEBUG_LOG(("Clip Info: frames per second, "
+			"decoded: %1, scaled: %2, reused: %3, shown: %4."
+			).arg(perSecond(_decodedFrames)
+			).arg(perSecond(_scaledFrames)
+			).arg(perSecond(_reusedFrames)
+			).arg(perSecond(shown)));
+	}
+	_decodedFrames = _scaledFrames = _reusedFrames = 0;
+	_statsStarted = ms;
+}
+
 void Manager::finish() {
 	_timer.stop();
 	clear();
@@ -853,6 +952,7 @@ void Manager::clear() {
 		delete i.key();
 	}
 	_readers.clear();
+	_framePool->clear();
 }
 
 Manager::~Manager() {
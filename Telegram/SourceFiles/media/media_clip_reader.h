@@ -13,6 +13,9 @@ class FileLocation;
 
 namespace Media {
 namespace Clip {
+namespace internal {
+class FramePool;
+} // namespace internal
 
 enum class State {
 	Reading,
@@ -153,6 +156,7 @@ private:
 	Frame *frameToWriteNext(bool check, int *index = nullptr) const;
 	void moveToNextShow() const;
 	void moveToNextWrite() const;
+	void frameShown();
 
 	QAtomicInt _autoPausedGif = 0;
 	QAtomicInt _videoPauseRequest = 0;
@@ -195,6 +199,9 @@ public:
 	void update(Reader *reader);
 	void stop(Reader *reader);
 	bool carries(Reader *reader) const;
+	void frameShown() {
+		_shownFrames.fetchAndAddRelaxed(1);
+	}
 	~Manager();
 
 signals:
@@ -226,9 +233,18 @@ private:
 		ResultHandleContinue,
 	};
 	ResultHandleState handleResult(ReaderPrivate *reader, ProcessResult result, TimeMs ms);
+	void logStats(TimeMs ms);
 
 	typedef QMap<ReaderPrivate*, TimeMs> Readers;
 	Readers _readers;
+	std::unique_ptr<internal::FramePool> _framePool;
+
+	// Frames decoded, scaled by this thread and taken from the pool.
+	int _decodedFrames = 0;
+	int _scaledFrames = 0;
+	int _reusedFrames = 0;
+	QAtomicInt _shownFrames = 0;
+	TimeMs _statsStarted = 0;
 
 	QTimer _timer;
 	QThread *_processingInThread;
@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_session.h"
 #include "base/timer.h"
 #include "core/update_checker.h"
+#include "core/startup_trace.h"
 #include "storage/localstorage.h"
 #include "platform/platform_specific.h"
 #include "mainwindow.h"
@@ -90,13 +91,13 @@ Messenger::Messenger(not_null<Core::Launcher*> launcher)
 
 	SingleInstance = this;
 
-	Fonts::Start();
+	Core::TraceStartupPhase("Fonts::Start", [] { Fonts::Start(); });
 
 	ThirdParty::start();
 	Global::start();
 	Sandbox::refreshGlobalProxy(); // Depends on Global::started().
 
-	startLocalStorage();
+	Core::TraceStartupPhase("startLocalStorage", [&] { startLocalStorage(); });
 
 	if (Local::oldSettingsVersion() < AppVersion) {
 		psNewVersion();
@@ -111,10 +112,12 @@ Messenger::Messenger(not_null<Core::Launcher*> launcher)
 	_translator = std::make_unique<Lang::Translator>();
 	QCoreApplication::instance()->installTranslator(_translator.get());
 
-	style::startManager();
+	Core::TraceStartupPhase("style::startManager", [] {
+		style::startManager();
+	});
 	anim::startManager();
 	Ui::InitTextOptions();
-	Ui::Emoji::Init();
+	Core::TraceStartupPhase("Ui::Emoji::Init", [] { Ui::Emoji::Init(); });
 	Media::Player::start();
 
 	DEBUG_LOG(("Application Info: inited..."));
@@ -130,11 +133,15 @@ Messenger::Messenger(not_null<Core::Launcher*> launcher)
 	// Create mime database, so it won't be slow later.
 	QMimeDatabase().mimeTypeForName(qsl("text/plain"));
 
-	_window = std::make_unique<MainWindow>();
-	_window->init();
+	Core::TraceStartupPhase("MainWindow", [&] {
+		_window = std::make_unique<MainWindow>();
+		_window->init();
+	});
 
 	auto currentGeometry = _window->geometry();
-	_mediaView = std::make_unique<MediaView>();
+	Core::TraceStartupPhase("MediaView", [&] {
+		_mediaView = std::make_unique<MediaView>();
+	});
 	_window->setGeometry(currentGeometry);
 
 	QCoreApplication::instance()->installEventFilter(this);
@@ -146,7 +153,9 @@ Messenger::Messenger(not_null<Core::Launcher*> launcher)
 
 	App::initMedia();
 
-	Local::ReadMapState state = Local::readMap(QByteArray());
+	const auto state = Core::TraceStartupPhase("Local::readMap", [] {
+		return Local::readMap(QByteArray());
+	});
 	if (state == Local::ReadMapPassNeeded) {
 		Global::SetLocalPasscode(true);
 		Global::RefLocalPasscodeChanged().notify();
@@ -154,16 +163,18 @@ Messenger::Messenger(not_null<Core::Launcher*> launcher)
 		DEBUG_LOG(("Application Info: passcode needed..."));
 	} else {
 		DEBUG_LOG(("Application Info: local map read..."));
-		startMtp();
+		Core::TraceStartupPhase("startMtp", [&] { startMtp(); });
 		DEBUG_LOG(("Application Info: MTP started..."));
-		if (AuthSession::Exists()) {
-			_window->setupMain();
-		} else {
-			_window->setupIntro();
-		}
+		Core::TraceStartupPhase("setupMainOrIntro", [&] {
+			if (AuthSession::Exists()) {
+				_window->setupMain();
+			} else {
+				_window->setupIntro();
+			}
+		});
 	}
 	DEBUG_LOG(("Application Info: showing."));
-	_window->firstShow();
+	Core::TraceStartupPhase("firstShow", [&] { _window->firstShow(); });
 
 	if (cStartToSettings()) {
 		_window->showSettings();
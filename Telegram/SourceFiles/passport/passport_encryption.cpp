@@ -20,6 +20,11 @@ constexpr auto kAesParamsHashSize = 64;
 constexpr auto kMinPadding = 32;
 constexpr auto kMaxPadding = 255;
 constexpr auto kAlignTo = 16;
+constexpr auto kDataHashSize = 32;
+
+// Large scans are processed in chunks that stay in the processor cache
+// between the AES and the hash passes over them.
+constexpr auto kChunkSize = 64 * 1024;
 
 } // namespace
 
@@ -43,11 +48,15 @@ AesParams PrepareAesParams(bytes::const_span bytesForEncryptionKey) {
 	return PrepareAesParamsWithHash(openssl::Sha512(bytesForEncryptionKey));
 }
 
-bytes::vector EncryptOrDecrypt(
-		bytes::const_span initial,
+template <typename Callback>
+bool EncryptOrDecryptChunks(
+		bytes::const_span from,
+		bytes::span to,
 		AesParams &&params,
-		int encryptOrDecrypt) {
-	Expects((initial.size() & 0x0F) == 0);
+		int encryptOrDecrypt,
+		Callback &&processed) {
+	Expects((from.size() & 0x0F) == 0);
+	Expects(to.size() == from.size());
 	Expects(params.key.size() == kAesKeyLength);
 	Expects(params.iv.size() == kAesIvLength);
 
@@ -64,17 +73,41 @@ bytes::vector EncryptOrDecrypt(
 	if (error != 0) {
 		LOG(("App Error: Could not AES_set_encrypt_key, result %1"
 			).arg(error));
-		return {};
+		return false;
+	}
+
+	// AES_cbc_encrypt() updates the iv, so the chunks are chained
+	// the same way as if the whole buffer was processed at once.
+	for (auto offset = size_type(0); offset < from.size();) {
+		const auto size = std::min(
+			from.size() - offset,
+			size_type(kChunkSize));
+		const auto chunk = to.subspan(offset, size);
+		AES_cbc_encrypt(
+			reinterpret_cast<const uchar*>(from.data() + offset),
+			reinterpret_cast<uchar*>(chunk.data()),
+			size,
+			&aesKey,
+			reinterpret_cast<uchar*>(params.iv.data()),
+			encryptOrDecrypt);
+		processed(bytes::const_span(chunk));
+		offset += size;
 	}
+	return true;
+}
+
+bytes::vector EncryptOrDecrypt(
+		bytes::const_span initial,
+		AesParams &&params,
+		int encryptOrDecrypt) {
 	auto result = bytes::vector(initial.size());
-	AES_cbc_encrypt(
-		reinterpret_cast<const uchar*>(initial.data()),
-		reinterpret_cast<uchar*>(result.data()),
-		initial.size(),
-		&aesKey,
-		reinterpret_cast<uchar*>(params.iv.data()),
-		encryptOrDecrypt);
-	return result;
+	const auto success = EncryptOrDecryptChunks(
+		initial,
+		result,
+		std::move(params),
+		encryptOrDecrypt,
+		[](bytes::const_span) {});
+	return success ? result : bytes::vector();
 }
 
 bytes::vector Encrypt(
@@ -320,13 +353,16 @@ std::vector<DataError> DeserializeErrors(bytes::const_span json) {
 	return result;
 }
 
-EncryptedData EncryptData(bytes::const_span bytes) {
-	return EncryptData(bytes, GenerateSecretBytes());
+EncryptedData EncryptData(
+		bytes::const_span bytes,
+		Fn<void(bytes::const_span)> encryptedChunk) {
+	return EncryptData(bytes, GenerateSecretBytes(), encryptedChunk);
 }
 
 EncryptedData EncryptData(
 		bytes::const_span bytes,
-		bytes::const_span dataSecret) {
+		bytes::const_span dataSecret,
+		Fn<void(bytes::const_span)> encryptedChunk) {
 	constexpr auto kFromPadding = kMinPadding + kAlignTo - 1;
 	constexpr auto kPaddingDelta = kMaxPadding - kFromPadding;
 	const auto randomPadding = kFromPadding
@@ -335,34 +371,50 @@ EncryptedData EncryptData(
 		- ((bytes.size() + randomPadding) % kAlignTo);
 	Assert(padding >= kMinPadding && padding <= kMaxPadding);
 
-	auto unencrypted = bytes::vector(padding + bytes.size());
-	Assert(unencrypted.size() % kAlignTo == 0);
+	auto result = EncryptedData();
+	result.bytes = bytes::vector(padding + bytes.size());
+	Assert(result.bytes.size() % kAlignTo == 0);
 
+	// The padded data is encrypted in place, without an unencrypted copy.
+	const auto unencrypted = gsl::make_span(result.bytes);
 	unencrypted[0] = static_cast<gsl::byte>(padding);
 	memset_rand(unencrypted.data() + 1, padding - 1);
-	bytes::copy(
-		gsl::make_span(unencrypted).subspan(padding),
-		bytes);
-	const auto dataHash = openssl::Sha256(unencrypted);
+	bytes::copy(unencrypted.subspan(padding), bytes);
+
+	// The key depends on the hash of the whole data,
+	// so it can't be computed in the same pass with the encryption.
+	result.secret = bytes::make_vector(dataSecret);
+	result.hash = openssl::Sha256(unencrypted);
 	const auto bytesForEncryptionKey = bytes::concatenate(
 		dataSecret,
-		dataHash);
+		result.hash);
 
 	auto params = PrepareAesParams(bytesForEncryptionKey);
-	return {
-		{ dataSecret.begin(), dataSecret.end() },
-		{ dataHash.begin(), dataHash.end() },
-		Encrypt(unencrypted, std::move(params))
-	};
+	const auto success = EncryptOrDecryptChunks(
+		unencrypted,
+		unencrypted,
+		std::move(params),
+		AES_ENCRYPT,
+		[&](bytes::const_span chunk) {
+			if (encryptedChunk) {
+				encryptedChunk(chunk);
+			}
+		});
+	if (!success) {
+		result.bytes.clear();
+	}
+	return result;
 }
 
 bytes::vector DecryptData(
 		bytes::const_span encrypted,
 		bytes::const_span dataHash,
 		bytes::const_span dataSecret) {
-	constexpr auto kDataHashSize = 32;
 	if (encrypted.empty()) {
 		return {};
+	} else if (encrypted.size() % kAlignTo) {
+		LOG(("API Error: Bad encrypted data size %1").arg(encrypted.size()));
+		return {};
 	} else if (dataHash.size() != kDataHashSize) {
 		LOG(("API Error: Bad data hash size %1").arg(dataHash.size()));
 		return {};
@@ -375,8 +427,24 @@ bytes::vector DecryptData(
 		dataSecret,
 		dataHash);
 	auto params = PrepareAesParams(bytesForEncryptionKey);
-	const auto decrypted = Decrypt(encrypted, std::move(params));
-	if (bytes::compare(openssl::Sha256(decrypted), dataHash) != 0) {
+
+	// Each decrypted chunk is hashed while it is still in the cache.
+	auto decrypted = bytes::vector(encrypted.size());
+	auto context = SHA256_CTX();
+	SHA256_Init(&context);
+	const auto success = EncryptOrDecryptChunks(
+		encrypted,
+		decrypted,
+		std::move(params),
+		AES_DECRYPT,
+		[&](bytes::const_span chunk) {
+			SHA256_Update(&context, chunk.data(), chunk.size());
+		});
+	auto hash = bytes::vector(kDataHashSize);
+	SHA256_Final(reinterpret_cast<uchar*>(hash.data()), &context);
+	if (!success) {
+		return {};
+	} else if (bytes::compare(hash, dataHash) != 0) {
 		LOG(("API Error: Bad data hash."));
 		return {};
 	}
@@ -387,8 +455,8 @@ bytes::vector DecryptData(
 		LOG(("API Error: Bad padding value %1").arg(padding));
 		return {};
 	}
-	const auto bytes = gsl::make_span(decrypted).subspan(padding);
-	return { bytes.begin(), bytes.end() };
+	decrypted.erase(decrypted.begin(), decrypted.begin() + padding);
+	return decrypted;
 }
 
 bytes::vector PrepareValueHash(
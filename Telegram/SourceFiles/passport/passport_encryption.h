@@ -38,11 +38,16 @@ struct EncryptedData {
 	bytes::vector bytes;
 };
 
-EncryptedData EncryptData(bytes::const_span bytes);
+// The encrypted chunks are passed to the callback as soon as they are
+// ready, so that the caller could hash them while they're in the cache.
+EncryptedData EncryptData(
+	bytes::const_span bytes,
+	Fn<void(bytes::const_span)> encryptedChunk = nullptr);
 
 EncryptedData EncryptData(
 	bytes::const_span bytes,
-	bytes::const_span dataSecret);
+	bytes::const_span dataSecret,
+	Fn<void(bytes::const_span)> encryptedChunk = nullptr);
 
 bytes::vector DecryptData(
 	bytes::const_span encrypted,
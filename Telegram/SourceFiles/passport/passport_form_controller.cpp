@@ -1431,18 +1431,19 @@ void FormController::encryptFile(
 		bytes = std::move(content),
 		fileSecret = file.fields.secret
 	] {
+		auto md5 = HashMd5();
 		auto data = EncryptData(
 			bytes::make_span(bytes),
-			fileSecret);
+			fileSecret,
+			[&](bytes::const_span chunk) {
+				md5.feed(chunk.data(), uint32(chunk.size()));
+			});
 		auto result = UploadScanData();
 		result.fileId = fileId;
 		result.hash = std::move(data.hash);
 		result.bytes = std::move(data.bytes);
 		result.md5checksum.resize(32);
-		hashMd5Hex(
-			result.bytes.data(),
-			result.bytes.size(),
-			result.md5checksum.data());
+		hashMd5Hex(md5.result(), result.md5checksum.data());
 		crl::on_main([=, encrypted = std::move(result)]() mutable {
 			if (weak.lock()) {
 				callback(std::move(encrypted));
@@ -1747,18 +1748,32 @@ void FormController::loadFile(File &file) {
 
 void FormController::fileLoadDone(FileKey key, const QByteArray &bytes) {
 	if (const auto [value, file] = findFile(key); file != nullptr) {
-		const auto decrypted = DecryptData(
-			bytes::make_span(bytes),
-			file->hash,
-			file->secret);
-		if (decrypted.empty()) {
-			fileLoadFail(key);
-			return;
-		}
+		crl::async([
+			=,
+			hash = file->hash,
+			secret = file->secret
+		] {
+			const auto decrypted = DecryptData(
+				bytes::make_span(bytes),
+				hash,
+				secret);
+			const auto failed = decrypted.empty();
+			auto image = failed ? QImage() : ReadImage(decrypted);
+			crl::on_main(this, [=, image = std::move(image)]() mutable {
+				if (failed) {
+					fileLoadFail(key);
+				} else {
+					fileDecrypted(key, std::move(image));
+				}
+			});
+		});
+	}
+}
+
+void FormController::fileDecrypted(FileKey key, QImage &&image) {
+	if (const auto [value, file] = findFile(key); file != nullptr) {
 		file->downloadOffset = file->size;
-		file->image = App::readImage(QByteArray::fromRawData(
-			reinterpret_cast<const char*>(decrypted.data()),
-			decrypted.size()));
+		file->image = std::move(image);
 		if (const auto fileInEdit = findEditFile(key)) {
 			fileInEdit->fields.image = file->image;
 			fileInEdit->fields.downloadOffset = file->downloadOffset;
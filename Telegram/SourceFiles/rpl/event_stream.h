@@ -11,9 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <rpl/range.h>
 #include <rpl/then.h>
 #include <rpl/range.h>
-#include <algorithm>
+#include <vector>
 #include "base/assertion.h"
-#include "base/index_based_iterator.h"
 
 namespace rpl {
 
@@ -34,6 +33,10 @@ public:
 	void fire_copy(const Value &value) const {
 		return fire_forward(value);
 	}
+
+	// Delivers all the values one by one, same as calling fire() for each
+	// of them, but cleans up the removed consumers only once in the end.
+	void fire_batch(std::vector<Value> &&values) const;
 #if defined _MSC_VER && _MSC_VER >= 1914 && false
 	producer<Value> events() const {
 #else // _MSC_VER >= 1914
@@ -42,19 +45,12 @@ public:
 		return make_producer<Value>([weak = make_weak()](
 				const auto &consumer) {
 			if (auto strong = weak.lock()) {
-				auto result = [weak, consumer] {
+				const auto slot = strong->add(consumer);
+				return lifetime([weak, consumer, slot] {
 					if (auto strong = weak.lock()) {
-						auto it = std::find(
-							strong->consumers.begin(),
-							strong->consumers.end(),
-							consumer);
-						if (it != strong->consumers.end()) {
-							it->terminate();
-						}
+						strong->remove(slot, consumer);
 					}
-				};
-				strong->consumers.push_back(std::move(consumer));
-				return lifetime(std::move(result));
+				});
 			}
 			return lifetime();
 		});
@@ -66,15 +62,35 @@ public:
 		return single(value) | then(events());
 	}
 	bool has_consumers() const {
-		return (_data != nullptr) && !_data->consumers.empty();
+		return (_data != nullptr)
+			&& (_data->entries.size() > _data->removed);
 	}
 
 	~event_stream();
 
 private:
+	// Consumers are kept in the subscription order. Each of them gets
+	// a slot that knows its current position, so a consumer is removed
+	// in O(1) by its lifetime. Removed entries are erased in bulk when
+	// they take more than a half of the list and nobody is firing.
 	struct Data {
-		std::vector<consumer<Value, no_error>> consumers;
+		struct Entry {
+			consumer<Value, no_error> instance;
+			int slot = -1;
+		};
+		std::vector<Entry> entries;
+		std::vector<int> positions;
+		std::vector<int> freeSlots;
+		size_t removed = 0;
 		int depth = 0;
+
+		int add(const consumer<Value, no_error> &consumer);
+		void remove(int slot, const consumer<Value, no_error> &consumer);
+
+		template <typename OtherValue>
+		void deliver(OtherValue &&value);
+		void removeAt(int position);
+		void collectRemoved();
 	};
 	std::weak_ptr<Data> make_weak() const;
 
@@ -102,48 +118,117 @@ template <typename Value>
 template <typename OtherValue>
 inline void event_stream<Value>::fire_forward(
 		OtherValue &&value) const {
-	auto copy = _data;
+	const auto copy = _data;
 	if (!copy) {
 		return;
 	}
 
 	++copy->depth;
-	auto &consumers = copy->consumers;
-	auto begin = base::index_based_begin(consumers);
-	auto end = base::index_based_end(consumers);
-	if (begin != end) {
-		// Copy value for every consumer except the last.
-		auto prev = end - 1;
-		auto removeFrom = std::remove_if(begin, prev, [&](auto &consumer) {
-			return !consumer.put_next_copy(value);
-		});
+	copy->deliver(std::forward<OtherValue>(value));
+	if (!--copy->depth) {
+		copy->collectRemoved();
+	}
+}
 
-		// Perhaps move value for the last consumer.
-		if (prev->put_next_forward(std::forward<OtherValue>(value))) {
-			if (removeFrom != prev) {
-				*removeFrom++ = std::move(*prev);
-			} else {
-				++removeFrom;
-			}
+template <typename Value>
+inline void event_stream<Value>::fire_batch(
+		std::vector<Value> &&values) const {
+	const auto copy = _data;
+	if (!copy) {
+		return;
+	}
+
+	++copy->depth;
+	for (auto &value : values) {
+		copy->deliver(std::move(value));
+	}
+	if (!--copy->depth) {
+		copy->collectRemoved();
+	}
+}
+
+template <typename Value>
+inline int event_stream<Value>::Data::add(
+		const consumer<Value, no_error> &consumer) {
+	const auto position = int(entries.size());
+	auto slot = int(positions.size());
+	if (freeSlots.empty()) {
+		positions.push_back(position);
+	} else {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+		positions[slot] = position;
+	}
+	entries.push_back({ consumer, slot });
+	return slot;
+}
+
+template <typename Value>
+inline void event_stream<Value>::Data::remove(
+		int slot,
+		const consumer<Value, no_error> &consumer) {
+	// The slot could be already freed and given to a new consumer.
+	const auto position = positions[slot];
+	if (position < 0 || entries[position].instance != consumer) {
+		return;
+	}
+	entries[position].instance.terminate();
+	removeAt(position);
+	if (!depth) {
+		collectRemoved();
+	}
+}
+
+template <typename Value>
+template <typename OtherValue>
+inline void event_stream<Value>::Data::deliver(OtherValue &&value) {
+	// Consumers added while firing don't receive this value.
+	auto last = int(entries.size()) - 1;
+	while (last >= 0 && entries[last].slot < 0) {
+		--last;
+	}
+	for (auto i = 0; i <= last; ++i) {
+		if (entries[i].slot < 0) {
+			continue;
 		}
 
-		if (removeFrom != end) {
-			// Move new consumers.
-			auto newEnd = base::index_based_end(consumers);
-			if (newEnd != end) {
-				Assert(newEnd > end);
-				while (end != newEnd) {
-					*removeFrom++ = *end++;
-				}
-			}
+		// Copy value for every consumer except the last.
+		const auto alive = (i == last)
+			? entries[i].instance.put_next_forward(
+				std::forward<OtherValue>(value))
+			: entries[i].instance.put_next_copy(value);
+		if (!alive && entries[i].slot >= 0) {
+			removeAt(i);
+		}
+	}
+}
 
-			// Erase stale consumers.
-			if (copy->depth == 1) {
-				consumers.erase(removeFrom.base(), consumers.end());
-			}
+template <typename Value>
+inline void event_stream<Value>::Data::removeAt(int position) {
+	auto &entry = entries[position];
+	positions[entry.slot] = -1;
+	freeSlots.push_back(entry.slot);
+	entry.slot = -1;
+	++removed;
+}
+
+template <typename Value>
+inline void event_stream<Value>::Data::collectRemoved() {
+	if (removed * 2 <= entries.size()) {
+		return;
+	}
+	auto till = 0;
+	for (auto i = 0, count = int(entries.size()); i != count; ++i) {
+		if (entries[i].slot < 0) {
+			continue;
+		} else if (i != till) {
+			entries[till] = std::move(entries[i]);
 		}
+		positions[entries[till].slot] = till;
+		++till;
 	}
-	--copy->depth;
+	entries.erase(entries.begin() + till, entries.end());
+	removed = 0;
 }
 
 template <typename Value>
@@ -159,8 +244,10 @@ inline auto event_stream<Value>::make_weak() const
 template <typename Value>
 inline event_stream<Value>::~event_stream() {
 	if (auto data = details::take(_data)) {
-		for (auto &consumer : data->consumers) {
-			consumer.put_done();
+		// Consumers may unsubscribe from put_done(), don't move entries.
+		++data->depth;
+		for (auto i = 0; i != int(data->entries.size()); ++i) {
+			data->entries[i].instance.put_done();
 		}
 	}
 }
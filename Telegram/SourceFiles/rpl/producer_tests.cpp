@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <rpl/producer.h>
 #include <rpl/event_stream.h>
+#include "base/tests_benchmark.h"
 
 using namespace rpl;
 
@@ -327,6 +328,69 @@ TEST_CASE("basic event_streams tests", "[rpl::event_stream]") {
 		}
 		REQUIRE(*sum == 1 + 2 + 3 + 4);
 	}
+
+	SECTION("event_stream unsubscribe in any order test") {
+		auto sum = std::make_shared<int>(0);
+		event_stream<int> stream;
+		auto lifetimes = std::vector<lifetime>(100);
+		for (auto &alive : lifetimes) {
+			stream.events()
+				| start_with_next([=](int value) {
+					*sum += value;
+				}, alive);
+		}
+		stream.fire(1);
+		REQUIRE(*sum == 100);
+
+		for (auto i = 0; i != 100; i += 2) {
+			lifetimes[i].destroy();
+		}
+		stream.fire(1);
+		REQUIRE(*sum == 150);
+
+		for (auto i = 0; i != 100; i += 2) {
+			stream.events()
+				| start_with_next([=](int value) {
+					*sum += value;
+				}, lifetimes[i]);
+		}
+		for (auto i = 99; i > 0; i -= 2) {
+			lifetimes[i].destroy();
+		}
+		stream.fire(1);
+		REQUIRE(*sum == 200);
+		REQUIRE(stream.has_consumers());
+
+		lifetimes.clear();
+		stream.fire(1);
+		REQUIRE(*sum == 200);
+		REQUIRE(!stream.has_consumers());
+	}
+
+	SECTION("event_stream fire_batch test") {
+		auto values = std::make_shared<std::vector<int>>();
+		event_stream<int> stream;
+		stream.fire_batch({ 1, 2 });
+		{
+			auto first = lifetime();
+			stream.events()
+				| start_with_next([=, &first](int value) {
+					values->push_back(value);
+					if (value == 4) {
+						first.destroy();
+					}
+				}, first);
+			auto second = lifetime();
+			stream.events()
+				| start_with_next([=](int value) {
+					values->push_back(value * 10);
+				}, second);
+
+			stream.fire_batch({ 3, 4, 5 });
+		}
+		stream.fire_batch({ 6 });
+		REQUIRE(*values == std::vector<int>{ 3, 30, 4, 40, 50 });
+	}
 }
 
 TEST_CASE("basic piping tests", "[rpl::producer]") {
@@ -439,3 +503,35 @@ TEST_CASE("basic piping tests", "[rpl::producer]") {
 		REQUIRE(*sum == 3);
 	}
 }
+
+TEST_CASE("event_stream benchmark", "[.][benchmark][rpl::event_stream]") {
+	constexpr auto kConsumers = 10000;
+	using base::test::benchmark;
+
+	auto sum = std::make_shared<int>(0);
+	event_stream<int> stream;
+	auto lifetimes = std::vector<lifetime>(kConsumers);
+	benchmark("subscribe", [&] {
+		for (auto &alive : lifetimes) {
+			stream.events()
+				| start_with_next([=](int value) {
+					*sum += value;
+				}, alive);
+		}
+	});
+	benchmark("fire x100", [&] {
+		for (auto i = 0; i != 100; ++i) {
+			stream.fire(1);
+		}
+	});
+	benchmark("fire_batch x100", [&] {
+		stream.fire_batch(std::vector<int>(100, 1));
+	});
+	benchmark("unsubscribe", [&] {
+		for (auto &alive : lifetimes) {
+			alive.destroy();
+		}
+	});
+	REQUIRE(*sum == 200 * kConsumers);
+	REQUIRE(!stream.has_consumers());
+}
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtp_instance.h"
 #include "mtproto/dc_options.h"
 #include "core/file_utilities.h"
+#include "history/view/history_view_paint_profiler.h"
 #include "core/update_checker.h"
 #include "window/themes/window_theme.h"
 #include "window/themes/window_theme_editor.h"
@@ -120,6 +121,14 @@ auto GenerateCodes() {
 	codes.emplace(qsl("export"), [] {
 		Auth().data().startExport();
 	});
+#ifdef _DEBUG
+	codes.emplace(qsl("paintprofiler"), [] {
+		HistoryView::TogglePaintProfiler();
+		if (const auto main = App::main()) {
+			main->update();
+		}
+	});
+#endif // _DEBUG
 
 	auto audioFilters = qsl("Audio files (*.wav *.mp3);;") + FileDialog::AllFilesFilter();
 	auto audioKeys = {
@@ -35,6 +35,20 @@ int CurrentCount() {
 	return snap(Global::NotificationsCount(), 1, kMaxNotificationsCount);
 }
 
+constexpr int kPerSecondVariants[] = { 1, 2, 3, 5, 10 };
+constexpr auto kPerSecondVariantsCount = int(base::array_size(
+	kPerSecondVariants));
+
+int CurrentPerSecondSection() {
+	const auto value = Global::NotificationsPerSecond();
+	for (auto i = 0; i != kPerSecondVariantsCount; ++i) {
+		if (kPerSecondVariants[i] >= value) {
+			return i;
+		}
+	}
+	return kPerSecondVariantsCount - 1;
+}
+
 using ChangeType = Window::Notifications::ChangeType;
 
 class NotificationsCount : public Ui::RpWidget {
@@ -508,6 +522,26 @@ void SetupAdvancedNotifications(not_null<Ui::VerticalLayout*> container) {
 	) | rpl::start_with_next([=](int section) {
 		position->setCount(section + 1);
 	}, count->lifetime());
+
+	AddSkip(container, st::settingsCheckboxesSkip);
+	AddSubsectionTitle(container, lng_settings_notifications_per_second);
+
+	const auto perSecond = container->add(
+		object_ptr<Ui::SettingsSlider>(container, st::settingsSlider),
+		st::settingsBigScalePadding);
+	for (const auto variant : kPerSecondVariants) {
+		perSecond->addSection(QString::number(variant));
+	}
+	perSecond->setActiveSectionFast(CurrentPerSecondSection());
+	perSecond->sectionActivated(
+	) | rpl::map([](int section) {
+		return kPerSecondVariants[section];
+	}) | rpl::filter([](int value) {
+		return (value != Global::NotificationsPerSecond());
+	}) | rpl::start_with_next([](int value) {
+		Global::SetNotificationsPerSecond(value);
+		Local::writeUserSettings();
+	}, perSecond->lifetime());
 	AddSkip(container, st::settingsCheckboxesSkip);
 }
 
@@ -128,22 +128,74 @@ FileLoader::FileLoader(
 }
 
 QByteArray FileLoader::imageFormat(const QSize &shrinkBox) const {
-	if (_imageFormat.isEmpty() && _locationType == UnknownFileLocation) {
+	if (_imageFormat.isEmpty()
+		&& !_imageDecodeFailed
+		&& _locationType == UnknownFileLocation) {
 		readImage(shrinkBox);
 	}
 	return _imageFormat;
 }
 
 QPixmap FileLoader::imagePixmap(const QSize &shrinkBox) const {
-	if (_imagePixmap.isNull() && _locationType == UnknownFileLocation) {
+	if (_imagePixmap.isNull()
+		&& !_imageDecodeFailed
+		&& _locationType == UnknownFileLocation) {
 		readImage(shrinkBox);
 	}
 	return _imagePixmap;
 }
 
+bool FileLoader::imageReady(const QSize &shrinkBox) {
+	if (_locationType != UnknownFileLocation
+		|| !_imagePixmap.isNull()
+		|| _imageDecodeFailed) {
+		return true;
+	} else if (_imageDecoding.alive()) {
+		return false;
+	}
+	auto [first, second] = base::make_binary_guard();
+	_imageDecoding = std::move(first);
+	crl::async([
+		=,
+		data = _data,
+		guard = std::move(second)
+	]() mutable {
+		if (!guard.alive()) {
+			// The loader was destroyed before we started.
+			return;
+		}
+		auto format = QByteArray();
+		auto image = App::readImage(data, &format, false, nullptr, shrinkBox);
+		crl::on_main([
+			=,
+			image = std::move(image),
+			format = std::move(format),
+			guard = std::move(guard)
+		]() mutable {
+			if (!guard.alive()) {
+				return;
+			}
+			imageDecoded(std::move(image), std::move(format));
+		});
+	});
+	return false;
+}
+
+void FileLoader::imageDecoded(QImage &&image, QByteArray &&format) {
+	_imageDecoding.kill();
+	if (image.isNull()) {
+		_imageDecodeFailed = true;
+	} else {
+		_imagePixmap = App::pixmapFromImageInPlace(std::move(image));
+		_imageFormat = std::move(format);
+	}
+	_downloader->taskFinished().notify();
+}
+
 void FileLoader::readImage(const QSize &shrinkBox) const {
 	auto format = QByteArray();
-	auto image = App::readImage(_data, &format, false);
+	auto image = App::readImage(_data, &format, false, nullptr, shrinkBox);
+	_imageDecodeFailed = image.isNull();
 	if (!image.isNull()) {
 		if (!shrinkBox.isEmpty() && (image.width() > shrinkBox.width() || image.height() > shrinkBox.height())) {
 			_imagePixmap = App::pixmapFromImageInPlace(image.scaled(shrinkBox, Qt::KeepAspectRatio, Qt::SmoothTransformation));
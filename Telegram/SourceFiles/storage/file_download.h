@@ -95,6 +95,11 @@ public:
 	}
 	QByteArray imageFormat(const QSize &shrinkBox = QSize()) const;
 	QPixmap imagePixmap(const QSize &shrinkBox = QSize()) const;
+
+	// Starts decoding the loaded image in the thread pool and returns
+	// false until imagePixmap() can be called without decoding it.
+	// The downloader taskFinished() is notified when it is ready.
+	bool imageReady(const QSize &shrinkBox = QSize());
 	QString fileName() const {
 		return _filename;
 	}
@@ -150,6 +155,7 @@ protected:
 	};
 
 	void readImage(const QSize &shrinkBox) const;
+	void imageDecoded(QImage &&image, QByteArray &&format);
 
 	bool tryLoadLocal();
 	void loadLocal(const Storage::Cache::Key &key);
@@ -190,8 +196,10 @@ protected:
 	LocationType _locationType;
 
 	base::binary_guard _localLoading;
+	base::binary_guard _imageDecoding;
 	mutable QByteArray _imageFormat;
 	mutable QPixmap _imagePixmap;
+	mutable bool _imageDecodeFailed = false;
 
 };
 
@@ -20,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/export_settings.h"
 #include "core/crash_reports.h"
 #include "core/update_checker.h"
+#include "core/startup_trace.h"
 #include "observer_peer.h"
 #include "mainwidget.h"
 #include "mainwindow.h"
@@ -598,6 +599,7 @@ enum {
 	dbiCacheSettings = 0x56,
 	dbiAnimationsDisabled = 0x57,
 	dbiScalePercent = 0x58,
+	dbiNotificationsPerSecond = 0x59,
 
 	dbiEncryptedWithSalt = 333,
 	dbiEncrypted = 444,
@@ -1147,6 +1149,14 @@ bool _readSetting(quint32 blockId, QDataStream &stream, int version, ReadSetting
 		Global::SetNotificationsCorner(static_cast<Notify::ScreenCorner>((v >= 0 && v < 4) ? v : 2));
 	} break;
 
+	case dbiNotificationsPerSecond: {
+		qint32 v;
+		stream >> v;
+		if (!_checkStreamStatus(stream)) return false;
+
+		Global::SetNotificationsPerSecond((v > 0 ? v : 3));
+	} break;
+
 	case dbiDialogsWidthRatioOld: {
 		qint32 v;
 		stream >> v;
@@ -1943,7 +1953,7 @@ void _writeUserSettings() {
 		? userDataInstance->serialize()
 		: QByteArray();
 
-	uint32 size = 22 * (sizeof(quint32) + sizeof(qint32));
+	uint32 size = 23 * (sizeof(quint32) + sizeof(qint32));
 	size += sizeof(quint32) + Serialize::stringSize(Global::AskDownloadPath() ? QString() : Global::DownloadPath()) + Serialize::bytearraySize(Global::AskDownloadPath() ? QByteArray() : Global::DownloadPathBookmark());
 
 	size += sizeof(quint32) + sizeof(qint32);
@@ -1982,6 +1992,7 @@ void _writeUserSettings() {
 	data.stream << quint32(dbiNativeNotifications) << qint32(Global::NativeNotifications());
 	data.stream << quint32(dbiNotificationsCount) << qint32(Global::NotificationsCount());
 	data.stream << quint32(dbiNotificationsCorner) << qint32(Global::NotificationsCorner());
+	data.stream << quint32(dbiNotificationsPerSecond) << qint32(Global::NotificationsPerSecond());
 	data.stream << quint32(dbiAskDownloadPath) << qint32(Global::AskDownloadPath());
 	data.stream << quint32(dbiDownloadPath) << (Global::AskDownloadPath() ? QString() : Global::DownloadPath()) << (Global::AskDownloadPath() ? QByteArray() : Global::DownloadPathBookmark());
 	data.stream << quint32(dbiDialogLastPath) << cDialogLastPath();
@@ -2124,7 +2135,9 @@ ReadMapState _readMap(const QByteArray &pass) {
 		LOG(("App Error: bad salt in map file, size: %1").arg(salt.size()));
 		return ReadMapFailed;
 	}
-	createLocalKey(pass, &salt, &PassKey);
+	Core::TraceStartupPhase("createLocalKey", [&] {
+		createLocalKey(pass, &salt, &PassKey);
+	});
 
 	EncryptedDescriptor keyData, map;
 	if (!decryptLocal(keyData, keyEncrypted, PassKey)) {
@@ -2289,13 +2302,15 @@ ReadMapState _readMap(const QByteArray &pass) {
 		_readReportSpamStatuses();
 	}
 
-	_readUserSettings();
-	_readMtpData();
+	Core::TraceStartupPhase("readUserSettings", [] { _readUserSettings(); });
+	Core::TraceStartupPhase("readMtpData", [] { _readMtpData(); });
 
-	Messenger::Instance().setAuthSessionFromStorage(
-		std::move(StoredAuthSessionCache),
-		std::move(selfSerialized),
-		_oldMapVersion);
+	Core::TraceStartupPhase("setAuthSessionFromStorage", [&] {
+		Messenger::Instance().setAuthSessionFromStorage(
+			std::move(StoredAuthSessionCache),
+			std::move(selfSerialized),
+			_oldMapVersion);
+	});
 
 	LOG(("Map read time: %1").arg(getms() - ms));
 	if (_oldSettingsVersion < AppVersion) {
@@ -2482,7 +2497,9 @@ void start() {
 		LOG(("App Error: bad salt in settings file, size: %1").arg(salt.size()));
 		return writeSettings();
 	}
-	createLocalKey(QByteArray(), &salt, &SettingsKey);
+	Core::TraceStartupPhase("createLocalKey", [&] {
+		createLocalKey(QByteArray(), &salt, &SettingsKey);
+	});
 
 	EncryptedDescriptor settings;
 	if (!decryptLocal(settings, settingsEncrypted, SettingsKey)) {
@@ -2506,8 +2523,8 @@ void start() {
 	_oldSettingsVersion = settingsData.version;
 	_settingsSalt = salt;
 
-	loadTheme();
-	readLangPack();
+	Core::TraceStartupPhase("loadTheme", [] { loadTheme(); });
+	Core::TraceStartupPhase("readLangPack", [] { readLangPack(); });
 
 	applyReadContext(std::move(context));
 }
@@ -3091,75 +3108,118 @@ void updateCacheSettings(Storage::Cache::Database::SettingsUpdate &update) {
 	_writeUserSettings();
 }
 
-class CountWaveformTask : public Task {
-public:
-	CountWaveformTask(DocumentData *doc)
-		: _doc(doc)
-		, _loc(doc->location(true))
-		, _data(doc->data())
-		, _wavemax(0) {
-		if (_data.isEmpty() && !_loc.accessEnable()) {
-			_doc = 0;
-		}
-	}
-	void process() {
-		if (!_doc) return;
+namespace {
 
-		_waveform = audioCountWaveform(_loc, _data);
-		uchar wavemax = 0;
-		for (int32 i = 0, l = _waveform.size(); i < l; ++i) {
-			uchar waveat = _waveform.at(i);
-			if (wavemax < waveat) wavemax = waveat;
-		}
-		_wavemax = wavemax;
+constexpr auto kWaveformCacheVersion = char(1);
+constexpr auto kWaveformMaxValue = char(31);
+
+// Waveforms requested while painting one frame are counted together.
+std::vector<not_null<DocumentData*>> WaveformsToCount;
+base::weak_ptr<AuthSession> WaveformsSession;
+
+QByteArray SerializeWaveform(const VoiceWaveform &waveform) {
+	auto result = QByteArray();
+	result.reserve(1 + waveform.size());
+	result.push_back(kWaveformCacheVersion);
+	result.append(waveform.constData(), waveform.size());
+	return result;
+}
+
+VoiceWaveform DeserializeWaveform(const QByteArray &value) {
+	if (value.size() < 2
+		|| value.size() > 1 + Media::Player::kWaveformSamplesCount
+		|| value[0] != kWaveformCacheVersion) {
+		return VoiceWaveform();
 	}
-	void finish() {
-		if (const auto voice = _doc ? _doc->voice() : nullptr) {
-			if (!_waveform.isEmpty()) {
-				voice->waveform = _waveform;
-				voice->wavemax = _wavemax;
-			}
-			if (voice->waveform.isEmpty()) {
-				voice->waveform.resize(1);
-				voice->waveform[0] = -2;
-				voice->wavemax = 0;
-			} else if (voice->waveform[0] < 0) {
-				voice->waveform[0] = -2;
-				voice->wavemax = 0;
-			}
-			Auth().data().requestDocumentViewRepaint(_doc);
+	auto result = VoiceWaveform(value.size() - 1);
+	for (auto i = 0, count = int(result.size()); i != count; ++i) {
+		const auto waveat = value[i + 1];
+		if (waveat < 0 || waveat > kWaveformMaxValue) {
+			return VoiceWaveform();
 		}
+		result[i] = waveat;
 	}
-	virtual ~CountWaveformTask() {
-		if (_data.isEmpty() && _doc) {
-			_loc.accessDisable();
-		}
+	return result;
+}
+
+// Thread: Any.
+VoiceWaveform CountWaveform(FileLocation location, const QByteArray &data) {
+	if (!data.isEmpty()) {
+		return audioCountWaveform(location, data);
+	} else if (!location.accessEnable()) {
+		return VoiceWaveform();
 	}
+	auto result = audioCountWaveform(location, data);
+	location.accessDisable();
+	return result;
+}
 
-protected:
-	DocumentData *_doc;
-	FileLocation _loc;
-	QByteArray _data;
-	VoiceWaveform _waveform;
-	char _wavemax;
+void ApplyCountedWaveform(
+		not_null<DocumentData*> document,
+		const VoiceWaveform &waveform) {
+	const auto voice = document->voice();
+	if (!voice || voice->waveform.isEmpty() || voice->waveform[0] != -1) {
+		return;
+	}
+	if (waveform.isEmpty()) {
+		voice->waveform.resize(1);
+		voice->waveform[0] = -2;
+		voice->wavemax = 0;
+	} else {
+		voice->waveform = waveform;
+		voice->wavemax = *std::max_element(waveform.cbegin(), waveform.cend());
+	}
+	Auth().data().requestDocumentViewRepaint(document);
+}
+
+void CountPendingWaveforms() {
+	const auto weak = base::take(WaveformsSession);
+	const auto documents = base::take(WaveformsToCount);
+	for (const auto document : documents) {
+		const auto key = Data::VoiceWaveformCacheKey(document->id);
+		const auto location = document->location(true);
+		const auto data = document->data();
+		Auth().data().cache().get(key, [=](QByteArray &&value) {
+			auto cached = DeserializeWaveform(value);
+			if (!cached.isEmpty()) {
+				crl::on_main(weak, [=, waveform = std::move(cached)] {
+					ApplyCountedWaveform(document, waveform);
+				});
+				return;
+			}
 
-};
+			// Each document is counted in its own thread of the pool.
+			crl::async([=] {
+				auto waveform = CountWaveform(location, data);
+				crl::on_main(weak, [=, waveform = std::move(waveform)] {
+					if (!waveform.isEmpty()) {
+						Auth().data().cache().put(
+							key,
+							SerializeWaveform(waveform));
+					}
+					ApplyCountedWaveform(document, waveform);
+				});
+			});
+		});
+	}
+}
+
+} // namespace
 
 void countVoiceWaveform(DocumentData *document) {
 	if (const auto voice = document->voice()) {
-		if (_localLoader) {
-			voice->waveform.resize(1 + sizeof(TaskId));
-			voice->waveform[0] = -1; // counting
-			TaskId taskId = _localLoader->addTask(
-				std::make_unique<CountWaveformTask>(document));
-			memcpy(voice->waveform.data() + 1, &taskId, sizeof(taskId));
-		}
-	}
-}
+		voice->waveform.resize(1);
+		voice->waveform[0] = -1; // counting
 
-void cancelTask(TaskId id) {
-	if (_localLoader) {
-		_localLoader->cancelTask(id);
+		const auto session = &Auth();
+		if (WaveformsSession.get() != session) {
+			WaveformsToCount.clear();
+		}
+		WaveformsToCount.push_back(document);
+		if (WaveformsToCount.size() == 1) {
+			WaveformsSession = base::make_weak(session);
+			crl::on_main(session, [] { CountPendingWaveforms(); });
+		}
 	}
 }
 
@@ -3304,6 +3364,8 @@ void _writeStickerSets(FileKey &stickersKey, CheckSet checkSet, const Stickers::
 }
 
 void _readStickerSets(FileKey &stickersKey, Stickers::Order *outOrder = nullptr, MTPDstickerSet::Flags readingFlags = 0) {
+	const auto phase = Core::StartupPhase("readStickerSets");
+
 	FileReadDescriptor stickers;
 	if (!readEncryptedFile(stickers, stickersKey)) {
 		clearKey(stickersKey);
@@ -111,8 +111,6 @@ void updateCacheSettings(Storage::Cache::Database::SettingsUpdate &update);
 
 void countVoiceWaveform(DocumentData *document);
 
-void cancelTask(TaskId id);
-
 void writeInstalledStickers();
 void writeFeaturedStickers();
 void writeRecentStickers();
@@ -10,7 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Storage {
 
 SparseIdsList::Slice::Slice(
-	base::flat_set<MsgId> &&messages,
+	base::vector_flat_set<MsgId> &&messages,
 	MsgRange range)
 : messages(std::move(messages))
 , range(range) {
@@ -78,7 +78,7 @@ int SparseIdsList::addRangeItemsAndCountNew(
 		return uniteAndAdd(update, uniteFrom, uniteTill, messages, noSkipRange);
 	}
 
-	auto sliceMessages = base::flat_set<MsgId> {
+	auto sliceMessages = base::vector_flat_set<MsgId> {
 		std::begin(messages),
 		std::end(messages) };
 	auto slice = _slices.emplace(
@@ -154,7 +154,7 @@ void SparseIdsList::removeOne(MsgId messageId) {
 
 void SparseIdsList::removeAll() {
 	_slices.clear();
-	_slices.emplace(base::flat_set<MsgId>{}, MsgRange { 0, ServerMaxMsgId });
+	_slices.emplace(base::vector_flat_set<MsgId>{}, MsgRange { 0, ServerMaxMsgId });
 	_count = 0;
 }
 
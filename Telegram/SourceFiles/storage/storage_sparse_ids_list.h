@@ -29,11 +29,11 @@ struct SparseIdsListResult {
 	std::optional<int> count;
 	std::optional<int> skippedBefore;
 	std::optional<int> skippedAfter;
-	base::flat_set<MsgId> messageIds;
+	base::vector_flat_set<MsgId> messageIds;
 };
 
 struct SparseIdsSliceUpdate {
-	const base::flat_set<MsgId> *messages = nullptr;
+	const base::vector_flat_set<MsgId> *messages = nullptr;
 	MsgRange range;
 	std::optional<int> count;
 };
@@ -54,12 +54,12 @@ public:
 
 private:
 	struct Slice {
-		Slice(base::flat_set<MsgId> &&messages, MsgRange range);
+		Slice(base::vector_flat_set<MsgId> &&messages, MsgRange range);
 
 		template <typename Range>
 		void merge(const Range &moreMessages, MsgRange moreNoSkipRange);
 
-		base::flat_set<MsgId> messages;
+		base::vector_flat_set<MsgId> messages;
 		MsgRange range;
 
 		inline bool operator<(const Slice &other) const {
@@ -155,9 +155,15 @@ void BasicAnimation::stop() {
 	_manager->stop(this);
 }
 
-AnimationManager::AnimationManager() : _timer(this) {
-	_timer.setSingleShot(false);
-	connect(&_timer, &QTimer::timeout, this, &AnimationManager::step);
+AnimationManager::AnimationManager() : _timer([=] { step(); }) {
+}
+
+void AnimationManager::schedule() {
+	// All frames are aligned to the same grid, so that animations started
+	// at different moments and frame timers of the same period coalesce.
+	const auto now = getms();
+	const auto next = (now / AnimationTimerDelta + 1) * AnimationTimerDelta;
+	_timer.callOnce(next - now, Qt::PreciseTimer);
 }
 
 void AnimationManager::start(BasicAnimation *obj) {
@@ -168,7 +174,7 @@ void AnimationManager::start(BasicAnimation *obj) {
 		}
 	} else {
 		if (_objects.empty()) {
-			_timer.start(AnimationTimerDelta);
+			schedule();
 		}
 		_objects.insert(obj);
 	}
@@ -185,7 +191,7 @@ void AnimationManager::stop(BasicAnimation *obj) {
 		if (i != _objects.cend()) {
 			_objects.erase(i);
 			if (_objects.empty()) {
-				_timer.stop();
+				_timer.cancel();
 			}
 		}
 	}
@@ -221,8 +227,8 @@ void AnimationManager::step() {
 		}
 		_stopping.clear();
 	}
-	if (_objects.empty()) {
-		_timer.stop();
+	if (!_objects.empty()) {
+		schedule();
 	}
 }
 
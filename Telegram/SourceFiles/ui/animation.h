@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtCore/QTimer>
 #include <QtGui/QColor>
 #include "base/binary_guard.h"
+#include "base/timer.h"
 #include "base/flat_set.h"
 
 namespace Media {
@@ -715,9 +716,10 @@ private:
 		Media::Clip::Reader *reader,
 		qint32 threadIndex,
 		qint32 notification);
+	void schedule();
 
 	base::flat_set<BasicAnimation*> _objects, _starting, _stopping;
-	QTimer _timer;
+	base::Timer _timer;
 	bool _iterating = false;
 
 };
@@ -33,7 +33,7 @@ public:
 
 	void draw(QPainter &p, EmojiPtr emoji, int size, int x, int y) const;
 
-	QImage generate(int size, int index) const;
+	QImage sprite(int index) const;
 
 private:
 	std::vector<QImage> _sprites;
@@ -48,6 +48,9 @@ std::unique_ptr<Instance> InstanceNormal;
 std::unique_ptr<Instance> InstanceLarge;
 UniversalImages Universal;
 
+// Cache files are written from the crl::async() workers.
+QMutex CacheFilesMutex;
+
 std::map<int, QPixmap> MainEmojiMap;
 std::map<int, std::map<int, QPixmap>> OtherEmojiMap;
 
@@ -76,7 +79,10 @@ QString CacheFilePath(int size, int index) {
 void SaveToFile(const QImage &image, int size, int index) {
 	Expects(image.bytesPerLine() == image.width() * 4);
 
-	QFile f(CacheFilePath(size, index));
+	// QSaveFile writes a new file and replaces the old one on commit(),
+	// so a crash in the middle doesn't leave a truncated cache behind.
+	QMutexLocker lock(&CacheFilesMutex);
+	QSaveFile f(CacheFilePath(size, index));
 	if (!f.open(QIODevice::WriteOnly)) {
 		if (!QDir::current().mkpath(CacheFileFolder())
 			|| !f.open(QIODevice::WriteOnly)) {
@@ -105,7 +111,7 @@ void SaveToFile(const QImage &image, int size, int index) {
 	if (!write(bytes::make_span(header))
 		|| !write(data)
 		|| !write(openssl::Sha256(bytes::make_span(header), data))
-		|| false) {
+		|| !f.commit()) {
 		LOG(("App Error: Could not write emoji cache '%1' for size %2"
 			).arg(f.fileName()
 			).arg(size));
@@ -119,6 +125,9 @@ QImage LoadFromFile(int size, int index) {
 	const auto fileSize = 4 * sizeof(uint32)
 		+ (width * height * 4)
 		+ openssl::kSha256Size;
+	// The cache keeps raw premultiplied pixels, so we read them right
+	// into the image without decoding. We don't map the file, because
+	// a mapped file can't be removed or replaced on Windows.
 	QFile f(CacheFilePath(size, index));
 	if (!f.exists()
 		|| f.size() != fileSize
@@ -144,28 +153,26 @@ QImage LoadFromFile(int size, int index) {
 		height,
 		QImage::Format_ARGB32_Premultiplied);
 	Assert(result.bytesPerLine() == width * 4);
-	const auto data = bytes::make_span(
+	const auto pixels = bytes::make_span(
 		reinterpret_cast<bytes::type*>(result.bits()),
 		width * height * 4);
 	auto signature = bytes::vector(openssl::kSha256Size);
-	if (!read(data)
-		|| !read(signature)
-		//|| (bytes::compare(
-		//	signature,
-		//	openssl::Sha256(bytes::make_span(header), data)) != 0)
-		|| false) {
+	if (!read(pixels) || !read(signature)) {
 		return QImage();
 	}
+	f.close();
+
 	crl::async([=, signature = std::move(signature)] {
 		// This should not happen (invalid signature),
 		// so we delay this check and fix only the next launch.
 		const auto data = bytes::make_span(
-			reinterpret_cast<const bytes::type*>(result.bits()),
+			reinterpret_cast<const bytes::type*>(result.constBits()),
 			width * height * 4);
-		const auto result = bytes::compare(
+		const auto compared = bytes::compare(
 			signature,
 			openssl::Sha256(bytes::make_span(header), data));
-		if (result != 0) {
+		if (compared != 0) {
+			QMutexLocker lock(&CacheFilesMutex);
 			QFile(CacheFilePath(size, index)).remove();
 		}
 	});
@@ -209,13 +216,19 @@ void UniversalImages::draw(
 		QRect(emoji->column() * large, emoji->row() * large, large, large));
 }
 
-QImage UniversalImages::generate(int size, int index) const {
-	Expects(size > 0);
+QImage UniversalImages::sprite(int index) const {
 	Expects(index < _sprites.size());
 
+	return _sprites[index];
+}
+
+// Works with its own copy of the universal sprite, because the main
+// thread may clear them while we are generating.
+QImage GenerateSprite(const QImage &original, int size, int index) {
+	Expects(size > 0);
+
 	const auto rows = RowsCount(index);
 	const auto large = kUniversalSize;
-	const auto &original = _sprites[index];
 	const auto data = original.bits();
 	const auto stride = original.bytesPerLine();
 	const auto format = original.format();
@@ -247,7 +260,6 @@ QImage UniversalImages::generate(int size, int index) const {
 			}
 		}
 	}
-	SaveToFile(result, size, index);
 	return result;
 }
 
@@ -631,26 +643,44 @@ void Instance::readCache() {
 
 void Instance::generateCache() {
 	const auto size = _size;
-	const auto index = _sprites.size();
 	auto [left, right] = base::make_binary_guard();
 	_generating = std::move(left);
-	crl::async([=, guard = std::move(right)]() mutable {
-		crl::on_main([
-			this,
-			image = Universal.generate(size, index),
-			guard = std::move(guard)
-		]() mutable {
-			if (!guard.alive()) {
+
+	// Generate all the missing sprites in parallel and push them in order.
+	const auto guard = std::make_shared<base::binary_guard>(
+		std::move(right));
+	for (auto index = int(_sprites.size()); index != SpritesCount; ++index) {
+		crl::async([=, original = Universal.sprite(index)] {
+			if (!guard->alive()) {
 				return;
 			}
-			pushSprite(std::move(image));
-			if (cached()) {
-				ClearUniversalChecked();
-			} else {
-				generateCache();
-			}
+			auto image = GenerateSprite(original, size, index);
+			SaveToFile(image, size, index);
+			crl::on_main([
+				this,
+				index,
+				image = std::move(image),
+				guard
+			]() mutable {
+				if (!guard->alive()) {
+					return;
+				}
+				pushGenerated(index, std::move(image));
+			});
 		});
-	});
+	}
+}
+
+void Instance::pushGenerated(int index, QImage &&data) {
+	_generated.emplace(index, std::move(data));
+	while (!_generated.empty()
+		&& _generated.begin()->first == int(_sprites.size())) {
+		pushSprite(std::move(_generated.begin()->second));
+		_generated.erase(_generated.begin());
+	}
+	if (cached()) {
+		ClearUniversalChecked();
+	}
 }
 
 void Instance::pushSprite(QImage &&data) {
@@ -146,10 +146,12 @@ public:
 private:
 	void readCache();
 	void generateCache();
+	void pushGenerated(int index, QImage &&data);
 	void pushSprite(QImage &&data);
 
 	int _size = 0;
 	std::vector<QPixmap> _sprites;
+	std::map<int, QImage> _generated;
 	base::binary_guard _generating;
 
 };
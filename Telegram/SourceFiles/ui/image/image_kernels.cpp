@@ -0,0 +1,662 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "ui/image/image_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef ARCH_CPU_X86_FAMILY
+#define TG_IMAGE_KERNELS_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef COMPILER_MSVC
+#include <intrin.h>
+#define TG_TARGET_SSE2
+#define TG_TARGET_AVX2
+#else // COMPILER_MSVC
+#define TG_TARGET_SSE2 __attribute__((target("sse2")))
+#define TG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif // COMPILER_MSVC
+#endif // ARCH_CPU_X86_FAMILY
+
+namespace Images {
+namespace Kernels {
+namespace {
+
+constexpr auto kBlurRadius = 3;
+constexpr auto kBlurR1 = kBlurRadius + 1;
+constexpr auto kBlurFirstWeight = (kBlurR1 * (kBlurR1 + 1)) >> 1;
+
+// The blur keeps four 16 bit components of a pixel in one uint64.
+// Each component sum is at most 16 * 0xFF, so they never overflow and
+// the SIMD versions can keep the same sums in 16 bit vector lanes.
+TG_FORCE_INLINE uint64 BlurGetColors(const uchar *p) {
+	return (uint64)p[0] + ((uint64)p[1] << 16) + ((uint64)p[2] << 32) + ((uint64)p[3] << 48);
+}
+
+void BlurRowsScalar(
+		const uchar *pix,
+		int w,
+		int stride,
+		uint64 *rgb,
+		int from,
+		int till) {
+	const auto we = w - kBlurR1;
+	for (auto y = from; y != till; ++y) {
+		const auto row = pix + y * stride;
+		const auto out = rgb + y * w;
+		const auto first = BlurGetColors(row);
+		auto rgballsum = uint64(0) - kBlurRadius * first;
+		auto rgbsum = first * kBlurFirstWeight;
+		for (auto i = 1; i <= kBlurRadius; ++i) {
+			const auto cur = BlurGetColors(row + i * 4);
+			rgbsum += cur * (kBlurR1 - i);
+			rgballsum += cur;
+		}
+
+		auto x = 0;
+		const auto update = [&](int start, int middle, int end) {
+			out[x] = (rgbsum >> 4) & 0x00FF00FF00FF00FFLL;
+			rgballsum += BlurGetColors(row + start * 4)
+				- 2 * BlurGetColors(row + middle * 4)
+				+ BlurGetColors(row + end * 4);
+			rgbsum += rgballsum;
+			++x;
+		};
+		while (x < kBlurR1) {
+			update(0, x, x + kBlurR1);
+		}
+		while (x < we) {
+			update(x - kBlurR1, x, x + kBlurR1);
+		}
+		while (x < w) {
+			update(x - kBlurR1, x, w - 1);
+		}
+	}
+}
+
+void BlurColumnsScalar(
+		uchar *pix,
+		int w,
+		int h,
+		int stride,
+		const uint64 *rgb,
+		int from,
+		int till) {
+	const auto he = h - kBlurR1;
+	for (auto x = from; x != till; ++x) {
+		auto rgballsum = uint64(0) - kBlurRadius * rgb[x];
+		auto rgbsum = rgb[x] * kBlurFirstWeight;
+		for (auto i = 1; i <= kBlurRadius; ++i) {
+			rgbsum += rgb[i * w + x] * (kBlurR1 - i);
+			rgballsum += rgb[i * w + x];
+		}
+
+		auto y = 0;
+		auto yi = x * 4;
+		const auto update = [&](int start, int middle, int end) {
+			const auto res = rgbsum >> 4;
+			pix[yi] = res & 0xFF;
+			pix[yi + 1] = (res >> 16) & 0xFF;
+			pix[yi + 2] = (res >> 32) & 0xFF;
+			pix[yi + 3] = (res >> 48) & 0xFF;
+			rgballsum += rgb[x + start * w]
+				- 2 * rgb[x + middle * w]
+				+ rgb[x + end * w];
+			rgbsum += rgballsum;
+			++y;
+			yi += stride;
+		};
+		while (y < kBlurR1) {
+			update(0, y, y + kBlurR1);
+		}
+		while (y < he) {
+			update(y - kBlurR1, y, y + kBlurR1);
+		}
+		while (y < h) {
+			update(y - kBlurR1, y, h - 1);
+		}
+	}
+}
+
+void ColorizeScalar(
+		uchar *pix,
+		int count,
+		int ca,
+		int cr,
+		int cg,
+		int cb) {
+	const auto size = count * 4;
+	for (auto i = 0; i < size; i += 4) {
+		int b = pix[i], g = pix[i + 1], r = pix[i + 2], a = pix[i + 3], aca = a * ca;
+		pix[i + 0] = uchar(b + ((aca * (cb - b)) >> 16));
+		pix[i + 1] = uchar(g + ((aca * (cg - g)) >> 16));
+		pix[i + 2] = uchar(r + ((aca * (cr - r)) >> 16));
+		pix[i + 3] = uchar(a + ((aca * (0xFF - a)) >> 16));
+	}
+}
+
+void MaskRowScalar(uint32 *ints, const uchar *mask, int from, int till, int maskBytesPerPixel) {
+	mask += from * maskBytesPerPixel;
+	for (auto x = from; x != till; ++x) {
+		auto opacity = static_cast<uint32>(*mask) + 1;
+		auto component = [&](int shift) {
+			return ((((ints[x] >> shift) & 0xFFU) * opacity) >> 8) << shift;
+		};
+		ints[x] = component(0) | component(8) | component(16) | component(24);
+		mask += maskBytesPerPixel;
+	}
+}
+
+#ifdef TG_IMAGE_KERNELS_X86
+
+// SSE2 versions blur two rows or two columns at once: one 128 bit value
+// holds the components of two pixels, the same as two uint64 sums do.
+
+TG_TARGET_SSE2 TG_FORCE_INLINE int32 ReadPixel(const uchar *p) {
+	auto result = int32();
+	std::memcpy(&result, p, sizeof(result));
+	return result;
+}
+
+TG_TARGET_SSE2 TG_FORCE_INLINE __m128i BlurLoadSSE2(
+		const uchar *first,
+		const uchar *second) {
+	const auto both = _mm_unpacklo_epi32(
+		_mm_cvtsi32_si128(ReadPixel(first)),
+		_mm_cvtsi32_si128(ReadPixel(second)));
+	return _mm_unpacklo_epi8(both, _mm_setzero_si128());
+}
+
+TG_TARGET_SSE2 TG_FORCE_INLINE __m128i BlurLoadColumnsSSE2(
+		const uint64 *rgb) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb));
+}
+
+TG_TARGET_SSE2 TG_FORCE_INLINE void BlurStepSSE2(
+		__m128i &rgbsum,
+		__m128i &rgballsum,
+		__m128i start,
+		__m128i middle,
+		__m128i end) {
+	rgballsum = _mm_sub_epi16(
+		_mm_add_epi16(rgballsum, _mm_add_epi16(start, end)),
+		_mm_slli_epi16(middle, 1));
+	rgbsum = _mm_add_epi16(rgbsum, rgballsum);
+}
+
+TG_TARGET_SSE2 int BlurRowsSSE2(
+		const uchar *pix,
+		int w,
+		int stride,
+		uint64 *rgb,
+		int from,
+		int till) {
+	auto y = from;
+	for (; y + 2 <= till; y += 2) {
+		const auto row0 = pix + y * stride;
+		const auto row1 = row0 + stride;
+		const auto out0 = rgb + y * w;
+		const auto out1 = out0 + w;
+		const auto first = BlurLoadSSE2(row0, row1);
+		auto rgballsum = _mm_sub_epi16(
+			_mm_setzero_si128(),
+			_mm_mullo_epi16(first, _mm_set1_epi16(kBlurRadius)));
+		auto rgbsum = _mm_mullo_epi16(
+			first,
+			_mm_set1_epi16(kBlurFirstWeight));
+		for (auto i = 1; i <= kBlurRadius; ++i) {
+			const auto cur = BlurLoadSSE2(row0 + i * 4, row1 + i * 4);
+			rgbsum = _mm_add_epi16(
+				rgbsum,
+				_mm_mullo_epi16(cur, _mm_set1_epi16(kBlurR1 - i)));
+			rgballsum = _mm_add_epi16(rgballsum, cur);
+		}
+		for (auto x = 0; x != w; ++x) {
+			const auto value = _mm_srli_epi16(rgbsum, 4);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out0 + x), value);
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(out1 + x),
+				_mm_unpackhi_epi64(value, value));
+			const auto start = std::max(x - kBlurR1, 0) * 4;
+			const auto middle = x * 4;
+			const auto end = std::min(x + kBlurR1, w - 1) * 4;
+			BlurStepSSE2(
+				rgbsum,
+				rgballsum,
+				BlurLoadSSE2(row0 + start, row1 + start),
+				BlurLoadSSE2(row0 + middle, row1 + middle),
+				BlurLoadSSE2(row0 + end, row1 + end));
+		}
+	}
+	return y;
+}
+
+TG_TARGET_SSE2 int BlurColumnsSSE2(
+		uchar *pix,
+		int w,
+		int h,
+		int stride,
+		const uint64 *rgb,
+		int from,
+		int till) {
+	auto x = from;
+	for (; x + 2 <= till; x += 2) {
+		const auto column = rgb + x;
+		const auto first = BlurLoadColumnsSSE2(column);
+		auto rgballsum = _mm_sub_epi16(
+			_mm_setzero_si128(),
+			_mm_mullo_epi16(first, _mm_set1_epi16(kBlurRadius)));
+		auto rgbsum = _mm_mullo_epi16(
+			first,
+			_mm_set1_epi16(kBlurFirstWeight));
+		for (auto i = 1; i <= kBlurRadius; ++i) {
+			const auto cur = BlurLoadColumnsSSE2(column + i * w);
+			rgbsum = _mm_add_epi16(
+				rgbsum,
+				_mm_mullo_epi16(cur, _mm_set1_epi16(kBlurR1 - i)));
+			rgballsum = _mm_add_epi16(rgballsum, cur);
+		}
+		auto yi = x * 4;
+		for (auto y = 0; y != h; ++y) {
+			const auto res = _mm_srli_epi16(rgbsum, 4);
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(pix + yi),
+				_mm_packus_epi16(res, res));
+			const auto start = std::max(y - kBlurR1, 0) * w;
+			const auto middle = y * w;
+			const auto end = std::min(y + kBlurR1, h - 1) * w;
+			BlurStepSSE2(
+				rgbsum,
+				rgballsum,
+				BlurLoadColumnsSSE2(column + start),
+				BlurLoadColumnsSSE2(column + middle),
+				BlurLoadColumnsSSE2(column + end));
+			yi += stride;
+		}
+	}
+	return x;
+}
+
+// Two pixels in 16 bit lanes, the same as ColorizeScalar() computes them.
+// (aca * delta) >> 16 is the high half of the 32 bit product, but aca is
+// unsigned and _mm_mulhi_epi16() is signed, so it is corrected by delta
+// when the highest bit of aca is set.
+TG_TARGET_SSE2 TG_FORCE_INLINE __m128i ColorizeTwoSSE2(
+		__m128i components,
+		__m128i target,
+		__m128i ca) {
+	const auto alpha = _mm_shufflehi_epi16(
+		_mm_shufflelo_epi16(components, _MM_SHUFFLE(3, 3, 3, 3)),
+		_MM_SHUFFLE(3, 3, 3, 3));
+	const auto aca = _mm_mullo_epi16(alpha, ca);
+	const auto delta = _mm_sub_epi16(target, components);
+	const auto shifted = _mm_add_epi16(
+		_mm_mulhi_epi16(aca, delta),
+		_mm_and_si128(_mm_srai_epi16(aca, 15), delta));
+	return _mm_add_epi16(components, shifted);
+}
+
+TG_TARGET_SSE2 int ColorizeSSE2(
+		uchar *pix,
+		int count,
+		int ca,
+		int cr,
+		int cg,
+		int cb) {
+	const auto zero = _mm_setzero_si128();
+	const auto target = _mm_setr_epi16(cb, cg, cr, 0xFF, cb, cg, cr, 0xFF);
+	const auto alpha = _mm_set1_epi16(ca);
+	auto i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const auto address = reinterpret_cast<__m128i*>(pix + i * 4);
+		const auto pixels = _mm_loadu_si128(address);
+		const auto low = ColorizeTwoSSE2(
+			_mm_unpacklo_epi8(pixels, zero),
+			target,
+			alpha);
+		const auto high = ColorizeTwoSSE2(
+			_mm_unpackhi_epi8(pixels, zero),
+			target,
+			alpha);
+		_mm_storeu_si128(address, _mm_packus_epi16(low, high));
+	}
+	return i;
+}
+
+// Only four byte mask pixels are vectorized, that is what
+// App::cornersMask() images are.
+TG_TARGET_SSE2 int MaskRowSSE2(uint32 *ints, const uchar *mask, int width) {
+	const auto zero = _mm_setzero_si128();
+	const auto maskByte = _mm_set1_epi32(0xFF);
+	const auto one = _mm_set1_epi32(1);
+	auto x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const auto opacity32 = _mm_add_epi32(
+			_mm_and_si128(
+				_mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(mask + x * 4)),
+				maskByte),
+			one);
+		const auto opacity16 = _mm_packs_epi32(opacity32, opacity32);
+		const auto pairs = _mm_unpacklo_epi16(opacity16, opacity16);
+		const auto opacityLow = _mm_unpacklo_epi32(pairs, pairs);
+		const auto opacityHigh = _mm_unpackhi_epi32(pairs, pairs);
+
+		const auto address = reinterpret_cast<__m128i*>(ints + x);
+		const auto pixels = _mm_loadu_si128(address);
+		const auto low = _mm_srli_epi16(_mm_mullo_epi16(
+			_mm_unpacklo_epi8(pixels, zero),
+			opacityLow), 8);
+		const auto high = _mm_srli_epi16(_mm_mullo_epi16(
+			_mm_unpackhi_epi8(pixels, zero),
+			opacityHigh), 8);
+		_mm_storeu_si128(address, _mm_packus_epi16(low, high));
+	}
+	return x;
+}
+
+// AVX2 versions do the same for four rows or columns at once.
+
+TG_TARGET_AVX2 TG_FORCE_INLINE __m256i BlurLoadAVX2(
+		const uchar *row,
+		int stride) {
+	return _mm256_cvtepu8_epi16(_mm_setr_epi32(
+		ReadPixel(row),
+		ReadPixel(row + stride),
+		ReadPixel(row + 2 * stride),
+		ReadPixel(row + 3 * stride)));
+}
+
+TG_TARGET_AVX2 TG_FORCE_INLINE __m256i BlurLoadColumnsAVX2(
+		const uint64 *rgb) {
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgb));
+}
+
+TG_TARGET_AVX2 TG_FORCE_INLINE void BlurStepAVX2(
+		__m256i &rgbsum,
+		__m256i &rgballsum,
+		__m256i start,
+		__m256i middle,
+		__m256i end) {
+	rgballsum = _mm256_sub_epi16(
+		_mm256_add_epi16(rgballsum, _mm256_add_epi16(start, end)),
+		_mm256_slli_epi16(middle, 1));
+	rgbsum = _mm256_add_epi16(rgbsum, rgballsum);
+}
+
+TG_TARGET_AVX2 int BlurRowsAVX2(
+		const uchar *pix,
+		int w,
+		int stride,
+		uint64 *rgb,
+		int from,
+		int till) {
+	auto y = from;
+	for (; y + 4 <= till; y += 4) {
+		const auto row = pix + y * stride;
+		const auto out = rgb + y * w;
+		const auto first = BlurLoadAVX2(row, stride);
+		auto rgballsum = _mm256_sub_epi16(
+			_mm256_setzero_si256(),
+			_mm256_mullo_epi16(first, _mm256_set1_epi16(kBlurRadius)));
+		auto rgbsum = _mm256_mullo_epi16(
+			first,
+			_mm256_set1_epi16(kBlurFirstWeight));
+		for (auto i = 1; i <= kBlurRadius; ++i) {
+			const auto cur = BlurLoadAVX2(row + i * 4, stride);
+			rgbsum = _mm256_add_epi16(
+				rgbsum,
+				_mm256_mullo_epi16(cur, _mm256_set1_epi16(kBlurR1 - i)));
+			rgballsum = _mm256_add_epi16(rgballsum, cur);
+		}
+		for (auto x = 0; x != w; ++x) {
+			const auto value = _mm256_srli_epi16(rgbsum, 4);
+			const auto low = _mm256_castsi256_si128(value);
+			const auto high = _mm256_extracti128_si256(value, 1);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x), low);
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(out + w + x),
+				_mm_unpackhi_epi64(low, low));
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(out + 2 * w + x),
+				high);
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(out + 3 * w + x),
+				_mm_unpackhi_epi64(high, high));
+			const auto start = std::max(x - kBlurR1, 0) * 4;
+			const auto middle = x * 4;
+			const auto end = std::min(x + kBlurR1, w - 1) * 4;
+			BlurStepAVX2(
+				rgbsum,
+				rgballsum,
+				BlurLoadAVX2(row + start, stride),
+				BlurLoadAVX2(row + middle, stride),
+				BlurLoadAVX2(row + end, stride));
+		}
+	}
+	return y;
+}
+
+TG_TARGET_AVX2 int BlurColumnsAVX2(
+		uchar *pix,
+		int w,
+		int h,
+		int stride,
+		const uint64 *rgb,
+		int from,
+		int till) {
+	auto x = from;
+	for (; x + 4 <= till; x += 4) {
+		const auto column = rgb + x;
+		const auto first = BlurLoadColumnsAVX2(column);
+		auto rgballsum = _mm256_sub_epi16(
+			_mm256_setzero_si256(),
+			_mm256_mullo_epi16(first, _mm256_set1_epi16(kBlurRadius)));
+		auto rgbsum = _mm256_mullo_epi16(
+			first,
+			_mm256_set1_epi16(kBlurFirstWeight));
+		for (auto i = 1; i <= kBlurRadius; ++i) {
+			const auto cur = BlurLoadColumnsAVX2(column + i * w);
+			rgbsum = _mm256_add_epi16(
+				rgbsum,
+				_mm256_mullo_epi16(cur, _mm256_set1_epi16(kBlurR1 - i)));
+			rgballsum = _mm256_add_epi16(rgballsum, cur);
+		}
+		auto yi = x * 4;
+		for (auto y = 0; y != h; ++y) {
+			const auto res = _mm256_srli_epi16(rgbsum, 4);
+
+			// Packing works inside 128 bit halves, so take the low
+			// 64 bits from each of them.
+			const auto packed = _mm256_permute4x64_epi64(
+				_mm256_packus_epi16(res, res),
+				_MM_SHUFFLE(3, 1, 2, 0));
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(pix + yi),
+				_mm256_castsi256_si128(packed));
+			const auto start = std::max(y - kBlurR1, 0) * w;
+			const auto middle = y * w;
+			const auto end = std::min(y + kBlurR1, h - 1) * w;
+			BlurStepAVX2(
+				rgbsum,
+				rgballsum,
+				BlurLoadColumnsAVX2(column + start),
+				BlurLoadColumnsAVX2(column + middle),
+				BlurLoadColumnsAVX2(column + end));
+			yi += stride;
+		}
+	}
+	return x;
+}
+
+TG_TARGET_AVX2 TG_FORCE_INLINE __m256i ColorizeTwoAVX2(
+		__m256i components,
+		__m256i target,
+		__m256i ca) {
+	const auto alpha = _mm256_shufflehi_epi16(
+		_mm256_shufflelo_epi16(components, _MM_SHUFFLE(3, 3, 3, 3)),
+		_MM_SHUFFLE(3, 3, 3, 3));
+	const auto aca = _mm256_mullo_epi16(alpha, ca);
+	const auto delta = _mm256_sub_epi16(target, components);
+	const auto shifted = _mm256_add_epi16(
+		_mm256_mulhi_epi16(aca, delta),
+		_mm256_and_si256(_mm256_srai_epi16(aca, 15), delta));
+	return _mm256_add_epi16(components, shifted);
+}
+
+TG_TARGET_AVX2 int ColorizeAVX2(
+		uchar *pix,
+		int count,
+		int ca,
+		int cr,
+		int cg,
+		int cb) {
+	const auto zero = _mm256_setzero_si256();
+	const auto target = _mm256_setr_epi16(
+		cb, cg, cr, 0xFF, cb, cg, cr, 0xFF,
+		cb, cg, cr, 0xFF, cb, cg, cr, 0xFF);
+	const auto alpha = _mm256_set1_epi16(ca);
+	auto i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const auto address = reinterpret_cast<__m256i*>(pix + i * 4);
+		const auto pixels = _mm256_loadu_si256(address);
+
+		// Unpacking and packing both work inside 128 bit halves,
+		// so the pixels come back to their places.
+		const auto low = ColorizeTwoAVX2(
+			_mm256_unpacklo_epi8(pixels, zero),
+			target,
+			alpha);
+		const auto high = ColorizeTwoAVX2(
+			_mm256_unpackhi_epi8(pixels, zero),
+			target,
+			alpha);
+		_mm256_storeu_si256(address, _mm256_packus_epi16(low, high));
+	}
+	return i;
+}
+
+#endif // TG_IMAGE_KERNELS_X86
+
+Instructions Detect() {
+#ifdef TG_IMAGE_KERNELS_X86
+#ifdef COMPILER_MSVC
+	int info[4] = { 0 };
+	__cpuid(info, 0);
+	const auto maxLeaf = info[0];
+	__cpuid(info, 1);
+	const auto sse2 = (info[3] & (1 << 26)) != 0;
+	const auto osxsave = (info[2] & (1 << 27)) != 0;
+	const auto avx = (info[2] & (1 << 28)) != 0;
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+		__cpuidex(info, 7, 0);
+		if (info[1] & (1 << 5)) {
+			return Instructions::AVX2;
+		}
+	}
+	if (sse2) {
+		return Instructions::SSE2;
+	}
+#else // COMPILER_MSVC
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return Instructions::AVX2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		return Instructions::SSE2;
+	}
+#endif // COMPILER_MSVC
+#endif // TG_IMAGE_KERNELS_X86
+	return Instructions::Scalar;
+}
+
+} // namespace
+
+Instructions BestSupported() {
+	static const auto result = Detect();
+	return result;
+}
+
+void Blur(
+		uchar *pixels,
+		int width,
+		int height,
+		int bytesPerLine,
+		Instructions instructions) {
+	Expects(width > 2 * kBlurRadius + 1);
+	Expects(height > 2 * kBlurRadius + 1);
+
+	auto rgb = std::vector<uint64>(width * height);
+	auto rows = 0;
+#ifdef TG_IMAGE_KERNELS_X86
+	if (instructions == Instructions::AVX2) {
+		rows = BlurRowsAVX2(pixels, width, bytesPerLine, rgb.data(), rows, height);
+	}
+	if (instructions != Instructions::Scalar) {
+		rows = BlurRowsSSE2(pixels, width, bytesPerLine, rgb.data(), rows, height);
+	}
+#endif // TG_IMAGE_KERNELS_X86
+	BlurRowsScalar(pixels, width, bytesPerLine, rgb.data(), rows, height);
+
+	auto columns = 0;
+#ifdef TG_IMAGE_KERNELS_X86
+	if (instructions == Instructions::AVX2) {
+		columns = BlurColumnsAVX2(pixels, width, height, bytesPerLine, rgb.data(), columns, width);
+	}
+	if (instructions != Instructions::Scalar) {
+		columns = BlurColumnsSSE2(pixels, width, height, bytesPerLine, rgb.data(), columns, width);
+	}
+#endif // TG_IMAGE_KERNELS_X86
+	BlurColumnsScalar(pixels, width, height, bytesPerLine, rgb.data(), columns, width);
+}
+
+void Colorize(
+		uchar *pixels,
+		int count,
+		int a,
+		int r,
+		int g,
+		int b,
+		Instructions instructions) {
+	auto done = 0;
+#ifdef TG_IMAGE_KERNELS_X86
+	if (instructions == Instructions::AVX2) {
+		done = ColorizeAVX2(pixels, count, a, r, g, b);
+	}
+	if (instructions != Instructions::Scalar) {
+		done += ColorizeSSE2(pixels + done * 4, count - done, a, r, g, b);
+	}
+#endif // TG_IMAGE_KERNELS_X86
+	ColorizeScalar(pixels + done * 4, count - done, a, r, g, b);
+}
+
+void MaskCorner(
+		uint32 *ints,
+		int intsPerLine,
+		const uchar *mask,
+		int maskWidth,
+		int maskHeight,
+		int maskBytesPerPixel,
+		int maskBytesPerLine,
+		Instructions instructions) {
+	for (auto y = 0; y != maskHeight; ++y) {
+		auto done = 0;
+#ifdef TG_IMAGE_KERNELS_X86
+		if (instructions != Instructions::Scalar && maskBytesPerPixel == 4) {
+			done = MaskRowSSE2(ints, mask, maskWidth);
+		}
+#endif // TG_IMAGE_KERNELS_X86
+		MaskRowScalar(ints, mask, done, maskWidth, maskBytesPerPixel);
+		ints += intsPerLine;
+		mask += maskBytesPerLine;
+	}
+}
+
+} // namespace Kernels
+} // namespace Images
@@ -0,0 +1,60 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/basic_types.h"
+
+namespace Images {
+namespace Kernels {
+
+// Pixel loops of Images::prepare*() for 32 bit premultiplied images.
+//
+// Each kernel has a scalar implementation and SSE2 / AVX2 ones that give
+// exactly the same pixels. The best instructions the processor supports
+// are chosen at runtime, the tests and benchmarks pass them explicitly.
+enum class Instructions {
+	Scalar,
+	SSE2,
+	AVX2,
+};
+
+Instructions BestSupported();
+
+// Box blur with radius 3, the image should be at least 8x8.
+void Blur(
+	uchar *pixels,
+	int width,
+	int height,
+	int bytesPerLine,
+	Instructions instructions = BestSupported());
+
+// Mixes (a, r, g, b) color components in [0, 255] to each pixel
+// with the pixel alpha multiplied by the color alpha.
+void Colorize(
+	uchar *pixels,
+	int count,
+	int a,
+	int r,
+	int g,
+	int b,
+	Instructions instructions = BestSupported());
+
+// Multiplies all the components of each pixel by the first byte
+// of the corresponding mask pixel (plus one) divided by 256.
+void MaskCorner(
+	uint32 *ints,
+	int intsPerLine,
+	const uchar *mask,
+	int maskWidth,
+	int maskHeight,
+	int maskBytesPerPixel,
+	int maskBytesPerLine,
+	Instructions instructions = BestSupported());
+
+} // namespace Kernels
+} // namespace Images
@@ -0,0 +1,216 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "ui/image/image_kernels.h"
+#include "base/tests_benchmark.h"
+#include <random>
+
+using namespace Images::Kernels;
+
+std::vector<Instructions> Supported() {
+	auto result = std::vector<Instructions>{ Instructions::Scalar };
+	if (BestSupported() != Instructions::Scalar) {
+		result.push_back(Instructions::SSE2);
+	}
+	if (BestSupported() == Instructions::AVX2) {
+		result.push_back(Instructions::AVX2);
+	}
+	return result;
+}
+
+// Premultiplied pixels, so that each component is not larger than alpha.
+std::vector<uchar> RandomPixels(std::mt19937 &generator, int count) {
+	auto bytes = std::uniform_int_distribution<int>(0, 255);
+	auto result = std::vector<uchar>(count * 4);
+	for (auto i = 0; i != count; ++i) {
+		const auto alpha = (i % 5) ? bytes(generator) : 255;
+		for (auto j = 0; j != 3; ++j) {
+			result[i * 4 + j] = uchar(bytes(generator) * alpha / 255);
+		}
+		result[i * 4 + 3] = uchar(alpha);
+	}
+	return result;
+}
+
+// Same sums as in the original prepareBlur(), one component at a time.
+std::vector<uchar> ReferenceBlur(
+		std::vector<uchar> pixels,
+		int width,
+		int height) {
+	const auto blurLine = [](int count, auto &&get, auto &&set) {
+		constexpr auto r1 = 4;
+		auto all = -3 * get(0);
+		auto sum = get(0) * 10;
+		for (auto i = 1; i != r1; ++i) {
+			sum += get(i) * (r1 - i);
+			all += get(i);
+		}
+		for (auto i = 0; i != count; ++i) {
+			set(i, (sum >> 4) & 0xFF);
+			all += get(std::max(i - r1, 0))
+				- 2 * get(i)
+				+ get(std::min(i + r1, count - 1));
+			sum += all;
+		}
+	};
+	auto rows = std::vector<int>(pixels.size());
+	for (auto y = 0; y != height; ++y) {
+		for (auto c = 0; c != 4; ++c) {
+			const auto index = [&](int x) { return (y * width + x) * 4 + c; };
+			blurLine(width, [&](int x) {
+				return int(pixels[index(x)]);
+			}, [&](int x, int value) {
+				rows[index(x)] = value;
+			});
+		}
+	}
+	for (auto x = 0; x != width; ++x) {
+		for (auto c = 0; c != 4; ++c) {
+			const auto index = [&](int y) { return (y * width + x) * 4 + c; };
+			blurLine(height, [&](int y) {
+				return rows[index(y)];
+			}, [&](int y, int value) {
+				pixels[index(y)] = uchar(value);
+			});
+		}
+	}
+	return pixels;
+}
+
+TEST_CASE("image kernels should blur the same way", "[image_kernels]") {
+	auto generator = std::mt19937(42);
+	for (const auto &[width, height] : std::vector<std::pair<int, int>>{
+		{ 8, 8 },
+		{ 9, 13 },
+		{ 17, 10 },
+		{ 64, 64 },
+		{ 101, 35 },
+	}) {
+		const auto pixels = RandomPixels(generator, width * height);
+		const auto expected = ReferenceBlur(pixels, width, height);
+		for (const auto instructions : Supported()) {
+			auto blurred = pixels;
+			Blur(blurred.data(), width, height, width * 4, instructions);
+			REQUIRE(blurred == expected);
+		}
+	}
+}
+
+TEST_CASE("image kernels should colorize the same way", "[image_kernels]") {
+	auto generator = std::mt19937(42);
+	auto bytes = std::uniform_int_distribution<int>(0, 255);
+	const auto pixels = RandomPixels(generator, 67);
+	for (auto i = 0; i != 100; ++i) {
+		const auto a = (i < 2) ? (i * 255) : bytes(generator);
+		const auto r = bytes(generator);
+		const auto g = bytes(generator);
+		const auto b = bytes(generator);
+
+		auto expected = pixels;
+		for (auto j = 0; j < int(expected.size()); j += 4) {
+			const auto alpha = expected[j + 3] * a;
+			const auto mix = [&](int index, int component) {
+				const auto was = int(expected[index]);
+				expected[index] = uchar(was + ((alpha * (component - was)) >> 16));
+			};
+			mix(j, b);
+			mix(j + 1, g);
+			mix(j + 2, r);
+			mix(j + 3, 0xFF);
+		}
+		for (const auto instructions : Supported()) {
+			auto colored = pixels;
+			Colorize(colored.data(), int(colored.size() / 4), a, r, g, b, instructions);
+			REQUIRE(colored == expected);
+		}
+	}
+}
+
+TEST_CASE("image kernels should mask corners the same way", "[image_kernels]") {
+	auto generator = std::mt19937(42);
+	constexpr auto kImageWidth = 40;
+	constexpr auto kImageHeight = 20;
+	const auto pixels = RandomPixels(generator, kImageWidth * kImageHeight);
+	for (const auto maskBytesPerPixel : { 1, 4 }) {
+		for (const auto maskWidth : { 1, 4, 7, 13 }) {
+			const auto maskHeight = maskWidth + 1;
+			const auto maskBytesPerLine = maskWidth * maskBytesPerPixel + 3;
+			const auto mask = RandomPixels(
+				generator,
+				maskBytesPerLine * maskHeight);
+			const auto offset = 3 * kImageWidth + 5;
+
+			auto expected = pixels;
+			for (auto y = 0; y != maskHeight; ++y) {
+				for (auto x = 0; x != maskWidth; ++x) {
+					const auto opacity = mask[y * maskBytesPerLine + x * maskBytesPerPixel] + 1;
+					const auto index = (offset + y * kImageWidth + x) * 4;
+					for (auto c = 0; c != 4; ++c) {
+						expected[index + c] = uchar((expected[index + c] * opacity) >> 8);
+					}
+				}
+			}
+			for (const auto instructions : Supported()) {
+				auto masked = pixels;
+				MaskCorner(
+					reinterpret_cast<uint32*>(masked.data()) + offset,
+					kImageWidth,
+					mask.data(),
+					maskWidth,
+					maskHeight,
+					maskBytesPerPixel,
+					maskBytesPerLine,
+					instructions);
+				REQUIRE(masked == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("image kernels benchmark", "[.][benchmark][image_kernels]") {
+	const auto name = [](Instructions instructions) {
+		switch (instructions) {
+		case Instructions::Scalar: return "scalar";
+		case Instructions::SSE2: return "sse2";
+		case Instructions::AVX2: return "avx2";
+		}
+		return "";
+	};
+	const auto measure = [&](const char *kernel, auto &&method) {
+		for (const auto instructions : Supported()) {
+			const auto label = std::string(kernel)
+				+ " ("
+				+ name(instructions)
+				+ ") x1000";
+			base::test::benchmark(label, [&] {
+				for (auto i = 0; i != 1000; ++i) {
+					method(instructions);
+				}
+			});
+		}
+	};
+
+	// Blurred thumbnails and colored icons are small images.
+	constexpr auto kSize = 160;
+	auto generator = std::mt19937(42);
+	auto pixels = RandomPixels(generator, kSize * kSize);
+	measure("blur 160x160", [&](Instructions instructions) {
+		Blur(pixels.data(), kSize, kSize, kSize * 4, instructions);
+	});
+	measure("colorize 160x160", [&](Instructions instructions) {
+		Colorize(pixels.data(), kSize * kSize, 128, 20, 40, 60, instructions);
+	});
+	const auto mask = RandomPixels(generator, 16 * 16);
+	measure("mask 4 corners 16x16", [&](Instructions instructions) {
+		const auto ints = reinterpret_cast<uint32*>(pixels.data());
+		for (const auto corner : { 0, kSize - 16, kSize * (kSize - 16) }) {
+			MaskCorner(ints + corner, kSize, mask.data(), 16, 16, 4, 64, instructions);
+		}
+	});
+}
@@ -15,14 +15,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item.h"
 #include "history/history.h"
 #include "data/data_session.h"
+#include "ui/image/image_kernels.h"
 
 namespace Images {
 namespace {
 
-TG_FORCE_INLINE uint64 blurGetColors(const uchar *p) {
-	return (uint64)p[0] + ((uint64)p[1] << 16) + ((uint64)p[2] << 32) + ((uint64)p[3] << 48);
-}
-
 const QPixmap &circleMask(int width, int height) {
 	Assert(Global::started());
 
@@ -70,7 +67,6 @@ QImage prepareBlur(QImage img) {
 	if (pix) {
 		int w = img.width(), h = img.height(), wold = w, hold = h;
 		const int radius = 3;
-		const int r1 = radius + 1;
 		const int div = radius * 2 + 1;
 		const int stride = w * 4;
 		if (radius < 16 && div < w && div < h && stride <= w * 4) {
@@ -94,83 +90,7 @@ QImage prepareBlur(QImage img) {
 				pix = img.bits();
 				if (!pix) return was;
 			}
-			uint64 *rgb = new uint64[w * h];
-
-			int x, y, i;
-
-			int yw = 0;
-			const int we = w - r1;
-			for (y = 0; y < h; y++) {
-				uint64 cur = blurGetColors(&pix[yw]);
-				uint64 rgballsum = -radius * cur;
-				uint64 rgbsum = cur * ((r1 * (r1 + 1)) >> 1);
-
-				for (i = 1; i <= radius; i++) {
-					uint64 cur = blurGetColors(&pix[yw + i * 4]);
-					rgbsum += cur * (r1 - i);
-					rgballsum += cur;
-				}
-
-				x = 0;
-
-#define update(start, middle, end) \
-rgb[y * w + x] = (rgbsum >> 4) & 0x00FF00FF00FF00FFLL; \
-rgballsum += blurGetColors(&pix[yw + (start) * 4]) - 2 * blurGetColors(&pix[yw + (middle) * 4]) + blurGetColors(&pix[yw + (end) * 4]); \
-rgbsum += rgballsum; \
-x++;
-
-				while (x < r1) {
-					update(0, x, x + r1);
-				}
-				while (x < we) {
-					update(x - r1, x, x + r1);
-				}
-				while (x < w) {
-					update(x - r1, x, w - 1);
-				}
-
-#undef update
-
-				yw += stride;
-			}
-
-			const int he = h - r1;
-			for (x = 0; x < w; x++) {
-				uint64 rgballsum = -radius * rgb[x];
-				uint64 rgbsum = rgb[x] * ((r1 * (r1 + 1)) >> 1);
-				for (i = 1; i <= radius; i++) {
-					rgbsum += rgb[i * w + x] * (r1 - i);
-					rgballsum += rgb[i * w + x];
-				}
-
-				y = 0;
-				int yi = x * 4;
-
-#define update(start, middle, end) \
-uint64 res = rgbsum >> 4; \
-pix[yi] = res & 0xFF; \
-pix[yi + 1] = (res >> 16) & 0xFF; \
-pix[yi + 2] = (res >> 32) & 0xFF; \
-pix[yi + 3] = (res >> 48) & 0xFF; \
-rgballsum += rgb[x + (start) * w] - 2 * rgb[x + (middle) * w] + rgb[x + (end) * w]; \
-rgbsum += rgballsum; \
-y++; \
-yi += stride;
-
-				while (y < r1) {
-					update(0, y, y + r1);
-				}
-				while (y < he) {
-					update(y - r1, y, y + r1);
-				}
-				while (y < h) {
-					update(y - r1, y, h - 1);
-				}
-
-#undef update
-			}
-
-			delete[] rgb;
+			Kernels::Blur(pix, w, h, stride);
 		}
 	}
 	return img;
@@ -227,16 +147,14 @@ void prepareRound(
 		Assert(mask.depth() == (maskBytesPerPixel << 3));
 		auto imageIntsAdded = imageIntsPerLine - maskWidth * imageIntsPerPixel;
 		Assert(imageIntsAdded >= 0);
-		for (auto y = 0; y != maskHeight; ++y) {
-			for (auto x = 0; x != maskWidth; ++x) {
-				auto opacity = static_cast<anim::ShiftedMultiplier>(*maskBytes) + 1;
-				*imageInts = anim::unshifted(anim::shifted(*imageInts) * opacity);
-				maskBytes += maskBytesPerPixel;
-				imageInts += imageIntsPerPixel;
-			}
-			maskBytes += maskBytesAdded;
-			imageInts += imageIntsAdded;
-		}
+		Kernels::MaskCorner(
+			imageInts,
+			imageIntsPerLine,
+			maskBytes,
+			maskWidth,
+			maskHeight,
+			maskBytesPerPixel,
+			maskBytesPerLine);
 	};
 	if (corners & RectPart::TopLeft) maskCorner(intsTopLeft, cornerMasks[0]);
 	if (corners & RectPart::TopRight) maskCorner(intsTopRight, cornerMasks[1]);
@@ -274,14 +192,8 @@ QImage prepareColored(style::color add, QImage image) {
 
 	if (auto pix = image.bits()) {
 		int ca = int(add->c.alphaF() * 0xFF), cr = int(add->c.redF() * 0xFF), cg = int(add->c.greenF() * 0xFF), cb = int(add->c.blueF() * 0xFF);
-		const int w = image.width(), h = image.height(), size = w * h * 4;
-		for (int32 i = 0; i < size; i += 4) {
-			int b = pix[i], g = pix[i + 1], r = pix[i + 2], a = pix[i + 3], aca = a * ca;
-			pix[i + 0] = uchar(b + ((aca * (cb - b)) >> 16));
-			pix[i + 1] = uchar(g + ((aca * (cg - g)) >> 16));
-			pix[i + 2] = uchar(r + ((aca * (cr - r)) >> 16));
-			pix[i + 3] = uchar(a + ((aca * (0xFF - a)) >> 16));
-		}
+		const int w = image.width(), h = image.height();
+		Kernels::Colorize(pix, w * h, ca, cr, cg, cb);
 	}
 	return image;
 }
@@ -968,7 +880,11 @@ int64 imageCacheSize() {
 }
 
 void RemoteImage::doCheckload() const {
-	if (!amLoading() || !_loader->finished()) return;
+	if (!amLoading()
+		|| !_loader->finished()
+		|| !_loader->imageReady(shrinkBox())) {
+		return;
+	}
 
 	QPixmap data = _loader->imagePixmap(shrinkBox());
 	if (data.isNull()) {
@@ -1124,6 +1040,12 @@ void RemoteImage::cancel() {
 	Auth().downloader().delayedDestroyLoader(std::unique_ptr<FileLoader>(loader));
 }
 
+void RemoteImage::pauseLoading() {
+	if (amLoading()) {
+		_loader->pause();
+	}
+}
+
 float64 RemoteImage::progress() const {
 	return amLoading() ? _loader->currentProgress() : (loaded() ? 1 : 0);
 }
@@ -307,6 +307,8 @@ public:
 	}
 	virtual void cancel() {
 	}
+	virtual void pauseLoading() {
+	}
 	virtual float64 progress() const {
 		return 1;
 	}
@@ -498,6 +500,7 @@ public:
 	}
 	bool displayLoading() const override;
 	void cancel() override;
+	void pauseLoading() override;
 	float64 progress() const override;
 	int32 loadOffset() const override;
 
@@ -7,9 +7,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "ui/text/text_entity.h"
 
+#include "ui/text/text_entity_scanner.h"
 #include "auth_session.h"
 #include "lang/lang_tag.h"
-#include "base/qthelp_url.h"
 #include "ui/emoji_config.h"
 
 namespace TextUtilities {
@@ -1576,6 +1576,11 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 	int32 len = result.text.size(), commandOffset = rich ? 0 : len;
 	bool inLink = false, commandIsLink = false;
 	const QChar *start = result.text.constData(), *end = start + result.text.size();
+	auto scanner = EntityScanner(
+		result.text,
+		withHashtags,
+		withMentions,
+		withBotCommands);
 	for (int32 offset = 0, matchOffset = offset, mentionSkip = 0; offset < len;) {
 		if (commandOffset <= offset) {
 			for (commandOffset = offset; commandOffset < len; ++commandOffset) {
@@ -1586,54 +1591,59 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 				}
 			}
 		}
-		auto mDomain = qthelp::RegExpDomain().match(result.text, matchOffset);
-		auto mExplicitDomain = qthelp::RegExpDomainExplicit().match(result.text, matchOffset);
-		auto mHashtag = withHashtags ? RegExpHashtag().match(result.text, matchOffset) : QRegularExpressionMatch();
-		auto mMention = withMentions ? RegExpMention().match(result.text, qMax(mentionSkip, matchOffset)) : QRegularExpressionMatch();
-		auto mBotCommand = withBotCommands ? RegExpBotCommand().match(result.text, matchOffset) : QRegularExpressionMatch();
+		auto mDomain = scanner.domain(matchOffset);
+		const auto mExplicitDomain = scanner.domainExplicit(matchOffset);
+		const auto mHashtag = withHashtags
+			? scanner.hashtag(matchOffset)
+			: EntityScanner::Match();
+		auto mMention = withMentions
+			? scanner.mention(qMax(mentionSkip, matchOffset))
+			: EntityScanner::Match();
+		const auto mBotCommand = withBotCommands
+			? scanner.botCommand(matchOffset)
+			: EntityScanner::Match();
 
 		EntityInTextType lnkType = EntityInTextUrl;
 		int32 lnkStart = 0, lnkLength = 0;
-		auto domainStart = mDomain.hasMatch() ? mDomain.capturedStart() : kNotFound,
-			domainEnd = mDomain.hasMatch() ? mDomain.capturedEnd() : kNotFound,
-			explicitDomainStart = mExplicitDomain.hasMatch() ? mExplicitDomain.capturedStart() : kNotFound,
-			explicitDomainEnd = mExplicitDomain.hasMatch() ? mExplicitDomain.capturedEnd() : kNotFound,
-			hashtagStart = mHashtag.hasMatch() ? mHashtag.capturedStart() : kNotFound,
-			hashtagEnd = mHashtag.hasMatch() ? mHashtag.capturedEnd() : kNotFound,
-			mentionStart = mMention.hasMatch() ? mMention.capturedStart() : kNotFound,
-			mentionEnd = mMention.hasMatch() ? mMention.capturedEnd() : kNotFound,
-			botCommandStart = mBotCommand.hasMatch() ? mBotCommand.capturedStart() : kNotFound,
-			botCommandEnd = mBotCommand.hasMatch() ? mBotCommand.capturedEnd() : kNotFound;
+		auto domainStart = mDomain ? mDomain.start : kNotFound,
+			domainEnd = mDomain ? mDomain.end : kNotFound,
+			explicitDomainStart = mExplicitDomain ? mExplicitDomain.start : kNotFound,
+			explicitDomainEnd = mExplicitDomain ? mExplicitDomain.end : kNotFound,
+			hashtagStart = mHashtag ? mHashtag.start : kNotFound,
+			hashtagEnd = mHashtag ? mHashtag.end : kNotFound,
+			mentionStart = mMention ? mMention.start : kNotFound,
+			mentionEnd = mMention ? mMention.end : kNotFound,
+			botCommandStart = mBotCommand ? mBotCommand.start : kNotFound,
+			botCommandEnd = mBotCommand ? mBotCommand.end : kNotFound;
 		auto hashtagIgnore = false;
 		auto mentionIgnore = false;
 
-		if (mHashtag.hasMatch()) {
-			if (!mHashtag.capturedRef(1).isEmpty()) {
+		if (mHashtag) {
+			if (mHashtag.hasPrefix) {
 				++hashtagStart;
 			}
-			if (!mHashtag.capturedRef(2).isEmpty()) {
+			if (mHashtag.hasSuffix) {
 				--hashtagEnd;
 			}
-			if (RegExpHashtagExclude().match(
-				result.text.mid(
-					hashtagStart + 1,
-					hashtagEnd - hashtagStart - 1)).hasMatch()) {
+			if (IsExcludedHashtag(
+					start + hashtagStart + 1,
+					start + hashtagEnd)) {
 				hashtagIgnore = true;
 			}
 		}
-		while (mMention.hasMatch()) {
-			if (!mMention.capturedRef(1).isEmpty()) {
+		while (mMention) {
+			if (mMention.hasPrefix) {
 				++mentionStart;
 			}
-			if (!mMention.capturedRef(2).isEmpty()) {
+			if (mMention.hasSuffix) {
 				--mentionEnd;
 			}
 			if (!(start + mentionStart + 1)->isLetter() || !(start + mentionEnd - 1)->isLetterOrNumber()) {
 				mentionSkip = mentionEnd;
-				mMention = RegExpMention().match(result.text, qMax(mentionSkip, matchOffset));
-				if (mMention.hasMatch()) {
-					mentionStart = mMention.capturedStart();
-					mentionEnd = mMention.capturedEnd();
+				mMention = scanner.mention(qMax(mentionSkip, matchOffset));
+				if (mMention) {
+					mentionStart = mMention.start;
+					mentionEnd = mMention.end;
 				} else {
 					mentionIgnore = true;
 				}
@@ -1641,19 +1651,19 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 				break;
 			}
 		}
-		if (mBotCommand.hasMatch()) {
-			if (!mBotCommand.capturedRef(1).isEmpty()) {
+		if (mBotCommand) {
+			if (mBotCommand.hasPrefix) {
 				++botCommandStart;
 			}
-			if (!mBotCommand.capturedRef(3).isEmpty()) {
+			if (mBotCommand.hasSuffix) {
 				--botCommandEnd;
 			}
 		}
-		if (!mDomain.hasMatch()
-			&& !mExplicitDomain.hasMatch()
-			&& !mHashtag.hasMatch()
-			&& !mMention.hasMatch()
-			&& !mBotCommand.hasMatch()) {
+		if (!mDomain
+			&& !mExplicitDomain
+			&& !mHashtag
+			&& !mMention
+			&& !mBotCommand) {
 			break;
 		}
 
@@ -1734,16 +1744,21 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 				continue;
 			}
 
-			auto protocol = mDomain.captured(1).toLower();
-			auto topDomain = mDomain.captured(3).toLower();
+			auto protocol = result.text.mid(
+				mDomain.protocolStart,
+				mDomain.protocolEnd - mDomain.protocolStart).toLower();
+			auto topDomain = result.text.mid(
+				mDomain.topDomainStart,
+				mDomain.topDomainEnd - mDomain.topDomainStart).toLower();
 			auto isProtocolValid = protocol.isEmpty() || IsValidProtocol(protocol);
 			auto isTopDomainValid = !protocol.isEmpty() || IsValidTopDomain(topDomain);
 
 			if (protocol.isEmpty() && domainStart > offset + 1 && *(start + domainStart - 1) == QChar('@')) {
-				auto forMailName = result.text.mid(offset, domainStart - offset - 1);
-				auto mMailName = RegExpMailNameAtEnd().match(forMailName);
-				if (mMailName.hasMatch()) {
-					auto mailStart = offset + mMailName.capturedStart();
+				const auto mailNameStart = FindMailNameAtEnd(
+					start + offset,
+					start + domainStart - 1);
+				if (mailNameStart >= 0) {
+					auto mailStart = offset + mailNameStart;
 					if (mailStart < offset) {
 						mailStart = offset;
 					}
@@ -1760,7 +1775,7 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 				lnkStart = domainStart;
 
 				QStack<const QChar*> parenth;
-				const QChar *domainEnd = start + mDomain.capturedEnd(), *p = domainEnd;
+				const QChar *domainEnd = start + mDomain.end, *p = domainEnd;
 				for (; p < end; ++p) {
 					QChar ch(*p);
 					if (chIsLinkEnd(ch)) break; // link finished
@@ -0,0 +1,431 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "ui/text/text_entity_scanner.h"
+
+namespace TextUtilities {
+namespace {
+
+constexpr auto kHashtagMaxLength = 64;
+constexpr auto kMentionMaxLength = 32;
+constexpr auto kBotCommandMaxLength = 64;
+constexpr auto kBotUsernameMinLength = 5;
+constexpr auto kBotUsernameMaxLength = 32;
+constexpr auto kDomainMaxLabels = 10;
+constexpr auto kTopDomainMinLength = 2;
+constexpr auto kTopDomainMaxLength = 22;
+constexpr auto kMailNameMaxLength = 256;
+
+// Regular expressions work with code points, so we read surrogate pairs
+// as a single char everywhere the expressions check unicode properties.
+int ReadCodePoint(const QChar *from, const QChar *end, uint *code) {
+	if (from->isHighSurrogate()
+		&& (from + 1 != end)
+		&& (from + 1)->isLowSurrogate()) {
+		*code = QChar::surrogateToUcs4(*from, *(from + 1));
+		return 2;
+	}
+	*code = from->unicode();
+	return 1;
+}
+
+uint ReadCodePointBefore(const QChar *start, const QChar *from) {
+	if ((from - start > 1)
+		&& (from - 1)->isLowSurrogate()
+		&& (from - 2)->isHighSurrogate()) {
+		return QChar::surrogateToUcs4(*(from - 2), *(from - 1));
+	}
+	return (from - 1)->unicode();
+}
+
+// \w with QRegularExpression::UseUnicodePropertiesOption.
+bool IsWordChar(uint code) {
+	return QChar::isLetterOrNumber(code) || (code == '_');
+}
+
+// \s with QRegularExpression::UseUnicodePropertiesOption.
+bool IsSpaceChar(uint code) {
+	switch (QChar::category(code)) {
+	case QChar::Separator_Space:
+	case QChar::Separator_Line:
+	case QChar::Separator_Paragraph: return true;
+	}
+	return (code >= 0x09 && code <= 0x0D)
+		|| (code == 0x0085) // Next line.
+		|| (code == 0x180E); // Mongolian vowel separator.
+}
+
+// \d with QRegularExpression::UseUnicodePropertiesOption.
+bool IsDigitChar(uint code) {
+	return QChar::isDigit(code);
+}
+
+bool IsAsciiLetter(ushort ch) {
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+bool IsAsciiDigit(ushort ch) {
+	return (ch >= '0' && ch <= '9');
+}
+
+// [A-Za-z_0-9]
+bool IsUsernameChar(ushort ch) {
+	return IsAsciiLetter(ch) || IsAsciiDigit(ch) || (ch == '_');
+}
+
+// ExpressionSeparators() with "`\\*/" or "`\\*" added.
+bool IsSeparatorChar(ushort ch, bool withSlash) {
+	switch (ch) {
+	case '.': case ',': case ':': case ';': case '<': case '>':
+	case '|': case '\'': case '"': case '[': case ']': case '{':
+	case '}': case '~': case '!': case '?': case '%': case '^':
+	case '(': case ')': case '-': case '+': case '=': case 0x10:
+	case 0x00AB: case 0x00BB: case 0x201C: case 0x201D: case 0x2018:
+	case 0x2019: case 0x2026: case '`': case '*': return true;
+	case '/': return withSlash;
+	}
+	return IsSpaceChar(ch);
+}
+
+// [A-Za-z0-9\-\_] and russian letters.
+bool IsDomainLabelChar(ushort ch) {
+	return IsAsciiLetter(ch)
+		|| IsAsciiDigit(ch)
+		|| (ch == '-')
+		|| (ch == '_')
+		|| (ch >= 0x0410 && ch <= 0x044F)
+		|| (ch == 0x0401)
+		|| (ch == 0x0451);
+}
+
+// [A-Za-z\-\d] and russian letters from "rf" top domain.
+bool IsTopDomainChar(uint code) {
+	return (code < 0x10000 && IsAsciiLetter(ushort(code)))
+		|| (code == 0x0440)
+		|| (code == 0x0444)
+		|| (code == '-')
+		|| IsDigitChar(code);
+}
+
+// [\w\$\-\_%=\.]
+bool IsDomainBadBefore(uint code) {
+	return IsWordChar(code)
+		|| (code == '$')
+		|| (code == '-')
+		|| (code == '%')
+		|| (code == '=')
+		|| (code == '.');
+}
+
+// [a-zA-Z\-_\.0-9]
+bool IsMailNameChar(ushort ch) {
+	return IsUsernameChar(ch) || (ch == '-') || (ch == '.');
+}
+
+} // namespace
+
+EntityScanner::EntityScanner(
+	const QString &text,
+	bool withHashtags,
+	bool withMentions,
+	bool withBotCommands)
+: _start(text.constData())
+, _length(text.size()) {
+	_found[int(Type::Hashtag)].enabled = withHashtags;
+	_found[int(Type::Mention)].enabled = withMentions;
+	_found[int(Type::BotCommand)].enabled = withBotCommands;
+	_found[int(Type::Domain)].enabled = true;
+	_found[int(Type::DomainExplicit)].enabled = true;
+}
+
+auto EntityScanner::hashtag(int offset) -> const Match & {
+	return find(Type::Hashtag, offset);
+}
+
+auto EntityScanner::mention(int offset) -> const Match & {
+	return find(Type::Mention, offset);
+}
+
+auto EntityScanner::botCommand(int offset) -> const Match & {
+	return find(Type::BotCommand, offset);
+}
+
+auto EntityScanner::domain(int offset) -> const Match & {
+	return find(Type::Domain, offset);
+}
+
+auto EntityScanner::domainExplicit(int offset) -> const Match & {
+	return find(Type::DomainExplicit, offset);
+}
+
+auto EntityScanner::find(Type type, int offset) -> const Match & {
+	auto &found = _found[int(type)];
+	if (found.enabled && !valid(found, offset)) {
+		scan(offset);
+	}
+	return found.match;
+}
+
+bool EntityScanner::valid(const Found &found, int offset) const {
+	// The first match found from searchedFrom is the first match from
+	// any offset between searchedFrom and its start, because no regular
+	// expression here depends on the chars between offset and start.
+	return (found.searchedFrom >= 0)
+		&& (found.searchedFrom <= offset)
+		&& (!found.match || found.match.start >= offset);
+}
+
+void EntityScanner::scan(int offset) {
+	auto pending = std::array<bool, kTypesCount>();
+	auto pendingCount = 0;
+	for (auto i = 0; i != kTypesCount; ++i) {
+		auto &found = _found[i];
+		if (found.enabled && !valid(found, offset)) {
+			found.match = Match();
+			found.searchedFrom = offset;
+			pending[i] = true;
+			++pendingCount;
+		}
+	}
+	for (auto position = offset; position < _length; ++position) {
+		for (auto i = 0; i != kTypesCount; ++i) {
+			if (pending[i] && matchAt(Type(i), position, _found[i].match)) {
+				pending[i] = false;
+				--pendingCount;
+			}
+		}
+		if (!pendingCount) {
+			break;
+		}
+	}
+}
+
+bool EntityScanner::matchAt(Type type, int position, Match &match) const {
+	switch (type) {
+	case Type::Hashtag: return matchTag('#', false, position, match);
+	case Type::Mention: return matchTag('@', false, position, match);
+	case Type::BotCommand: return matchTag('/', true, position, match);
+	case Type::Domain: return matchDomain(false, position, match);
+	case Type::DomainExplicit: return matchDomain(true, position, match);
+	}
+	Unexpected("Type in EntityScanner::matchAt.");
+}
+
+// Hashtag:     (^|[separators])#[\w]{2,64}([\W]|$)
+// Mention:     (^|[separators])@[A-Za-z_0-9]{1,32}([\W]|$)
+// Bot command: (^|[separators])/[A-Za-z_0-9]{1,64}(@[A-Za-z_0-9]{5,32})?([\W]|$)
+bool EntityScanner::matchTag(
+		QChar prefix,
+		bool botCommand,
+		int position,
+		Match &match) const {
+	const auto start = _start;
+	const auto end = _start + _length;
+	auto from = start + position;
+	auto hasPrefix = false;
+	if (!position && *from == prefix) {
+		++from;
+	} else if (IsSeparatorChar(from->unicode(), !botCommand)
+		&& (from + 1 != end)
+		&& *(from + 1) == prefix) {
+		from += 2;
+		hasPrefix = true;
+	} else {
+		return false;
+	}
+
+	auto till = from;
+	if (prefix == '#') {
+		auto length = 0;
+		auto code = uint();
+		while (till != end && length <= kHashtagMaxLength) {
+			const auto read = ReadCodePoint(till, end, &code);
+			if (!IsWordChar(code)) {
+				break;
+			}
+			till += read;
+			++length;
+		}
+		if (length < 2 || length > kHashtagMaxLength) {
+			return false;
+		}
+	} else {
+		const auto maxLength = botCommand
+			? kBotCommandMaxLength
+			: kMentionMaxLength;
+		while (till != end && IsUsernameChar(till->unicode())) {
+			++till;
+		}
+		const auto length = int(till - from);
+		if (!length || length > maxLength) {
+			return false;
+		}
+		if (botCommand && till != end && *till == '@') {
+			auto username = till + 1;
+			while (username != end && IsUsernameChar(username->unicode())) {
+				++username;
+			}
+			const auto usernameLength = int(username - till - 1);
+			auto code = uint();
+			if (usernameLength >= kBotUsernameMinLength
+				&& usernameLength <= kBotUsernameMaxLength
+				&& (username == end
+					|| !(ReadCodePoint(username, end, &code), IsWordChar(code)))) {
+				till = username;
+			}
+		}
+	}
+
+	auto suffix = 0;
+	if (till != end) {
+		auto code = uint();
+		suffix = ReadCodePoint(till, end, &code);
+		if (IsWordChar(code)) {
+			return false;
+		}
+	}
+	match = Match();
+	match.start = position;
+	match.end = int(till - start) + suffix;
+	match.hasPrefix = hasPrefix;
+	match.hasSuffix = (suffix > 0);
+	return true;
+}
+
+// (?<![\w\$\-\_%=\.])(?:([a-zA-Z]+)://)?((?:[labels]+\.){1,10}([top]{2,22})(\:\d+)?)
+// The explicit one requires the protocol and allows {0,10} labels.
+bool EntityScanner::matchDomain(
+		bool explicitOnly,
+		int position,
+		Match &match) const {
+	const auto start = _start;
+	const auto end = _start + _length;
+	const auto from = start + position;
+	if (position > 0 && IsDomainBadBefore(ReadCodePointBefore(start, from))) {
+		return false;
+	}
+	auto protocolEnd = from;
+	while (protocolEnd != end && IsAsciiLetter(protocolEnd->unicode())) {
+		++protocolEnd;
+	}
+	if (protocolEnd != from
+		&& (end - protocolEnd >= 3)
+		&& *protocolEnd == ':'
+		&& *(protocolEnd + 1) == '/'
+		&& *(protocolEnd + 2) == '/'
+		&& matchDomainRest(
+			int(protocolEnd + 3 - start),
+			explicitOnly ? 0 : 1,
+			match)) {
+		match.start = position;
+		match.protocolStart = position;
+		match.protocolEnd = int(protocolEnd - start);
+		return true;
+	} else if (!explicitOnly && matchDomainRest(position, 1, match)) {
+		match.start = position;
+		match.protocolStart = match.protocolEnd = position;
+		return true;
+	}
+	return false;
+}
+
+bool EntityScanner::matchDomainRest(
+		int from,
+		int minLabels,
+		Match &match) const {
+	const auto start = _start;
+	const auto end = _start + _length;
+
+	// Labels can't contain '.', so the (?:[labels]+\.){1,10} group
+	// matches them in a unique way and we only backtrack their count.
+	auto labelStarts = std::array<const QChar*, kDomainMaxLabels + 1>();
+	auto labels = 0;
+	labelStarts[0] = start + from;
+	while (labels < kDomainMaxLabels) {
+		auto label = labelStarts[labels];
+		auto till = label;
+		while (till != end && IsDomainLabelChar(till->unicode())) {
+			++till;
+		}
+		if (till == label || till == end || *till != '.') {
+			break;
+		}
+		labelStarts[++labels] = till + 1;
+	}
+	for (; labels >= minLabels; --labels) {
+		const auto topDomain = labelStarts[labels];
+		auto topDomainEnd = topDomain;
+		auto length = 0;
+		auto code = uint();
+		while (topDomainEnd != end && length < kTopDomainMaxLength) {
+			const auto read = ReadCodePoint(topDomainEnd, end, &code);
+			if (!IsTopDomainChar(code)) {
+				break;
+			}
+			topDomainEnd += read;
+			++length;
+		}
+		if (length < kTopDomainMinLength) {
+			continue;
+		}
+		auto till = topDomainEnd;
+		if (till != end && *till == ':' && till + 1 != end) {
+			auto port = till + 1;
+			auto read = ReadCodePoint(port, end, &code);
+			if (IsDigitChar(code)) {
+				do {
+					port += read;
+				} while (port != end
+					&& (read = ReadCodePoint(port, end, &code))
+					&& IsDigitChar(code));
+				till = port;
+			}
+		}
+		match = Match();
+		match.end = int(till - start);
+		match.topDomainStart = int(topDomain - start);
+		match.topDomainEnd = int(topDomainEnd - start);
+		return true;
+	}
+	return false;
+}
+
+int FindMailNameAtEnd(const QChar *start, const QChar *end) {
+	// '$' matches before the final '\n' as well.
+	const auto till = (end != start && *(end - 1) == '\n') ? (end - 1) : end;
+	auto from = till;
+	while (from != start
+		&& (till - from) < kMailNameMaxLength
+		&& IsMailNameChar((from - 1)->unicode())) {
+		--from;
+	}
+	return (from != till) ? int(from - start) : -1;
+}
+
+bool IsExcludedHashtag(const QChar *start, const QChar *end) {
+	// '$' matches before the final '\n' as well.
+	if (end != start && *(end - 1) == '\n') {
+		--end;
+	}
+	if (start != end && *start == '#') {
+		++start;
+	}
+	if (start == end) {
+		return false;
+	}
+	auto code = uint();
+	for (auto ch = start; ch != end;) {
+		const auto read = ReadCodePoint(ch, end, &code);
+		if (!IsDigitChar(code)) {
+			return false;
+		}
+		ch += read;
+	}
+	return true;
+}
+
+} // namespace TextUtilities
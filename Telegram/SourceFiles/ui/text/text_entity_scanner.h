@@ -0,0 +1,96 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace TextUtilities {
+
+// Finds the same matches as RegExpHashtag(), RegExpMention(),
+// RegExpBotCommand(), qthelp::RegExpDomain() and RegExpDomainExplicit()
+// do, but checks all of them in a single pass over the text.
+//
+// A found match is kept until the search offset passes its start, so
+// ParseEntities() doesn't rescan the text after each found entity.
+class EntityScanner final {
+public:
+	struct Match {
+		int start = -1;
+		int end = 0;
+
+		// (^|[separators]) group has captured a separator.
+		bool hasPrefix = false;
+
+		// ([\W]|$) group has captured a char.
+		bool hasSuffix = false;
+
+		// For domains: ([a-zA-Z]+):// and the top domain groups.
+		int protocolStart = 0;
+		int protocolEnd = 0;
+		int topDomainStart = 0;
+		int topDomainEnd = 0;
+
+		explicit operator bool() const {
+			return (start >= 0);
+		}
+	};
+
+	EntityScanner(
+		const QString &text,
+		bool withHashtags,
+		bool withMentions,
+		bool withBotCommands);
+
+	const Match &hashtag(int offset);
+	const Match &mention(int offset);
+	const Match &botCommand(int offset);
+	const Match &domain(int offset);
+	const Match &domainExplicit(int offset);
+
+private:
+	enum class Type {
+		Hashtag,
+		Mention,
+		BotCommand,
+		Domain,
+		DomainExplicit,
+
+		kCount,
+	};
+	static constexpr auto kTypesCount = int(Type::kCount);
+
+	struct Found {
+		Match match;
+		int searchedFrom = -1;
+		bool enabled = false;
+	};
+
+	const Match &find(Type type, int offset);
+	bool valid(const Found &found, int offset) const;
+	void scan(int offset);
+	bool matchAt(Type type, int position, Match &match) const;
+
+	bool matchTag(
+		QChar prefix,
+		bool botCommand,
+		int position,
+		Match &match) const;
+	bool matchDomain(bool explicitOnly, int position, Match &match) const;
+	bool matchDomainRest(int from, int minLabels, Match &match) const;
+
+	const QChar *_start = nullptr;
+	int _length = 0;
+	std::array<Found, kTypesCount> _found;
+
+};
+
+// Same as RegExpMailNameAtEnd().match(text).capturedStart() or -1.
+int FindMailNameAtEnd(const QChar *start, const QChar *end);
+
+// Same as RegExpHashtagExclude().match(text).hasMatch().
+bool IsExcludedHashtag(const QChar *start, const QChar *end);
+
+} // namespace TextUtilities
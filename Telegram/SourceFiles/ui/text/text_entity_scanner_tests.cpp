@@ -0,0 +1,261 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "ui/text/text_entity_scanner.h"
+#include "base/qthelp_url.h"
+#include "base/tests_benchmark.h"
+#include <random>
+
+using namespace TextUtilities;
+
+// Reference expressions, must be the same as in text_entity.cpp.
+QString Separators(const QString &additional) {
+	const auto quotes = QString::fromUtf8("\xC2\xAB\xC2\xBB\xE2\x80\x9C\xE2\x80\x9D\xE2\x80\x98\xE2\x80\x99\xE2\x80\xA6");
+	return QString("\\s\\.,:;<>|'\"\\[\\]\\{\\}\\~\\!\\?\\%\\^\\(\\)\\-\\+=\\x10") + quotes + additional;
+}
+
+QRegularExpression CreateRegExp(const QString &expression) {
+	return QRegularExpression(
+		expression,
+		QRegularExpression::UseUnicodePropertiesOption);
+}
+
+const auto Hashtag = CreateRegExp("(^|[" + Separators("`\\*/") + "])#[\\w]{2,64}([\\W]|$)");
+const auto HashtagExclude = CreateRegExp("^#?\\d+$");
+const auto Mention = CreateRegExp("(^|[" + Separators("`\\*/") + "])@[A-Za-z_0-9]{1,32}([\\W]|$)");
+const auto BotCommand = CreateRegExp("(^|[" + Separators("`\\*") + "])/[A-Za-z_0-9]{1,64}(@[A-Za-z_0-9]{5,32})?([\\W]|$)");
+const auto MailNameAtEnd = CreateRegExp("[a-zA-Z\\-_\\.0-9]{1,256}$");
+
+const auto Corpus = std::vector<const char*>{
+	"",
+	"#",
+	"#a",
+	"#ab",
+	"#123",
+	"text #hashtag, #another_one and #x",
+	"(#hashtag) [#tag] {#tag} \xC2\xAB#tag\xC2\xBB #tag\xE2\x80\xA6 #\xD1\x82\xD0\xB5\xD0\xB3 #tag\xF0\x9F\x98\x80 #tag\xF0\x9F\x98\x80x",
+	"@a @username, (@user) @user_ @_user @123 @user.name @\xD1\x8E\xD0\xB7\xD0\xB5\xD1\x80",
+	"/start /start@SomeBot /start@bot /help@VeryVeryVeryVeryVeryVeryVeryVeryLongBot",
+	"/cmd@botname\xF0\x9F\x98\x80 /cmd@botname\xD0\xB4 text/notcommand `/code` *bold*/cmd",
+	"telegram.org http://telegram.org https://t.me/username?start=1",
+	"tg://resolve?domain=user ftp://host.name:21/path localhost:8080",
+	"test://localhost http://localhost:123 sub.domain.example.co.uk:443",
+	"a.b.c.d.e.f.g.h.i.j.k.l.m.n.com very.long.top.domainwhichislongerthantwentytwochars",
+	"mail@example.com, name.surname-1@mail.ru and @mail.ru and x@y",
+	"\xD0\xBF\xD1\x80\xD0\xB8\xD0\xBC\xD0\xB5\xD1\x80.\xD1\x80\xD1\x84 \xD0\xBF\xD1\x80\xD0\xB8\xD0\xBC\xD0\xB5\xD1\x80.\xD1\x80\xD1\x83\xD1\x81 \xD0\xBF\xD1\x80\xD0\xB5\xD0\xB7\xD0\xB8\xD0\xB4\xD0\xB5\xD0\xBD\xD1\x82.\xD1\x80\xD1\x84 xn--80ak6aa92e.com",
+	"file.txt $a.com -a.com %a.com =a.com .a.com _a.com",
+	"digits.\xD9\xA1\xD9\xA2\xD9\xA3 port.com:\xD9\xA1\xD9\xA2 a.co:1x a.co:",
+	"line\nbreak@mail.com\n#tag\n@user\n/cmd\n",
+	"#\xF0\x9D\x90\x80\xF0\x9D\x90\x81 \xF0\x9D\x90\x80.com",
+};
+
+QString RandomText(std::mt19937 &generator) {
+	static const auto parts = std::vector<QString>{
+		"a", "b", "x", "1", "#", "@", "/", "_", ".", ":", "-", " ", "\n",
+		"`", "*", "$", "%", "=", "://", "http://", "tg://", "com", "..",
+		QString::fromUtf8("\xD0\xB4"), // Cyrillic de
+		QString::fromUtf8("\xD1\x80"), // Cyrillic er
+		QString::fromUtf8("\xD1\x84"), // Cyrillic ef
+		QString::fromUtf8("\xC2\xAB"), // Left guillemet
+		QString::fromUtf8("\xD9\xA1"), // Arabic-indic one
+		QString::fromUtf8("\xF0\x9F\x98\x80"), // Emoji
+		QString::fromUtf8("\xF0\x9D\x90\x80"), // Mathematical bold A
+		QString(20, 'a'),
+		QString("b1").repeated(15),
+		QString("x.").repeated(6),
+		QString("abcdefghij").repeated(7),
+	};
+	auto length = std::uniform_int_distribution<int>(0, 40)(generator);
+	auto part = std::uniform_int_distribution<int>(0, int(parts.size()) - 1);
+	auto result = QString();
+	while (length--) {
+		result.append(parts[part(generator)]);
+	}
+	return result;
+}
+
+void CheckTag(
+		const QRegularExpression &regex,
+		int suffixGroup,
+		const QString &text,
+		int offset,
+		const EntityScanner::Match &match) {
+	const auto reference = regex.match(text, offset);
+	INFO(text.toStdString() << " at " << offset);
+	REQUIRE(reference.hasMatch() == bool(match));
+	if (match) {
+		REQUIRE(reference.capturedStart() == match.start);
+		REQUIRE(reference.capturedEnd() == match.end);
+		REQUIRE(!reference.capturedRef(1).isEmpty() == match.hasPrefix);
+		REQUIRE(!reference.capturedRef(suffixGroup).isEmpty()
+			== match.hasSuffix);
+	}
+}
+
+void CheckDomain(
+		const QRegularExpression &regex,
+		const QString &text,
+		int offset,
+		const EntityScanner::Match &match) {
+	const auto reference = regex.match(text, offset);
+	INFO(text.toStdString() << " at " << offset);
+	REQUIRE(reference.hasMatch() == bool(match));
+	if (match) {
+		REQUIRE(reference.capturedStart() == match.start);
+		REQUIRE(reference.capturedEnd() == match.end);
+		REQUIRE(reference.captured(1) == text.mid(
+			match.protocolStart,
+			match.protocolEnd - match.protocolStart));
+		REQUIRE(reference.captured(3) == text.mid(
+			match.topDomainStart,
+			match.topDomainEnd - match.topDomainStart));
+	}
+}
+
+void CheckText(const QString &text) {
+	auto scanner = EntityScanner(text, true, true, true);
+	for (auto offset = 0; offset <= text.size(); ++offset) {
+		auto fresh = EntityScanner(text, true, true, true);
+		CheckTag(Hashtag, 2, text, offset, fresh.hashtag(offset));
+		CheckTag(Mention, 2, text, offset, fresh.mention(offset));
+		CheckTag(BotCommand, 3, text, offset, fresh.botCommand(offset));
+		CheckDomain(
+			qthelp::RegExpDomain(),
+			text,
+			offset,
+			fresh.domain(offset));
+		CheckDomain(
+			qthelp::RegExpDomainExplicit(),
+			text,
+			offset,
+			fresh.domainExplicit(offset));
+
+		// Cached matches must be the same as the fresh ones.
+		REQUIRE(scanner.hashtag(offset).start == fresh.hashtag(offset).start);
+		REQUIRE(scanner.mention(offset).start == fresh.mention(offset).start);
+		REQUIRE(scanner.botCommand(offset).start
+			== fresh.botCommand(offset).start);
+		REQUIRE(scanner.domain(offset).start == fresh.domain(offset).start);
+		REQUIRE(scanner.domainExplicit(offset).start
+			== fresh.domainExplicit(offset).start);
+	}
+
+	const auto start = text.constData();
+	const auto end = start + text.size();
+	const auto mail = MailNameAtEnd.match(text);
+	REQUIRE(FindMailNameAtEnd(start, end)
+		== (mail.hasMatch() ? mail.capturedStart() : -1));
+	REQUIRE(IsExcludedHashtag(start, end)
+		== HashtagExclude.match(text).hasMatch());
+}
+
+TEST_CASE("entity scanner finds the same as regular expressions", "[entity_scanner]") {
+	SECTION("corpus texts") {
+		for (const auto text : Corpus) {
+			CheckText(QString::fromUtf8(text));
+		}
+	}
+	SECTION("random texts") {
+		auto generator = std::mt19937(42);
+		for (auto i = 0; i != 3000; ++i) {
+			CheckText(RandomText(generator));
+		}
+	}
+}
+
+TEST_CASE("entity scanner treats control spaces as separators", "[entity_scanner]") {
+	const auto check = [](const char *text, auto method) {
+		const auto string = QString::fromUtf8(text);
+		auto scanner = EntityScanner(string, true, true, true);
+		const auto match = (scanner.*method)(0);
+		INFO(text);
+		REQUIRE(match.start == 1);
+		REQUIRE(match.hasPrefix);
+	};
+	SECTION("next line") {
+		check("x\xC2\x85#hashtag", &EntityScanner::hashtag);
+		check("x\xC2\x85@username", &EntityScanner::mention);
+		check("x\xC2\x85/command", &EntityScanner::botCommand);
+	}
+	SECTION("mongolian vowel separator") {
+		check("x\xE1\xA0\x8E#hashtag", &EntityScanner::hashtag);
+		check("x\xE1\xA0\x8E@username", &EntityScanner::mention);
+		check("x\xE1\xA0\x8E/command", &EntityScanner::botCommand);
+	}
+}
+
+TEST_CASE("entity scanner benchmark", "[.][benchmark][entity_scanner]") {
+	auto generator = std::mt19937(42);
+	auto texts = std::vector<QString>();
+	for (auto i = 0; i != 20000; ++i) {
+		auto text = QString::fromUtf8(Corpus[i % Corpus.size()]);
+		text.append(' ').append(RandomText(generator));
+		texts.push_back(text);
+	}
+	const auto measure = [&](const char *name, auto &&method) {
+		return base::test::benchmark(name, [&] {
+			auto found = 0;
+			for (const auto &text : texts) {
+				found += method(text);
+			}
+			return found;
+		});
+	};
+
+	// Imitate ParseEntities(): search all kinds from the last match end.
+	const auto regexes = measure("regular expressions", [](const QString &text) {
+		auto result = 0;
+		for (auto offset = 0; offset < text.size();) {
+			auto next = text.size();
+			for (const auto regex : {
+				&qthelp::RegExpDomain(),
+				&qthelp::RegExpDomainExplicit(),
+				&Hashtag,
+				&Mention,
+				&BotCommand,
+			}) {
+				const auto match = regex->match(text, offset);
+				if (match.hasMatch()) {
+					next = std::min(next, match.capturedEnd());
+				}
+			}
+			if (next == text.size()) {
+				break;
+			}
+			++result;
+			offset = next;
+		}
+		return result;
+	});
+	const auto scanned = measure("entity scanner", [](const QString &text) {
+		auto result = 0;
+		auto scanner = EntityScanner(text, true, true, true);
+		for (auto offset = 0; offset < text.size();) {
+			auto next = text.size();
+			for (const auto match : {
+				scanner.domain(offset),
+				scanner.domainExplicit(offset),
+				scanner.hashtag(offset),
+				scanner.mention(offset),
+				scanner.botCommand(offset),
+			}) {
+				if (match) {
+					next = std::min(next, match.end);
+				}
+			}
+			if (next == text.size()) {
+				break;
+			}
+			++result;
+			offset = next;
+		}
+		return result;
+	});
+	REQUIRE(regexes == scanned);
+}
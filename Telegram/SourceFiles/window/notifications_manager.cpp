@@ -30,6 +30,13 @@ namespace {
 // not more than one sound in 500ms from one peer - grouping
 constexpr auto kMinimalAlertDelay = TimeMs(500);
 
+// Global::NotificationsPerSecond() notifications in this period.
+constexpr auto kRenderingPeriod = TimeMs(1000);
+
+// When so many notifications from one history are due at once they are
+// shown as a single one with the count of the new messages.
+constexpr auto kCoalesceCount = 3;
+
 } // namespace
 
 System::System(AuthSession *session) : _authSession(session) {
@@ -115,7 +122,11 @@ void System::schedule(History *history, HistoryItem *item) {
 		auto &addTo = haveSetting ? _waiters : _settingWaiters;
 		auto it = addTo.constFind(history);
 		if (it == addTo.cend() || it->when > when) {
-			addTo.insert(history, Waiter(item->id, when, notifyBy));
+			if (haveSetting) {
+				setWaiter(history, Waiter(item->id, when, notifyBy));
+			} else {
+				addTo.insert(history, Waiter(item->id, when, notifyBy));
+			}
 		}
 	}
 	if (haveSetting) {
@@ -135,6 +146,7 @@ void System::clearAll() {
 	_whenAlerts.clear();
 	_waiters.clear();
 	_settingWaiters.clear();
+	_due = {};
 }
 
 void System::clearFromHistory(History *history) {
@@ -161,6 +173,12 @@ void System::clearAllFast() {
 	_whenAlerts.clear();
 	_waiters.clear();
 	_settingWaiters.clear();
+	_due = {};
+}
+
+void System::setWaiter(not_null<History*> history, const Waiter &waiter) {
+	_waiters.insert(history, waiter);
+	_due.push({ waiter.when, history });
 }
 
 void System::checkDelayed() {
@@ -198,7 +216,7 @@ void System::checkDelayed() {
 		}
 		if (loaded) {
 			if (!muted) {
-				_waiters.insert(i.key(), i.value());
+				setWaiter(i.key(), i.value());
 			}
 			i = _settingWaiters.erase(i);
 		} else {
@@ -260,109 +278,173 @@ void System::showNext() {
 		return;
 	}
 
-	while (true) {
-		auto next = 0LL;
-		HistoryItem *notifyItem = nullptr;
-		History *notifyHistory = nullptr;
-		for (auto i = _waiters.begin(); i != _waiters.end();) {
-			History *history = i.key();
-			if (history->currentNotification() && history->currentNotification()->id != i.value().msg) {
-				auto j = _whenMaps.find(history);
-				if (j == _whenMaps.end()) {
-					history->clearNotifications();
-					i = _waiters.erase(i);
-					continue;
-				}
-				do {
-					auto k = j.value().constFind(history->currentNotification()->id);
-					if (k != j.value().cend()) {
-						i.value().msg = k.key();
-						i.value().when = k.value();
-						break;
-					}
-					history->skipNotification();
-				} while (history->currentNotification());
-			}
-			if (!history->currentNotification()) {
-				_whenMaps.remove(history);
-				i = _waiters.erase(i);
-				continue;
-			}
-			auto when = i.value().when;
-			if (!notifyItem || next > when) {
-				next = when;
-				notifyItem = history->currentNotification();
-				notifyHistory = history;
+	auto next = 0LL;
+	while (!_due.empty()) {
+		const auto due = _due.top();
+		const auto history = due.history;
+		const auto i = _waiters.find(history);
+		if (i == _waiters.end() || i.value().when != due.when) {
+			_due.pop();
+			continue;
+		} else if (!refreshWaiter(history, i.value())) {
+			_whenMaps.remove(history);
+			_waiters.erase(i);
+			_due.pop();
+			continue;
+		} else if (i.value().when != due.when) {
+			_due.pop();
+			_due.push({ i.value().when, history });
+			continue;
+		} else if (due.when > ms) {
+			next = due.when;
+			break;
+		} else if (const auto delay = renderingDelay(ms)) {
+			next = ms + delay;
+			break;
+		}
+		_due.pop();
+		_shown.push_back(ms);
+		if (countDue(history, ms) >= kCoalesceCount) {
+			showCoalesced(history, ms);
+		} else {
+			showFromHistory(history);
+		}
+	}
+	if (nextAlert && (!next || nextAlert < next)) {
+		next = nextAlert;
+	}
+	if (next) {
+		_waitTimer.start(next - ms);
+	}
+}
+
+bool System::refreshWaiter(not_null<History*> history, Waiter &waiter) {
+	if (history->currentNotification()
+		&& history->currentNotification()->id != waiter.msg) {
+		const auto j = _whenMaps.find(history);
+		if (j == _whenMaps.end()) {
+			history->clearNotifications();
+			return false;
+		}
+		do {
+			const auto k = j.value().constFind(
+				history->currentNotification()->id);
+			if (k != j.value().cend()) {
+				waiter.msg = k.key();
+				waiter.when = k.value();
+				break;
 			}
-			++i;
+			history->skipNotification();
+		} while (history->currentNotification());
+	}
+	return (history->currentNotification() != nullptr);
+}
+
+int System::countDue(not_null<History*> history, TimeMs ms) const {
+	const auto j = _whenMaps.constFind(history);
+	if (j == _whenMaps.cend()) {
+		return 0;
+	}
+	auto result = 0;
+	for (const auto when : j.value()) {
+		if (when <= ms && ++result == kCoalesceCount) {
+			break;
 		}
-		if (notifyItem) {
-			if (next > ms) {
-				if (nextAlert && nextAlert < next) {
-					next = nextAlert;
-					nextAlert = 0;
-				}
-				_waitTimer.start(next - ms);
+	}
+	return result;
+}
+
+TimeMs System::renderingDelay(TimeMs ms) {
+	while (!_shown.empty() && _shown.front() + kRenderingPeriod <= ms) {
+		_shown.pop_front();
+	}
+	const auto limit = std::max(Global::NotificationsPerSecond(), 1);
+	return (int(_shown.size()) < limit)
+		? 0
+		: (_shown.front() + kRenderingPeriod - ms);
+}
+
+void System::showFromHistory(not_null<History*> history) {
+	const auto notifyItem = history->currentNotification();
+	Assert(notifyItem != nullptr);
+
+	auto forwardedItem = notifyItem->Has<HistoryMessageForwarded>() ? notifyItem : nullptr; // forwarded notify grouping
+	auto forwardedCount = 1;
+
+	auto j = _whenMaps.find(history);
+	if (j == _whenMaps.cend()) {
+		history->clearNotifications();
+	} else {
+		auto nextNotify = (HistoryItem*)nullptr;
+		do {
+			history->skipNotification();
+			if (!history->hasNotification()) {
 				break;
-			} else {
-				auto forwardedItem = notifyItem->Has<HistoryMessageForwarded>() ? notifyItem : nullptr; // forwarded notify grouping
-				auto forwardedCount = 1;
-
-				auto ms = getms(true);
-				auto history = notifyItem->history();
-				auto j = _whenMaps.find(history);
-				if (j == _whenMaps.cend()) {
-					history->clearNotifications();
+			}
+
+			j.value().remove((forwardedItem ? forwardedItem : notifyItem)->id);
+			do {
+				auto k = j.value().constFind(history->currentNotification()->id);
+				if (k != j.value().cend()) {
+					nextNotify = history->currentNotification();
+					setWaiter(history, Waiter(k.key(), k.value(), 0));
+					break;
+				}
+				history->skipNotification();
+			} while (history->hasNotification());
+			if (nextNotify) {
+				if (forwardedItem) {
+					auto nextForwarded = nextNotify->Has<HistoryMessageForwarded>() ? nextNotify : nullptr;
+					if (nextForwarded
+						&& forwardedItem->author() == nextForwarded->author()
+						&& qAbs(int64(nextForwarded->date()) - int64(forwardedItem->date())) < 2) {
+						forwardedItem = nextForwarded;
+						++forwardedCount;
+					} else {
+						nextNotify = nullptr;
+					}
 				} else {
-					auto nextNotify = (HistoryItem*)nullptr;
-					do {
-						history->skipNotification();
-						if (!history->hasNotification()) {
-							break;
-						}
-
-						j.value().remove((forwardedItem ? forwardedItem : notifyItem)->id);
-						do {
-							auto k = j.value().constFind(history->currentNotification()->id);
-							if (k != j.value().cend()) {
-								nextNotify = history->currentNotification();
-								_waiters.insert(notifyHistory, Waiter(k.key(), k.value(), 0));
-								break;
-							}
-							history->skipNotification();
-						} while (history->hasNotification());
-						if (nextNotify) {
-							if (forwardedItem) {
-								auto nextForwarded = nextNotify->Has<HistoryMessageForwarded>() ? nextNotify : nullptr;
-								if (nextForwarded
-									&& forwardedItem->author() == nextForwarded->author()
-									&& qAbs(int64(nextForwarded->date()) - int64(forwardedItem->date())) < 2) {
-									forwardedItem = nextForwarded;
-									++forwardedCount;
-								} else {
-									nextNotify = nullptr;
-								}
-							} else {
-								nextNotify = nullptr;
-							}
-						}
-					} while (nextNotify);
+					nextNotify = nullptr;
 				}
+			}
+		} while (nextNotify);
+	}
 
-				_manager->showNotification(notifyItem, forwardedCount);
+	_manager->showNotification(notifyItem, forwardedCount, 1);
 
-				if (!history->hasNotification()) {
-					_waiters.remove(history);
-					_whenMaps.remove(history);
-					continue;
-				}
+	if (!history->hasNotification()) {
+		_waiters.remove(history);
+		_whenMaps.remove(history);
+	}
+}
+
+void System::showCoalesced(not_null<History*> history, TimeMs ms) {
+	auto j = _whenMaps.find(history);
+	Assert(j != _whenMaps.end());
+
+	auto &whenMap = j.value();
+	auto lastItem = (HistoryItem*)nullptr;
+	auto count = 0;
+	while (const auto item = history->currentNotification()) {
+		const auto k = whenMap.find(item->id);
+		if (k != whenMap.end()) {
+			if (k.value() > ms) {
+				setWaiter(history, Waiter(k.key(), k.value(), 0));
+				break;
 			}
-		} else {
-			break;
+			whenMap.erase(k);
+			lastItem = item;
+			++count;
 		}
+		history->skipNotification();
+	}
+	if (lastItem) {
+		_manager->showNotification(lastItem, 1, count);
 	}
-	if (nextAlert) {
-		_waitTimer.start(nextAlert - ms);
+
+	if (!history->hasNotification()) {
+		_waiters.remove(history);
+		_whenMaps.remove(history);
 	}
 }
 
@@ -454,13 +536,20 @@ void Manager::notificationReplied(
 	Auth().api().sendMessage(std::move(message));
 }
 
-void NativeManager::doShowNotification(HistoryItem *item, int forwardedCount) {
+void NativeManager::doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int coalescedCount) {
 	const auto options = getNotificationOptions(item);
 
 	const auto title = options.hideNameAndPhoto ? qsl("Telegram Desktop") : item->history()->peer->name;
-	const auto subtitle = options.hideNameAndPhoto ? QString() : item->notificationHeader();
+	const auto subtitle = (options.hideNameAndPhoto || coalescedCount > 1)
+		? QString()
+		: item->notificationHeader();
 	const auto text = options.hideMessageText
 		? lang(lng_notification_preview)
+		: (coalescedCount > 1)
+		? lng_notification_messages(lt_count, coalescedCount)
 		: (forwardedCount < 2
 			? item->notificationText()
 			: lng_forward_messages(lt_count, forwardedCount));
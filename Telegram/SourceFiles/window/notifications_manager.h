@@ -7,6 +7,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include <deque>
+#include <queue>
+
 class AuthSession;
 
 namespace Platform {
@@ -75,7 +78,15 @@ public:
 	~System();
 
 private:
+	struct Waiter;
+
 	void showNext();
+	void showFromHistory(not_null<History*> history);
+	void showCoalesced(not_null<History*> history, TimeMs ms);
+	void setWaiter(not_null<History*> history, const Waiter &waiter);
+	bool refreshWaiter(not_null<History*> history, Waiter &waiter);
+	int countDue(not_null<History*> history, TimeMs ms) const;
+	TimeMs renderingDelay(TimeMs ms);
 	void ensureSoundCreated();
 
 	AuthSession *_authSession = nullptr;
@@ -97,6 +108,21 @@ private:
 	Waiters _settingWaiters;
 	SingleTimer _waitTimer;
 
+	// Due times of _waiters, the ones of the removed or changed
+	// waiters are skipped when they get to the top.
+	struct Due {
+		TimeMs when = 0;
+		not_null<History*> history;
+
+		inline bool operator>(const Due &other) const {
+			return when > other.when;
+		}
+	};
+	std::priority_queue<Due, std::vector<Due>, std::greater<Due>> _due;
+
+	// Times of the notifications shown in the last second.
+	std::deque<TimeMs> _shown;
+
 	QMap<History*, QMap<TimeMs, PeerData*>> _whenAlerts;
 
 	std::unique_ptr<Manager> _manager;
@@ -112,8 +138,13 @@ public:
 	Manager(System *system) : _system(system) {
 	}
 
-	void showNotification(HistoryItem *item, int forwardedCount) {
-		doShowNotification(item, forwardedCount);
+	// If coalescedCount > 1 the item is the last one of that many
+	// messages from its history shown as a single notification.
+	void showNotification(
+			HistoryItem *item,
+			int forwardedCount,
+			int coalescedCount) {
+		doShowNotification(item, forwardedCount, coalescedCount);
 	}
 	void updateAll() {
 		doUpdateAll();
@@ -152,7 +183,10 @@ protected:
 	}
 
 	virtual void doUpdateAll() = 0;
-	virtual void doShowNotification(HistoryItem *item, int forwardedCount) = 0;
+	virtual void doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int coalescedCount) = 0;
 	virtual void doClearAll() = 0;
 	virtual void doClearAllFast() = 0;
 	virtual void doClearFromItem(HistoryItem *item) = 0;
@@ -183,7 +217,10 @@ protected:
 	}
 	void doClearFromItem(HistoryItem *item) override {
 	}
-	void doShowNotification(HistoryItem *item, int forwardedCount) override;
+	void doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int coalescedCount) override;
 
 	virtual void doShowNativeNotification(PeerData *peer, MsgId msgId, const QString &title, const QString &subtitle, const QString &msg, bool hideNameAndPhoto, bool hideReplyButton) = 0;
 
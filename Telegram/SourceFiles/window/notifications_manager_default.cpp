@@ -67,12 +67,16 @@ Manager::Manager(System *system) : Notifications::Manager(system) {
 
 Manager::QueuedNotification::QueuedNotification(
 	not_null<HistoryItem*> item
-	, int forwardedCount)
+	, int forwardedCount
+	, int coalescedCount)
 : history(item->history())
 , peer(history->peer)
-, author((!peer->isUser() && !item->isPost()) ? item->author().get() : nullptr)
-, item((forwardedCount < 2) ? item.get() : nullptr)
-, forwardedCount(forwardedCount) {
+, author((!peer->isUser() && !item->isPost() && coalescedCount < 2)
+	? item->author().get()
+	: nullptr)
+, item((forwardedCount < 2 && coalescedCount < 2) ? item.get() : nullptr)
+, forwardedCount(forwardedCount)
+, coalescedCount(coalescedCount) {
 }
 
 QPixmap Manager::hiddenUserpicPlaceholder() const {
@@ -206,6 +210,7 @@ void Manager::showNextFromQueue() {
 			queued.author,
 			queued.item,
 			queued.forwardedCount,
+			queued.coalescedCount,
 			startPosition, startShift, shiftDirection);
 		_notifications.push_back(std::move(notification));
 		--count;
@@ -288,8 +293,12 @@ void Manager::removeWidget(internal::Widget *remove) {
 	showNextFromQueue();
 }
 
-void Manager::doShowNotification(HistoryItem *item, int forwardedCount) {
-	_queuedNotifications.push_back(QueuedNotification(item, forwardedCount));
+void Manager::doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int coalescedCount) {
+	_queuedNotifications.push_back(
+		QueuedNotification(item, forwardedCount, coalescedCount));
 	showNextFromQueue();
 }
 
@@ -494,12 +503,13 @@ void Background::paintEvent(QPaintEvent *e) {
 	p.fillRect(st::notifyBorderWidth, height() - st::notifyBorderWidth, width() - 2 * st::notifyBorderWidth, st::notifyBorderWidth, st::notifyBorder);
 }
 
-Notification::Notification(Manager *manager, History *history, PeerData *peer, PeerData *author, HistoryItem *msg, int forwardedCount, QPoint startPosition, int shift, Direction shiftDirection) : Widget(manager, startPosition, shift, shiftDirection)
+Notification::Notification(Manager *manager, History *history, PeerData *peer, PeerData *author, HistoryItem *msg, int forwardedCount, int coalescedCount, QPoint startPosition, int shift, Direction shiftDirection) : Widget(manager, startPosition, shift, shiftDirection)
 , _history(history)
 , _peer(peer)
 , _author(author)
 , _item(msg)
 , _forwardedCount(forwardedCount)
+, _coalescedCount(coalescedCount)
 #ifdef Q_OS_WIN
 , _started(GetTickCount())
 #endif // Q_OS_WIN
@@ -638,7 +648,11 @@ void Notification::actionsOpacityCallback() {
 }
 
 void Notification::updateNotifyDisplay() {
-	if (!_history || !_peer || (!_item && _forwardedCount < 2)) return;
+	if (!_history
+		|| !_peer
+		|| (!_item && _forwardedCount < 2 && _coalescedCount < 2)) {
+		return;
+	}
 
 	auto options = Manager::getNotificationOptions(_item);
 	_hideReplyButton = options.hideReplyButton;
@@ -696,6 +710,10 @@ void Notification::updateNotifyDisplay() {
 				}
 				p.setPen(st::dialogsTextFg);
 				p.drawText(r.left(), r.top() + st::dialogsTextFont->ascent, lng_forward_messages(lt_count, _forwardedCount));
+			} else if (_coalescedCount > 1) {
+				p.setFont(st::dialogsTextFont);
+				p.setPen(st::dialogsTextFg);
+				p.drawText(r.left(), r.top() + st::dialogsTextFont->ascent, lng_notification_messages(lt_count, _coalescedCount));
 			}
 		} else {
 			static QString notifyText = st::dialogsTextFont->elided(lang(lng_notification_preview), itemWidth);
@@ -49,6 +49,7 @@
       '<(src_loc)/base/assertion.h',
       '<(src_loc)/base/basic_types.h',
       '<(src_loc)/base/binary_guard.h',
+      '<(src_loc)/base/bounded_queue.h',
       '<(src_loc)/base/build_config.h',
       '<(src_loc)/base/bytes.h',
       '<(src_loc)/base/concurrent_timer.cpp',
@@ -57,6 +58,7 @@
       '<(src_loc)/base/enum_mask.h',
       '<(src_loc)/base/flat_map.h',
       '<(src_loc)/base/flat_set.h',
+      '<(src_loc)/base/flat_storage.h',
       '<(src_loc)/base/functors.h',
       '<(src_loc)/base/index_based_iterator.h',
       '<(src_loc)/base/match_method.h',
@@ -73,8 +75,10 @@
       '<(src_loc)/base/qthelp_url.h',
       '<(src_loc)/base/runtime_composer.cpp',
       '<(src_loc)/base/runtime_composer.h',
+      '<(src_loc)/base/seqlock.h',
       '<(src_loc)/base/timer.cpp',
       '<(src_loc)/base/timer.h',
+      '<(src_loc)/base/timer_wheel.h',
       '<(src_loc)/base/type_traits.h',
       '<(src_loc)/base/unique_any.h',
       '<(src_loc)/base/unique_function.h',
@@ -52,6 +52,15 @@
       '<(src_loc)/base/algorithm.h',
       '<(src_loc)/base/algorithm_tests.cpp',
     ],
+  }, {
+    'target_name': 'tests_bounded_queue',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'sources': [
+      '<(src_loc)/base/bounded_queue.h',
+      '<(src_loc)/base/bounded_queue_tests.cpp',
+    ],
   }, {
     'target_name': 'tests_flags',
     'includes': [
@@ -79,6 +88,24 @@
       '<(src_loc)/base/flat_set.h',
       '<(src_loc)/base/flat_set_tests.cpp',
     ],
+  }, {
+    'target_name': 'tests_seqlock',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'sources': [
+      '<(src_loc)/base/seqlock.h',
+      '<(src_loc)/base/seqlock_tests.cpp',
+    ],
+  }, {
+    'target_name': 'tests_timer_wheel',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'sources': [
+      '<(src_loc)/base/timer_wheel.h',
+      '<(src_loc)/base/timer_wheel_tests.cpp',
+    ],
   }, {
     'target_name': 'tests_rpl',
     'includes': [
@@ -117,6 +144,74 @@
       '<(src_loc)/rpl/variable.h',
       '<(src_loc)/rpl/variable_tests.cpp',
     ],
+  }, {
+    'target_name': 'tests_dialogs',
+    'includes': [
+      'common_test.gypi',
+      '../pch.gypi',
+    ],
+    'variables': {
+      'pch_source': '<(src_loc)/base/base_pch.cpp',
+      'pch_header': '<(src_loc)/base/base_pch.h',
+    },
+    'dependencies': [
+      '../lib_base.gyp:lib_base',
+    ],
+    'sources': [
+      '<(src_loc)/dialogs/dialogs_name_index.h',
+      '<(src_loc)/dialogs/dialogs_name_index_tests.cpp',
+    ],
+  }, {
+    'target_name': 'tests_text_entity',
+    'includes': [
+      'common_test.gypi',
+      '../pch.gypi',
+    ],
+    'variables': {
+      'pch_source': '<(src_loc)/base/base_pch.cpp',
+      'pch_header': '<(src_loc)/base/base_pch.h',
+    },
+    'dependencies': [
+      '../lib_base.gyp:lib_base',
+    ],
+    'sources': [
+      '<(src_loc)/ui/text/text_entity_scanner.cpp',
+      '<(src_loc)/ui/text/text_entity_scanner.h',
+      '<(src_loc)/ui/text/text_entity_scanner_tests.cpp',
+    ],
+  }, {
+    'target_name': 'tests_image_kernels',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'dependencies': [
+      '../lib_base.gyp:lib_base',
+    ],
+    'sources': [
+      '<(src_loc)/ui/image/image_kernels.cpp',
+      '<(src_loc)/ui/image/image_kernels.h',
+      '<(src_loc)/ui/image/image_kernels_tests.cpp',
+    ],
+  }, {
+    'target_name': 'tests_media_audio',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'dependencies': [
+      '../lib_base.gyp:lib_base',
+    ],
+    'sources': [
+      '<(src_loc)/media/media_audio_peaks.h',
+      '<(src_loc)/media/media_audio_peaks_tests.cpp',
+    ],
+  }, {
+    'target_name': 'tests_app',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'sources': [
+      '<(src_loc)/app_tests.cpp',
+    ],
   }, {
     'target_name': 'tests_storage',
     'includes': [